@@ -495,6 +495,12 @@ class SCENE_PT_game_physics(SceneButtonsPanel, Panel):
             layout.prop(gs, "physics_solver")
             layout.prop(gs, "physics_gravity", text="Gravity")
 
+            row = layout.row()
+            row.prop(gs, "use_physics_multithread", text="Multithreaded")
+            sub = row.row()
+            sub.active = gs.use_physics_multithread
+            sub.prop(gs, "physics_threads", text="Threads")
+
             split = layout.split()
 
             col = split.column()
@@ -640,6 +646,51 @@ class SCENE_PT_game_hysteresis(SceneButtonsPanel, Panel):
         row.active = gs.use_scene_hysteresis
         row.prop(gs, "scene_hysteresis_percentage", text="")
 
+class SCENE_PT_game_activity_culling(SceneButtonsPanel, Panel):
+    bl_label = "Activity Culling"
+    bl_options = {'DEFAULT_CLOSED'}
+    COMPAT_ENGINES = {'BLENDER_EEVEE', 'BLENDER_WORKBENCH'}
+
+    @classmethod
+    def poll(cls, context):
+        scene = context.scene
+        return (scene and scene.render.engine in cls.COMPAT_ENGINES)
+
+    def draw_header(self, context):
+        gs = context.scene.game_settings
+
+        self.layout.prop(gs, "use_activity_culling", text="")
+
+    def draw(self, context):
+        layout = self.layout
+        gs = context.scene.game_settings
+
+        row = layout.row()
+        row.active = gs.use_activity_culling
+        row.prop(gs, "activity_culling_box_radius")
+
+class SCENE_PT_game_animation(SceneButtonsPanel, Panel):
+    bl_label = "Animation"
+    bl_options = {'DEFAULT_CLOSED'}
+    COMPAT_ENGINES = {'BLENDER_EEVEE', 'BLENDER_WORKBENCH'}
+
+    @classmethod
+    def poll(cls, context):
+        scene = context.scene
+        return (scene and scene.render.engine in cls.COMPAT_ENGINES)
+
+    def draw(self, context):
+        layout = self.layout
+        gs = context.scene.game_settings
+
+        layout.prop(gs, "use_baked_actions")
+        layout.prop(gs, "use_animation_lod")
+
+        col = layout.column()
+        col.active = gs.use_animation_lod
+        col.prop(gs, "animation_lod_distance")
+        col.prop(gs, "animation_lod_max_interval")
+
 class SCENE_PT_game_console(SceneButtonsPanel, Panel):
     bl_label = "Game Python Console"
     bl_options = {'DEFAULT_CLOSED'}
@@ -748,6 +799,8 @@ classes = (
     SCENE_PT_game_physics_obstacles,
     SCENE_PT_game_navmesh,
     SCENE_PT_game_hysteresis,
+    SCENE_PT_game_activity_culling,
+    SCENE_PT_game_animation,
     SCENE_PT_game_console,
     OBJECT_MT_lod_tools,
     OBJECT_PT_levels_of_detail,
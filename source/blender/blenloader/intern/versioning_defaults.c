@@ -439,6 +439,9 @@ void BLO_update_defaults_startup_blend(Main *bmain, const char *app_template)
 
     sce->gm.lodflag = SCE_LOD_USE_HYST;
     sce->gm.scehysteresis = 10;
+
+    sce->gm.animLodDistance = 20.0f;
+    sce->gm.animLodMaxInterval = 4;
   }
   for (Object *ob = bmain->objects.first; ob; ob = ob->id.next) {
     /* Game engine defaults*/
@@ -368,4 +368,18 @@ void blo_do_versions_upbge(FileData *fd, Library *lib, Main *bmain)
       }
     }
   }
+  if (!MAIN_VERSION_UPBGE_ATLEAST(bmain, 30, 9)) {
+    LISTBASE_FOREACH (Scene *, sce, &bmain->scenes) {
+      /* The activity box radius was unused and can be zero. */
+      if (sce->gm.activityBoxRadius < 0.5f) {
+        sce->gm.activityBoxRadius = 100.0f;
+      }
+    }
+  }
+  if (!MAIN_VERSION_UPBGE_ATLEAST(bmain, 30, 10)) {
+    LISTBASE_FOREACH (Scene *, sce, &bmain->scenes) {
+      sce->gm.animLodDistance = 20.0f;
+      sce->gm.animLodMaxInterval = 4;
+    }
+  }
 }
@@ -2430,6 +2430,8 @@ static void draw_actuator_steering(uiLayout *layout, PointerRNA *ptr)
   if (RNA_enum_get(ptr, "mode") == ACT_STEERING_PATHFOLLOWING) {
     col = uiLayoutColumn(row, false);
     uiItemR(col, ptr, "update_period", 0, NULL, ICON_NONE);
+    col = uiLayoutColumn(row, false);
+    uiItemR(col, ptr, "use_crowd", 0, NULL, ICON_NONE);
   }
   row = uiLayoutRow(layout, false);
   uiItemR(row, ptr, "lock_z_velocity", 1, NULL, ICON_NONE);
@@ -203,6 +203,7 @@
     .freqplay = 60, \
     .depth = 32, \
     .gravity = 9.8f, \
+    .activityBoxRadius = 100.0f, \
     .physicsEngine = WOPHY_BULLET, \
     .occlusionRes = 128, \
     .ticrate = 60, \
@@ -222,6 +223,8 @@
     .flag = GAME_USE_UNDO, \
     .lodflag = SCE_LOD_USE_HYST, \
     .scehysteresis = 10, \
+    .animLodDistance = 20.0f, \
+    .animLodMaxInterval = 4, \
     .pythonkeys = {212, 217, 213, 116}, \
     .recastData = _DNA_DEFAULT_RecastData, \
   }
@@ -880,7 +880,9 @@ typedef struct GameData {
   short matmode DNA_DEPRECATED;
   short occlusionRes; /* resolution of occlusion Z buffer in pixel */
   short physicsEngine;
-  short solverType, _pad[3];
+  short solverType;
+  /* Number of threads used by multithreaded physics, 0 for all available threads. */
+  short physicsThreads, _pad[2];
   short exitkey;
   short pythonkeys[4];
   short vsync; /* Controls vsync: off, on, or adaptive (if supported) */
@@ -890,10 +892,14 @@ typedef struct GameData {
   float timeScale;
   float levelHeight;
   float deactivationtime, lineardeactthreshold, angulardeactthreshold;
-  float erp, erp2, cfm, _pad1;
+  float erp, erp2, cfm;
+  /* Camera distance between two animation levels of detail. */
+  float animLodDistance;
 
   /* Scene LoD */
-  short lodflag, _pad3;
+  short lodflag;
+  /* Maximum number of frames between two pose updates of the far armatures. */
+  short animLodMaxInterval;
   int scehysteresis;
 } GameData;
 
@@ -955,6 +961,10 @@ enum {
 // #define GAME_USE_UI_ANTI_FLICKER (1 << 20) /* deprecated */
 #define GAME_USE_VIEWPORT_RENDER (1 << 21)
 #define GAME_PYTHON_CONSOLE (1 << 22)
+#define GAME_USE_PHYSICS_MULTITHREAD (1 << 23)
+#define GAME_USE_ACTIVITY_CULLING (1 << 24)
+#define GAME_USE_BAKED_ACTIONS (1 << 25)
+#define GAME_USE_ANIMATION_LOD (1 << 26)
 /* Note: GameData.flag is now an int (max 32 flags). A short could only take 16 flags */
 
 /* GameData.playerflag */
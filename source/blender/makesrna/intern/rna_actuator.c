@@ -2314,6 +2314,15 @@ static void rna_def_steering_actuator(BlenderRNA *brna)
   RNA_def_property_ui_text(
       prop, "Lock Z velocity", "Disable simulation of linear motion along Z axis");
   RNA_def_property_update(prop, NC_LOGIC, NULL);
+
+  prop = RNA_def_property(srna, "use_crowd", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "flag", ACT_STEERING_CROWD);
+  RNA_def_property_ui_text(prop,
+                           "Crowd",
+                           "Share the path searches with the other crowd agents of the "
+                           "navigation mesh, searches are spread over frames and paths are "
+                           "reused while the target stays close");
+  RNA_def_property_update(prop, NC_LOGIC, NULL);
 }
 
 static void rna_def_mouse_actuator(BlenderRNA *brna)
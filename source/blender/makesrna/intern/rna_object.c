@@ -3091,11 +3091,12 @@ static void rna_def_object_game_settings(BlenderRNA *brna)
   RNA_def_property_ui_text(
       prop, "Lock Z Rotation Axis", "Disable simulation of angular motion along the Z axis");
 
-  /* is this used anywhere ? */
   prop = RNA_def_property(srna, "use_activity_culling", PROP_BOOLEAN, PROP_NONE);
   RNA_def_property_boolean_negative_sdna(prop, NULL, "gameflag2", OB_NEVER_DO_ACTIVITY_CULLING);
-  RNA_def_property_ui_text(
-      prop, "Lock Z Rotation Axis", "Disable simulation of angular motion along the Z axis");
+  RNA_def_property_ui_text(prop,
+                           "Activity Culling",
+                           "Suspend the object and its children when outside the activity box "
+                           "of the cameras");
 
   prop = RNA_def_property(srna, "use_physics_fh", PROP_BOOLEAN, PROP_NONE);
   RNA_def_property_boolean_sdna(prop, NULL, "gameflag", OB_DO_FH);
@@ -5590,6 +5590,23 @@ static void rna_def_scene_game_data(BlenderRNA *brna)
   RNA_def_property_ui_text(prop, "Physics Solver", "Physics constraint solver");
   RNA_def_property_update(prop, NC_SCENE, NULL);
 
+  prop = RNA_def_property(srna, "use_physics_multithread", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "flag", GAME_USE_PHYSICS_MULTITHREAD);
+  RNA_def_property_ui_text(prop,
+                           "Multithreaded Physics",
+                           "Simulate physics islands, collision pairs and constraints on multiple "
+                           "threads (soft bodies are not supported and converted as rigid bodies)");
+  RNA_def_property_update(prop, NC_SCENE, NULL);
+
+  prop = RNA_def_property(srna, "physics_threads", PROP_INT, PROP_NONE);
+  RNA_def_property_int_sdna(prop, NULL, "physicsThreads");
+  RNA_def_property_range(prop, 0, 64);
+  RNA_def_property_ui_text(
+      prop,
+      "Physics Threads",
+      "Number of threads used by multithreaded physics, 0 to use all available threads");
+  RNA_def_property_update(prop, NC_SCENE, NULL);
+
   prop = RNA_def_property(srna, "occlusion_culling_resolution", PROP_INT, PROP_PIXEL);
   RNA_def_property_int_sdna(prop, NULL, "occlusionRes");
   RNA_def_property_range(prop, 128.0, 1024.0);
@@ -5727,14 +5744,22 @@ static void rna_def_scene_game_data(BlenderRNA *brna)
       "increases");
   RNA_def_property_update(prop, NC_SCENE, NULL);
 
-  /* not used  */ /* deprecated !!!!!!!!!!!!! */
+  prop = RNA_def_property(srna, "use_activity_culling", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "flag", GAME_USE_ACTIVITY_CULLING);
+  RNA_def_property_ui_text(prop,
+                           "Activity Culling",
+                           "Suspend the logic bricks, components and physics of the objects "
+                           "outside the activity box of the cameras");
+  RNA_def_property_update(prop, NC_SCENE, NULL);
+
   prop = RNA_def_property(srna, "activity_culling_box_radius", PROP_FLOAT, PROP_NONE);
   RNA_def_property_float_sdna(prop, NULL, "activityBoxRadius");
-  RNA_def_property_range(prop, 0.0, 1000.0);
+  RNA_def_property_range(prop, 0.5, 10000.0);
   RNA_def_property_ui_text(prop,
                            "Box Radius",
                            "Radius of the activity bubble, in Manhattan length "
                            "(objects outside the box are activity-culled)");
+  RNA_def_property_update(prop, NC_SCENE, NULL);
 
   /* booleans */
   prop = RNA_def_property(srna, "use_viewport_render", PROP_BOOLEAN, PROP_NONE);
@@ -5797,6 +5822,41 @@ static void rna_def_scene_game_data(BlenderRNA *brna)
       "Restrict the number of animation updates to the animation FPS (this is "
       "better for performance, but can cause issues with smooth playback)");
 
+  prop = RNA_def_property(srna, "use_baked_actions", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "flag", GAME_USE_BAKED_ACTIONS);
+  RNA_def_property_ui_text(prop,
+                           "Bake Actions",
+                           "Sample the pose bone curves of the actions at every frame into "
+                           "compressed clips at game start and play armature actions from them "
+                           "(faster, but keys are linearly interpolated between frames, actions "
+                           "with curve modifiers or extrapolation are not baked)");
+
+  prop = RNA_def_property(srna, "use_animation_lod", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "flag", GAME_USE_ANIMATION_LOD);
+  RNA_def_property_ui_text(prop,
+                           "Animation Level of Detail",
+                           "Evaluate the pose of the armatures far from the camera less often "
+                           "and interpolate it between two evaluations, using the level of "
+                           "detail of their meshes when they have one");
+  RNA_def_property_update(prop, NC_SCENE, NULL);
+
+  prop = RNA_def_property(srna, "animation_lod_distance", PROP_FLOAT, PROP_DISTANCE);
+  RNA_def_property_float_sdna(prop, NULL, "animLodDistance");
+  RNA_def_property_range(prop, 0.0f, FLT_MAX);
+  RNA_def_property_ui_range(prop, 1.0f, 1000.0f, 10, 1);
+  RNA_def_property_ui_text(prop,
+                           "Distance",
+                           "Camera distance at which an armature skips one more frame between "
+                           "two pose updates, for armatures without level of detail meshes");
+  RNA_def_property_update(prop, NC_SCENE, NULL);
+
+  prop = RNA_def_property(srna, "animation_lod_max_interval", PROP_INT, PROP_NONE);
+  RNA_def_property_int_sdna(prop, NULL, "animLodMaxInterval");
+  RNA_def_property_range(prop, 1, 60);
+  RNA_def_property_ui_text(
+      prop, "Max Interval", "Maximum number of frames between two pose updates of an armature");
+  RNA_def_property_update(prop, NC_SCENE, NULL);
+
   prop = RNA_def_property(srna, "use_python_console", PROP_BOOLEAN, PROP_NONE);
   RNA_def_property_boolean_sdna(prop, NULL, "flag", GAME_PYTHON_CONSOLE);
   RNA_def_property_ui_text(prop, "Python Console", "Create a python interpreter console in game");
@@ -0,0 +1,170 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Common/CM_Profiler.cpp
+ *  \ingroup common
+ */
+
+#include "CM_Profiler.h"
+#include "CM_Message.h"
+#include "CM_Thread.h"
+
+#include <chrono>
+#include <memory>
+#include <stdio.h>
+#include <vector>
+
+#include "BLI_fileops.h"
+
+namespace {
+
+struct CM_ProfileThreadBuffer {
+  struct Zone {
+    const char *name;
+    int64_t begin;
+    /// End time for a zone, negative for a counter.
+    int64_t end;
+    double value;
+  };
+
+  unsigned int threadIndex;
+  /// Total number of zones written, the writing thread is the only one to increase it.
+  std::atomic<uint64_t> count;
+  Zone zones[CM_Profiler::BUFFER_SIZE];
+};
+
+}  // namespace
+
+std::atomic<bool> CM_Profiler::m_enabled(false);
+
+static const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+/// All the thread buffers, the lock is only taken when a thread records its first zone.
+static std::vector<std::unique_ptr<CM_ProfileThreadBuffer>> threadBuffers;
+static CM_ThreadMutex threadBuffersMutex;
+static thread_local CM_ProfileThreadBuffer *threadBuffer = nullptr;
+
+void CM_Profiler::SetEnabled(bool enabled)
+{
+  m_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+int64_t CM_Profiler::GetTime()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() -
+                                                              startTime)
+      .count();
+}
+
+static CM_ProfileThreadBuffer *get_thread_buffer()
+{
+  CM_ProfileThreadBuffer *buffer = threadBuffer;
+  if (!buffer) {
+    buffer = new CM_ProfileThreadBuffer();
+    buffer->count.store(0, std::memory_order_relaxed);
+
+    threadBuffersMutex.Lock();
+    buffer->threadIndex = threadBuffers.size();
+    threadBuffers.emplace_back(buffer);
+    threadBuffersMutex.Unlock();
+
+    threadBuffer = buffer;
+  }
+  return buffer;
+}
+
+static void add_zone(const char *name, int64_t begin, int64_t end, double value)
+{
+  CM_ProfileThreadBuffer *buffer = get_thread_buffer();
+  const uint64_t count = buffer->count.load(std::memory_order_relaxed);
+  CM_ProfileThreadBuffer::Zone &zone = buffer->zones[count % CM_Profiler::BUFFER_SIZE];
+  zone.name = name;
+  zone.begin = begin;
+  zone.end = end;
+  zone.value = value;
+  // Publish the zone to the exporting thread.
+  buffer->count.store(count + 1, std::memory_order_release);
+}
+
+void CM_Profiler::AddZone(const char *name, int64_t begin, int64_t end)
+{
+  add_zone(name, begin, end, 0.0);
+}
+
+void CM_Profiler::AddCounter(const char *name, int64_t time, double value)
+{
+  add_zone(name, time, -1, value);
+}
+
+bool CM_Profiler::ExportChromeTrace(const std::string &filepath)
+{
+  FILE *file = BLI_fopen(filepath.c_str(), "w");
+  if (!file) {
+    CM_Error("failed to open profile trace file \"" << filepath << "\"");
+    return false;
+  }
+
+  fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+  bool first = true;
+  threadBuffersMutex.Lock();
+  for (const std::unique_ptr<CM_ProfileThreadBuffer> &buffer : threadBuffers) {
+    fprintf(file,
+            "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,"
+            "\"args\":{\"name\":\"Thread %u\"}}",
+            first ? "" : ",\n",
+            buffer->threadIndex,
+            buffer->threadIndex);
+    first = false;
+
+    // Only the last zones of the ring buffer are available.
+    const uint64_t count = buffer->count.load(std::memory_order_acquire);
+    const uint64_t start = (count > BUFFER_SIZE) ? count - BUFFER_SIZE : 0;
+    for (uint64_t i = start; i < count; ++i) {
+      const CM_ProfileThreadBuffer::Zone &zone = buffer->zones[i % BUFFER_SIZE];
+      // Chrome trace times are in microseconds.
+      if (zone.end < 0) {
+        fprintf(file,
+                ",\n{\"name\":\"%s\",\"ph\":\"C\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,"
+                "\"args\":{\"value\":%g}}",
+                zone.name,
+                buffer->threadIndex,
+                zone.begin * 1e-3,
+                zone.value);
+      }
+      else {
+        fprintf(file,
+                ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,"
+                "\"dur\":%.3f}",
+                zone.name,
+                buffer->threadIndex,
+                zone.begin * 1e-3,
+                (zone.end - zone.begin) * 1e-3);
+      }
+    }
+  }
+  threadBuffersMutex.Unlock();
+
+  fprintf(file, "\n]}\n");
+  fclose(file);
+
+  return true;
+}
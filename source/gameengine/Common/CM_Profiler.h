@@ -0,0 +1,93 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file CM_Profiler.h
+ *  \ingroup common
+ */
+
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+#include <string>
+
+/** Hierarchical profiler of scoped zones.
+ * Every thread records its zones without locking in its own ring buffer keeping the last
+ * zones. The buffers are exported as a Chrome trace, also read by Perfetto, where the
+ * zones of a thread are nested by their times.
+ */
+class CM_Profiler {
+ public:
+  /// Number of zones kept by every thread.
+  static const unsigned int BUFFER_SIZE = 1 << 16;
+
+ private:
+  static std::atomic<bool> m_enabled;
+
+ public:
+  static void SetEnabled(bool enabled);
+  static bool IsEnabled()
+  {
+    return m_enabled.load(std::memory_order_relaxed);
+  }
+
+  /// Time in nanoseconds since the program start.
+  static int64_t GetTime();
+
+  /// Record a zone in the buffer of the calling thread, the name must be a static string.
+  static void AddZone(const char *name, int64_t begin, int64_t end);
+  /// Record a counter value at a time, e.g. a measured error, shown as a graph in the trace.
+  static void AddCounter(const char *name, int64_t time, double value);
+
+  /** Write the recorded zones of all the threads in a Chrome trace JSON file.
+   * The threads should not record zones meanwhile, typically when the engine exited.
+   */
+  static bool ExportChromeTrace(const std::string &filepath);
+};
+
+/// Record the time between its construction and destruction when the profiler is enabled.
+class CM_ProfileZone {
+ private:
+  const char *m_name;
+  int64_t m_begin;
+
+ public:
+  CM_ProfileZone(const char *name) : m_name(CM_Profiler::IsEnabled() ? name : nullptr)
+  {
+    if (m_name) {
+      m_begin = CM_Profiler::GetTime();
+    }
+  }
+
+  ~CM_ProfileZone()
+  {
+    if (m_name) {
+      CM_Profiler::AddZone(m_name, m_begin, CM_Profiler::GetTime());
+    }
+  }
+};
+
+#define CM_PROFILE_ZONE_CONCAT_IMPL(a, b) a##b
+#define CM_PROFILE_ZONE_CONCAT(a, b) CM_PROFILE_ZONE_CONCAT_IMPL(a, b)
+/// Profile the rest of the current scope under the name.
+#define CM_PROFILE_ZONE(name) \
+  CM_ProfileZone CM_PROFILE_ZONE_CONCAT(cm_profile_zone_, __LINE__)(name)
@@ -0,0 +1,266 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Converter/BL_ActionClip.cpp
+ *  \ingroup bgeconv
+ */
+
+#include "BL_ActionClip.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+
+#include "BKE_action.h"
+#include "BKE_fcurve.h"
+#include "BLI_listbase.h"
+#include "BLI_math_rotation.h"
+#include "BLI_simd.h"
+#include "BLI_string.h"
+#include "DNA_action_types.h"
+#include "DNA_anim_types.h"
+#include "MEM_guardedalloc.h"
+
+#include "BL_Action.h"
+
+/// Maximum quantized value of a sample.
+#define MAX_SAMPLE_VALUE 65535.0f
+
+/// Return the offset in BL_BoneTransform of a pose bone property component, -1 if unsupported.
+static int get_transform_offset(const char *prop, int index)
+{
+  if (STREQ(prop, "location") && index < 3) {
+    return offsetof(BL_BoneTransform, loc) / sizeof(float) + index;
+  }
+  if (STREQ(prop, "scale") && index < 3) {
+    return offsetof(BL_BoneTransform, size) / sizeof(float) + index;
+  }
+  if (STREQ(prop, "rotation_euler") && index < 3) {
+    return offsetof(BL_BoneTransform, eul) / sizeof(float) + index;
+  }
+  if (STREQ(prop, "rotation_quaternion") && index < 4) {
+    return offsetof(BL_BoneTransform, quat) / sizeof(float) + index;
+  }
+  return -1;
+}
+
+BL_ActionClip::BL_ActionClip(bAction *action, float startFrame, unsigned int numFrames)
+    : m_action(action), m_startFrame(startFrame), m_numFrames(numFrames)
+{
+}
+
+BL_ActionClip::~BL_ActionClip()
+{
+}
+
+BL_ActionClip *BL_ActionClip::Bake(bAction *action)
+{
+  float start, end;
+  calc_action_range(action, &start, &end, false);
+  const unsigned int numFrames = std::max((int)std::ceil(end - start), 0) + 1;
+
+  BL_ActionClip *clip = new BL_ActionClip(action, start, numFrames);
+  std::vector<float> values(numFrames);
+
+  LISTBASE_FOREACH (FCurve *, fcu, &action->curves) {
+    if (!fcu->rna_path || (fcu->flag & FCURVE_MUTED)) {
+      continue;
+    }
+
+    char *name = BLI_str_quoted_substrN(fcu->rna_path, "pose.bones[");
+    if (!name) {
+      // Not a pose bone curve, the object curves are played by the scene graph controllers.
+      continue;
+    }
+
+    const int offset = get_transform_offset(strrchr(fcu->rna_path, '.') + 1, fcu->array_index);
+    /* Other properties need the animation system, the modifiers and the linear extrapolation
+     * can change the curve outside of the sampled range, the action is not baked. */
+    if (offset == -1 || !BLI_listbase_is_empty(&fcu->modifiers) ||
+        fcu->extend != FCURVE_EXTRAPOLATE_CONSTANT) {
+      MEM_freeN(name);
+      delete clip;
+      return nullptr;
+    }
+
+    std::vector<Track>::iterator it = std::find_if(
+        clip->m_tracks.begin(), clip->m_tracks.end(), [name](const Track &track) {
+          return track.name == name;
+        });
+    if (it == clip->m_tracks.end()) {
+      clip->m_tracks.push_back({name, {}});
+      it = clip->m_tracks.end() - 1;
+    }
+    MEM_freeN(name);
+
+    for (unsigned int i = 0; i < numFrames; ++i) {
+      values[i] = evaluate_fcurve(fcu, start + i);
+    }
+    const float min = *std::min_element(values.begin(), values.end());
+    const float max = *std::max_element(values.begin(), values.end());
+
+    Curve curve;
+    curve.offset = offset;
+    curve.min = min;
+    if (max - min < 1e-6f) {
+      curve.step = 0.0f;
+      curve.first = -1;
+    }
+    else {
+      curve.step = (max - min) / MAX_SAMPLE_VALUE;
+      curve.first = clip->m_samples.size();
+      for (float value : values) {
+        clip->m_samples.push_back((uint16_t)std::lround((value - min) / curve.step));
+      }
+    }
+    it->curves.push_back(curve);
+  }
+
+  if (clip->m_tracks.empty()) {
+    delete clip;
+    return nullptr;
+  }
+
+  return clip;
+}
+
+bAction *BL_ActionClip::GetAction() const
+{
+  return m_action;
+}
+
+unsigned int BL_ActionClip::GetMemorySize() const
+{
+  return m_samples.size() * sizeof(uint16_t);
+}
+
+void BL_ActionClip::Bind(bPose *pose, std::vector<int> &channels) const
+{
+  channels.resize(m_tracks.size());
+  for (unsigned int i = 0, size = m_tracks.size(); i < size; ++i) {
+    bPoseChannel *pchan = BKE_pose_channel_find_name(pose, m_tracks[i].name.c_str());
+    channels[i] = pchan ? BLI_findindex(&pose->chanbase, pchan) : -1;
+  }
+}
+
+void BL_ActionClip::Evaluate(float frame,
+                             const std::vector<int> &channels,
+                             std::vector<BL_BoneTransform> &transforms) const
+{
+  const float pos = std::min(std::max(frame - m_startFrame, 0.0f), (float)(m_numFrames - 1));
+  const unsigned int index = (unsigned int)pos;
+  const unsigned int next = std::min(index + 1, m_numFrames - 1);
+  const float fac = pos - (float)index;
+
+  for (unsigned int i = 0, size = m_tracks.size(); i < size; ++i) {
+    const int channel = channels[i];
+    if (channel == -1 || channel >= (int)transforms.size()) {
+      continue;
+    }
+
+    float *values = (float *)&transforms[channel];
+    for (const Curve &curve : m_tracks[i].curves) {
+      if (curve.first == -1) {
+        values[curve.offset] = curve.min;
+      }
+      else {
+        const float s1 = m_samples[curve.first + index];
+        const float s2 = m_samples[curve.first + next];
+        values[curve.offset] = curve.min + (s1 + (s2 - s1) * fac) * curve.step;
+      }
+    }
+  }
+}
+
+void BL_BlendBoneTransforms(std::vector<BL_BoneTransform> &dst,
+                            const std::vector<BL_BoneTransform> &src,
+                            const std::vector<short> &rotmodes,
+                            float srcweight,
+                            short mode)
+{
+  const float dstweight = (mode == BL_Action::ACT_BLEND_BLEND) ? 1.0f - srcweight : 1.0f;
+
+#ifdef BLI_HAVE_SSE2
+  const __m128 dw = _mm_set1_ps(dstweight);
+  const __m128 sw = _mm_set1_ps(srcweight);
+  const __m128 one = _mm_set1_ps(1.0f);
+#endif
+
+  for (unsigned int i = 0, size = std::min(dst.size(), src.size()); i < size; ++i) {
+    BL_BoneTransform &dchan = dst[i];
+    const BL_BoneTransform &schan = src[i];
+    const bool quat = (rotmodes[i] == ROT_MODE_QUAT);
+
+#ifdef BLI_HAVE_SSE2
+    const __m128 dloc = _mm_loadu_ps(dchan.loc);
+    const __m128 sloc = _mm_loadu_ps(schan.loc);
+    _mm_storeu_ps(dchan.loc, _mm_add_ps(_mm_mul_ps(dloc, dw), _mm_mul_ps(sloc, sw)));
+
+    const __m128 dsize = _mm_sub_ps(_mm_loadu_ps(dchan.size), one);
+    const __m128 ssize = _mm_sub_ps(_mm_loadu_ps(schan.size), one);
+    _mm_storeu_ps(dchan.size,
+                  _mm_add_ps(one, _mm_add_ps(_mm_mul_ps(dsize, dw), _mm_mul_ps(ssize, sw))));
+
+    if (!quat) {
+      const __m128 deul = _mm_loadu_ps(dchan.eul);
+      const __m128 seul = _mm_loadu_ps(schan.eul);
+      _mm_storeu_ps(dchan.eul, _mm_add_ps(_mm_mul_ps(deul, dw), _mm_mul_ps(seul, sw)));
+    }
+#else
+    for (unsigned short j = 0; j < 3; ++j) {
+      dchan.loc[j] = (dchan.loc[j] * dstweight) + (schan.loc[j] * srcweight);
+      dchan.size[j] = 1.0f + ((dchan.size[j] - 1.0f) * dstweight) +
+                      ((schan.size[j] - 1.0f) * srcweight);
+      if (!quat) {
+        dchan.eul[j] = (dchan.eul[j] * dstweight) + (schan.eul[j] * srcweight);
+      }
+    }
+#endif
+
+    if (quat) {
+      float dquat[4], squat[4];
+      // Normalize quaternions so that interpolation/multiplication result is correct.
+      normalize_qt_qt(dquat, dchan.quat);
+      normalize_qt_qt(squat, schan.quat);
+
+      if (mode == BL_Action::ACT_BLEND_BLEND) {
+        interp_qt_qtqt(dchan.quat, dquat, squat, srcweight);
+      }
+      else {
+        pow_qt_fl_normalized(squat, srcweight);
+        mul_qt_qtqt(dchan.quat, dquat, squat);
+      }
+
+      normalize_qt(dchan.quat);
+    }
+  }
+}
+
+void BL_BlendConstraintInfluences(std::vector<float> &dst,
+                                  const std::vector<float> &src,
+                                  float srcweight)
+{
+  for (unsigned int i = 0, size = std::min(dst.size(), src.size()); i < size; ++i) {
+    dst[i] = dst[i] * (1.0f - srcweight) + src[i] * srcweight;
+  }
+}
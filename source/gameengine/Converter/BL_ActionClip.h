@@ -0,0 +1,118 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file BL_ActionClip.h
+ *  \ingroup bgeconv
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+struct bAction;
+struct bPose;
+
+/** Transform of a pose channel, every vector is padded to four floats to be blended
+ * with SIMD instructions.
+ */
+struct BL_BoneTransform {
+  float loc[4];
+  float size[4];
+  float eul[4];
+  float quat[4];
+};
+
+/** Blend the transforms of the source pose in the destination pose like the pose blending
+ * of the actions, the poses are indexed by channel ordinal.
+ * \param rotmodes The rotation mode of each channel.
+ * \param mode The action blending mode, BL_Action::ACT_BLEND_BLEND or BL_Action::ACT_BLEND_ADD.
+ */
+void BL_BlendBoneTransforms(std::vector<BL_BoneTransform> &dst,
+                            const std::vector<BL_BoneTransform> &src,
+                            const std::vector<short> &rotmodes,
+                            float srcweight,
+                            short mode);
+
+/** Blend the bone constraint influences of the source pose in the destination pose like the
+ * pose blending of the actions, which has no add mode for the influences.
+ */
+void BL_BlendConstraintInfluences(std::vector<float> &dst,
+                                  const std::vector<float> &src,
+                                  float srcweight);
+
+/** Action sampled at every frame into quantized tracks of pose bone transforms.
+ * It's played without the animation system and without any channel lookup by name.
+ * Only the location, rotation and scale curves of the pose bones are baked, every curve
+ * is stored as 16 bits samples in its value range and constant curves as a single value.
+ */
+class BL_ActionClip {
+ private:
+  struct Curve {
+    /// Offset of the value in BL_BoneTransform as a float array.
+    unsigned short offset;
+    float min;
+    /// Value of one quantization step.
+    float step;
+    /// Index of the first sample, -1 for a constant curve.
+    int first;
+  };
+
+  struct Track {
+    /// Name of the pose channel.
+    std::string name;
+    std::vector<Curve> curves;
+  };
+
+  bAction *m_action;
+  float m_startFrame;
+  unsigned int m_numFrames;
+  std::vector<Track> m_tracks;
+  std::vector<uint16_t> m_samples;
+
+  BL_ActionClip(bAction *action, float startFrame, unsigned int numFrames);
+
+ public:
+  ~BL_ActionClip();
+
+  /** Bake the pose bone curves of an action.
+   * \return The clip or nullptr if the action doesn't animate pose bones or animates pose
+   * bone properties which can't be baked, or with curve modifiers or linear extrapolation.
+   */
+  static BL_ActionClip *Bake(bAction *action);
+
+  bAction *GetAction() const;
+  /// Size in bytes of the samples.
+  unsigned int GetMemorySize() const;
+
+  /** Find the channel ordinal in the pose of every track, -1 for the missing channels.
+   * The result is passed to Evaluate for this pose.
+   */
+  void Bind(bPose *pose, std::vector<int> &channels) const;
+  /** Write the animated transforms at the given action frame in the transforms
+   * indexed by channel ordinal, the other transforms are unchanged.
+   */
+  void Evaluate(float frame,
+                const std::vector<int> &channels,
+                std::vector<BL_BoneTransform> &transforms) const;
+};
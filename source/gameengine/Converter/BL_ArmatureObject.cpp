@@ -31,6 +31,8 @@
 
 #include "BL_ArmatureObject.h"
 
+#include <algorithm>
+
 #include "BKE_action.h"
 #include "BKE_animsys.h"
 #include "BKE_armature.h"
@@ -198,7 +200,10 @@ BL_ArmatureObject::BL_ArmatureObject(void *sgReplicationInfo,
       m_scene(scene),
       m_lastframe(0.0),
       m_drawDebug(false),
-      m_lastapplyframe(0.0)
+      m_lastapplyframe(0.0),
+      m_poseUpdateInterval(1),
+      m_poseUpdateElapsed(0),
+      m_poseInterpolated(false)
 {
   m_controlledConstraints = new EXP_ListValue<BL_ArmatureConstraint>();
   m_poseChannels = new EXP_ListValue<BL_ArmatureChannel>();
@@ -444,6 +449,65 @@ void BL_ArmatureObject::BlendInPose(bPose *blend_pose, float weight, short mode)
   game_blend_poses(m_objArma->pose, blend_pose, weight, mode);
 }
 
+void BL_ArmatureObject::GetBoneTransforms(std::vector<BL_BoneTransform> &transforms) const
+{
+  transforms.resize(BLI_listbase_count(&m_objArma->pose->chanbase));
+  unsigned int i = 0;
+  LISTBASE_FOREACH (bPoseChannel *, pchan, &m_objArma->pose->chanbase) {
+    BL_BoneTransform &transform = transforms[i++];
+    copy_v3_v3(transform.loc, pchan->loc);
+    copy_v3_v3(transform.size, pchan->size);
+    copy_v3_v3(transform.eul, pchan->eul);
+    copy_qt_qt(transform.quat, pchan->quat);
+    transform.loc[3] = transform.size[3] = transform.eul[3] = 0.0f;
+  }
+}
+
+void BL_ArmatureObject::GetBoneRotationModes(std::vector<short> &rotmodes) const
+{
+  rotmodes.clear();
+  LISTBASE_FOREACH (bPoseChannel *, pchan, &m_objArma->pose->chanbase) {
+    rotmodes.push_back(pchan->rotmode);
+  }
+}
+
+void BL_ArmatureObject::SetBoneTransforms(const std::vector<BL_BoneTransform> &transforms)
+{
+  unsigned int i = 0;
+  for (bPoseChannel *pchan = (bPoseChannel *)m_objArma->pose->chanbase.first;
+       pchan && i < transforms.size();
+       pchan = pchan->next) {
+    const BL_BoneTransform &transform = transforms[i++];
+    copy_v3_v3(pchan->loc, transform.loc);
+    copy_v3_v3(pchan->size, transform.size);
+    copy_v3_v3(pchan->eul, transform.eul);
+    copy_qt_qt(pchan->quat, transform.quat);
+  }
+}
+
+void BL_ArmatureObject::GetConstraintInfluences(std::vector<float> &influences) const
+{
+  influences.clear();
+  LISTBASE_FOREACH (bPoseChannel *, pchan, &m_objArma->pose->chanbase) {
+    LISTBASE_FOREACH (bConstraint *, con, &pchan->constraints) {
+      influences.push_back(con->enforce);
+    }
+  }
+}
+
+void BL_ArmatureObject::SetConstraintInfluences(const std::vector<float> &influences)
+{
+  unsigned int i = 0;
+  LISTBASE_FOREACH (bPoseChannel *, pchan, &m_objArma->pose->chanbase) {
+    LISTBASE_FOREACH (bConstraint *, con, &pchan->constraints) {
+      if (i == influences.size()) {
+        return;
+      }
+      con->enforce = influences[i++];
+    }
+  }
+}
+
 bool BL_ArmatureObject::UpdateTimestep(double curtime)
 {
   if (curtime != m_lastframe) {
@@ -515,6 +579,59 @@ bool BL_ArmatureObject::GetDrawDebug() const
   return m_drawDebug;
 }
 
+void BL_ArmatureObject::SetPoseUpdateLod(unsigned int interval, unsigned int elapsed)
+{
+  m_poseUpdateInterval = interval;
+  m_poseUpdateElapsed = elapsed;
+}
+
+bool BL_ArmatureObject::IsPoseUpdateDelayed() const
+{
+  return m_poseUpdateElapsed != 0;
+}
+
+void BL_ArmatureObject::UpdateLodPose(bool culled)
+{
+  m_poseInterpolated = false;
+
+  // The poses stored before a full rate or culled period are outdated.
+  if (culled || m_poseUpdateInterval <= 1) {
+    m_prevPoseTransforms.clear();
+    m_nextPoseTransforms.clear();
+    return;
+  }
+
+  if (m_poseUpdateElapsed == 0) {
+    std::swap(m_prevPoseTransforms, m_nextPoseTransforms);
+    GetBoneTransforms(m_nextPoseTransforms);
+    // The first evaluated pose is interpolated with itself.
+    if (m_prevPoseTransforms.size() != m_nextPoseTransforms.size()) {
+      m_prevPoseTransforms = m_nextPoseTransforms;
+      GetBoneRotationModes(m_lodRotModes);
+    }
+  }
+  else if (m_nextPoseTransforms.empty()) {
+    // No pose evaluated since the level of detail is used, keep the current pose.
+    return;
+  }
+
+  const float weight = std::min(
+      (float)(m_poseUpdateElapsed + 1) / (float)m_poseUpdateInterval, 1.0f);
+  m_lodPoseTransforms = m_prevPoseTransforms;
+  BL_BlendBoneTransforms(m_lodPoseTransforms,
+                         m_nextPoseTransforms,
+                         m_lodRotModes,
+                         weight,
+                         BL_Action::ACT_BLEND_BLEND);
+  SetBoneTransforms(m_lodPoseTransforms);
+  m_poseInterpolated = true;
+}
+
+bool BL_ArmatureObject::IsPoseInterpolated() const
+{
+  return m_poseInterpolated;
+}
+
 void BL_ArmatureObject::DrawDebug(RAS_DebugDraw &debugDraw)
 {
   const MT_Vector3 &scale = NodeGetWorldScaling();
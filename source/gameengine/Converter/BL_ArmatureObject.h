@@ -31,6 +31,7 @@
 
 #pragma once
 
+#include "BL_ActionClip.h"
 #include "BL_ArmatureChannel.h"
 #include "BL_ArmatureConstraint.h"
 #include "KX_GameObject.h"
@@ -67,6 +68,18 @@ class BL_ArmatureObject : public KX_GameObject {
 
   double m_lastapplyframe;
 
+  /// Number of frames between two pose updates of the animation level of detail.
+  unsigned int m_poseUpdateInterval;
+  /// Number of frames since the last pose update, 0 when the pose is updated this frame.
+  unsigned int m_poseUpdateElapsed;
+  /// The two last evaluated poses, interpolated while the pose update is delayed.
+  std::vector<BL_BoneTransform> m_prevPoseTransforms;
+  std::vector<BL_BoneTransform> m_nextPoseTransforms;
+  std::vector<BL_BoneTransform> m_lodPoseTransforms;
+  std::vector<short> m_lodRotModes;
+  /// Set to true when the pose was interpolated this frame and must be sent to the depsgraph.
+  bool m_poseInterpolated;
+
  public:
   BL_ArmatureObject(void *sgReplicationInfo,
                     SG_Callbacks callbacks,
@@ -90,11 +103,29 @@ class BL_ArmatureObject : public KX_GameObject {
   void SetPoseByAction(bAction *action, AnimationEvalContext *evalCtx);
   void BlendInPose(bPose *blend_pose, float weight, short mode);
 
+  /// Copy the transform of every pose channel in channel order.
+  void GetBoneTransforms(std::vector<BL_BoneTransform> &transforms) const;
+  void GetBoneRotationModes(std::vector<short> &rotmodes) const;
+  /// Set the transform of every pose channel from transforms in channel order.
+  void SetBoneTransforms(const std::vector<BL_BoneTransform> &transforms);
+  /// Copy the influence of every pose channel constraint in channel and constraint order.
+  void GetConstraintInfluences(std::vector<float> &influences) const;
+  void SetConstraintInfluences(const std::vector<float> &influences);
+
   bool UpdateTimestep(double curtime);
 
   Object *GetArmatureObject();
   Object *GetOrigArmatureObject();
   bool GetDrawDebug() const;
+  /// Set the pose update interval and the number of frames since the last pose update.
+  void SetPoseUpdateLod(unsigned int interval, unsigned int elapsed);
+  bool IsPoseUpdateDelayed() const;
+  /** Store the pose evaluated this frame and replace the pose by the interpolation of the two
+   * last evaluated poses, the interpolation lags one interval behind the actions.
+   * \param culled True when the pose is neither evaluated nor displayed this frame.
+   */
+  void UpdateLodPose(bool culled);
+  bool IsPoseInterpolated() const;
   void DrawDebug(RAS_DebugDraw &debugDraw);
 
   // for constraint python API
@@ -35,6 +35,10 @@
 
 #include "BL_BlenderConverter.h"
 
+#include <algorithm>
+#include <set>
+
+#include "BKE_collection.h"
 #include "BKE_context.h"
 #include "BKE_idtype.h"
 #include "BKE_layer.h"
@@ -51,6 +55,7 @@
 #include "DNA_material_types.h"
 #include "DNA_mesh_types.h"
 #include "DNA_scene_types.h"
+#include "PIL_time.h"
 
 #include "BL_ActionActuator.h"
 #include "BL_BlenderDataConversion.h"
@@ -91,7 +96,11 @@ void BL_BlenderConverter::SceneSlot::Merge(BL_BlenderConverter::SceneSlot &other
   m_meshobjects.insert(m_meshobjects.begin(),
                        std::make_move_iterator(other.m_meshobjects.begin()),
                        std::make_move_iterator(other.m_meshobjects.end()));
+  m_actionClips.insert(m_actionClips.begin(),
+                       std::make_move_iterator(other.m_actionClips.begin()),
+                       std::make_move_iterator(other.m_actionClips.end()));
   m_actionToInterp.insert(other.m_actionToInterp.begin(), other.m_actionToInterp.end());
+  m_actionToClip.insert(other.m_actionToClip.begin(), other.m_actionToClip.end());
 }
 
 void BL_BlenderConverter::SceneSlot::Merge(const BL_BlenderSceneConverter *converter)
@@ -102,6 +111,10 @@ void BL_BlenderConverter::SceneSlot::Merge(const BL_BlenderSceneConverter *conve
   for (RAS_MeshObject *meshobj : converter->m_meshobjects) {
     m_meshobjects.emplace_back(meshobj);
   }
+  for (BL_ActionClip *clip : converter->m_actionClips) {
+    m_actionClips.emplace_back(clip);
+    m_actionToClip[clip->GetAction()] = clip;
+  }
 }
 
 BL_BlenderConverter::BL_BlenderConverter(Main *maggie, KX_KetsjiEngine *engine)
@@ -120,6 +133,10 @@ BL_BlenderConverter::~BL_BlenderConverter()
 
   m_DynamicMaggie.clear();
 
+  for (KX_LibLoadStatus *status : m_finishedConversions) {
+    delete status;
+  }
+
   /* Thread infos like mutex must be freed after FreeBlendFile function.
      Because it needs to lock the mutex, even if there's no active task when it's
      in the scene converter destructor. */
@@ -246,6 +263,14 @@ void BL_BlenderConverter::RemoveScene(KX_Scene *scene)
   SceneSlot &sceneSlot = m_sceneSlots[scene];
   sceneSlot.m_meshobjects.clear();
 
+  /* Cancel the asynchronous conversions in this scene, they are finished and freed
+   * in the next MergeAsyncConversions. */
+  for (KX_LibLoadStatus *status : m_activeConversions) {
+    if (status->GetMergeScene() == scene) {
+      status->SetMergeScene(nullptr);
+    }
+  }
+
   // Delete the scene.
   scene->Release();
 
@@ -271,6 +296,36 @@ BL_InterpolatorList *BL_BlenderConverter::FindInterpolatorList(KX_Scene *scene,
   return m_sceneSlots[scene].m_actionToInterp[for_act];
 }
 
+void BL_BlenderConverter::RegisterActionClip(KX_Scene *scene, BL_ActionClip *clip)
+{
+  SceneSlot &sceneSlot = m_sceneSlots[scene];
+  sceneSlot.m_actionClips.emplace_back(clip);
+  sceneSlot.m_actionToClip[clip->GetAction()] = clip;
+}
+
+BL_ActionClip *BL_BlenderConverter::FindActionClip(KX_Scene *scene, bAction *for_act)
+{
+  const std::map<bAction *, BL_ActionClip *> &actionToClip = m_sceneSlots[scene].m_actionToClip;
+  const std::map<bAction *, BL_ActionClip *>::const_iterator it = actionToClip.find(for_act);
+  return (it != actionToClip.end()) ? it->second : nullptr;
+}
+
+BL_ActionClip *BL_BlenderConverter::BakeActionClip(KX_Scene *scene, bAction *for_act)
+{
+  if (!(scene->GetBlenderScene()->gm.flag & GAME_USE_BAKED_ACTIONS)) {
+    return nullptr;
+  }
+
+  BL_ActionClip *clip = FindActionClip(scene, for_act);
+  if (!clip) {
+    clip = BL_ActionClip::Bake(for_act);
+    if (clip) {
+      RegisterActionClip(scene, clip);
+    }
+  }
+  return clip;
+}
+
 Main *BL_BlenderConverter::CreateMainDynamic(const std::string &path)
 {
   Main *maggie = BKE_main_new();
@@ -296,6 +351,25 @@ Main *BL_BlenderConverter::GetMainDynamicPath(const std::string &path) const
   return nullptr;
 }
 
+/// Maximum time spent per frame to convert objects asynchronously, in seconds.
+static const double ASYNC_CONVERSION_TIME_BUDGET = 0.002;
+
+/// Data of an asynchronous objects conversion, stored in its KX_LibLoadStatus.
+struct BL_AsyncConversionData {
+  std::vector<Object *> objects;
+  /// Index of the next object to convert.
+  unsigned int index;
+};
+
+static unsigned int object_parent_depth(Object *ob)
+{
+  unsigned int depth = 0;
+  for (Object *parent = ob->parent; parent; parent = parent->parent) {
+    ++depth;
+  }
+  return depth;
+}
+
 void BL_BlenderConverter::MergeAsyncLoads()
 {
   std::vector<KX_Scene *> *merge_scenes;
@@ -330,6 +404,13 @@ void BL_BlenderConverter::FinalizeAsyncLoads()
   BLI_task_pool_work_and_wait(m_threadinfo.m_pool);
   // Merge all libraries data in the current scene, to avoid memory leak of unmerged scenes.
   MergeAsyncLoads();
+
+  // The game is ending, the pending objects conversions are discarded.
+  for (KX_LibLoadStatus *status : m_activeConversions) {
+    delete (BL_AsyncConversionData *)status->GetData();
+    delete status;
+  }
+  m_activeConversions.clear();
 }
 
 void BL_BlenderConverter::AddScenesToMergeQueue(KX_LibLoadStatus *status)
@@ -364,6 +445,97 @@ static void async_convert(TaskPool *pool, void *ptr, int UNUSED(threadid))
   status->GetConverter()->AddScenesToMergeQueue(status);
 }
 
+KX_LibLoadStatus *BL_BlenderConverter::ConvertObjectsAsync(KX_Scene *scene,
+                                                           Collection *collection,
+                                                           const std::vector<Object *> &objects,
+                                                           const std::string &name)
+{
+  /* The objects list is prepared on the main thread, the collection object cache is rebuilt
+   * each time an object is added to a collection, e.g. by the conversion of the previous
+   * frames. */
+  BL_AsyncConversionData *data = new BL_AsyncConversionData();
+  data->objects = objects;
+  data->index = 0;
+
+  if (collection) {
+    FOREACH_COLLECTION_OBJECT_RECURSIVE_BEGIN (collection, obj) {
+      data->objects.push_back(obj);
+    }
+    FOREACH_COLLECTION_OBJECT_RECURSIVE_END;
+  }
+
+  // Remove the duplicated objects, keeping the first occurrence.
+  std::set<Object *> visited;
+  data->objects.erase(
+      std::remove_if(data->objects.begin(),
+                     data->objects.end(),
+                     [&visited](Object *ob) { return !visited.insert(ob).second; }),
+      data->objects.end());
+
+  // Convert the parents before their children so that the parent relations can be resolved.
+  std::vector<std::pair<unsigned int, Object *>> sorted;
+  sorted.reserve(data->objects.size());
+  for (Object *ob : data->objects) {
+    sorted.emplace_back(object_parent_depth(ob), ob);
+  }
+  std::stable_sort(sorted.begin(),
+                   sorted.end(),
+                   [](const std::pair<unsigned int, Object *> &a,
+                      const std::pair<unsigned int, Object *> &b) { return a.first < b.first; });
+  for (unsigned int i = 0, size = sorted.size(); i < size; ++i) {
+    data->objects[i] = sorted[i].second;
+  }
+
+  KX_LibLoadStatus *status = new KX_LibLoadStatus(this, m_ketsjiEngine, scene, name);
+  status->SetData(data);
+
+  m_activeConversions.push_back(status);
+
+  return status;
+}
+
+void BL_BlenderConverter::MergeAsyncConversions()
+{
+  if (m_activeConversions.empty()) {
+    return;
+  }
+
+  // Convert at least one object per frame to always make progress.
+  const double endtime = PIL_check_seconds_timer() + ASYNC_CONVERSION_TIME_BUDGET;
+
+  while (!m_activeConversions.empty()) {
+    KX_LibLoadStatus *status = m_activeConversions.front();
+    BL_AsyncConversionData *data = (BL_AsyncConversionData *)status->GetData();
+    KX_Scene *scene = status->GetMergeScene();
+
+    // A null scene means the scene was removed and the conversion canceled.
+    if (scene) {
+      const unsigned int size = data->objects.size();
+      while (data->index < size) {
+        scene->ConvertBlenderObject(data->objects[data->index++]);
+        status->SetProgress((float)data->index / (float)size);
+
+        if (PIL_check_seconds_timer() >= endtime && data->index < size) {
+          return;
+        }
+      }
+    }
+
+    delete data;
+    status->SetData(nullptr);
+    m_activeConversions.erase(m_activeConversions.begin());
+
+    /* The status is kept alive like the libraries loading status, its python proxy can be
+     * polled after the conversion finished. */
+    status->Finish();
+    m_finishedConversions.push_back(status);
+
+    if (PIL_check_seconds_timer() >= endtime) {
+      return;
+    }
+  }
+}
+
 KX_LibLoadStatus *BL_BlenderConverter::LinkBlendFileMemory(void *data,
                                                            int length,
                                                            const char *path,
@@ -504,6 +676,10 @@ KX_LibLoadStatus *BL_BlenderConverter::LinkBlendFile(BlendHandle *bpy_openlib,
         CM_Debug("action name: " << action->name + 2);
       }
       scene_merge->GetLogicManager()->RegisterActionName(action->name + 2, action);
+      BL_ActionClip *clip = BakeActionClip(scene_merge, (bAction *)action);
+      if (clip && options & LIB_LOAD_VERBOSE) {
+        CM_Debug("baked action size: " << clip->GetMemorySize() << " bytes");
+      }
     }
   }
   else if (idcode == ID_SCE) {
@@ -554,6 +730,10 @@ KX_LibLoadStatus *BL_BlenderConverter::LinkBlendFile(BlendHandle *bpy_openlib,
           CM_Debug("action name: " << action->name + 2);
         }
         scene_merge->GetLogicManager()->RegisterActionName(action->name + 2, action);
+        BL_ActionClip *clip = BakeActionClip(scene_merge, (bAction *)action);
+        if (clip && options & LIB_LOAD_VERBOSE) {
+          CM_Debug("baked action size: " << clip->GetMemorySize() << " bytes");
+        }
       }
     }
   }
@@ -739,6 +919,18 @@ bool BL_BlenderConverter::FreeBlendFile(Main *maggie)
       }
     }
 
+    for (UniquePtrList<BL_ActionClip>::iterator it = sceneSlot.m_actionClips.begin();
+         it != sceneSlot.m_actionClips.end();) {
+      bAction *action = (*it)->GetAction();
+      if (IS_TAGGED(action)) {
+        sceneSlot.m_actionToClip.erase(action);
+        it = sceneSlot.m_actionClips.erase(it);
+      }
+      else {
+        ++it;
+      }
+    }
+
     for (UniquePtrList<RAS_MeshObject>::iterator it = sceneSlot.m_meshobjects.begin();
          it != sceneSlot.m_meshobjects.end();) {
       RAS_MeshObject *mesh = (*it).get();
@@ -34,6 +34,7 @@
 #include <map>
 #include <vector>
 
+#include "BL_ActionClip.h"
 #include "BL_BlenderScalarInterpolator.h"
 #include "CM_Thread.h"
 #include "EXP_ListValue.h"
@@ -52,6 +53,8 @@ class RAS_MeshObject;
 class RAS_Rasterizer;
 struct Main;
 struct BlendHandle;
+struct Collection;
+struct Object;
 struct Mesh;
 struct Scene;
 struct Material;
@@ -70,8 +73,10 @@ class BL_BlenderConverter {
     UniquePtrList<KX_BlenderMaterial> m_materials;
     UniquePtrList<RAS_MeshObject> m_meshobjects;
     UniquePtrList<BL_InterpolatorList> m_interpolators;
+    UniquePtrList<BL_ActionClip> m_actionClips;
 
     std::map<bAction *, BL_InterpolatorList *> m_actionToInterp;
+    std::map<bAction *, BL_ActionClip *> m_actionToClip;
 
     SceneSlot();
     SceneSlot(const BL_BlenderSceneConverter *converter);
@@ -92,6 +97,11 @@ class BL_BlenderConverter {
   std::map<std::string, KX_LibLoadStatus *> m_status_map;
   std::vector<KX_LibLoadStatus *> m_mergequeue;
 
+  /// Asynchronous objects conversions in progress.
+  std::vector<KX_LibLoadStatus *> m_activeConversions;
+  /// Finished asynchronous objects conversions, freed with the converter.
+  std::vector<KX_LibLoadStatus *> m_finishedConversions;
+
   Main *m_maggie;
   std::vector<Main *> m_DynamicMaggie;
 
@@ -119,6 +129,14 @@ class BL_BlenderConverter {
                                 bAction *for_act);
   BL_InterpolatorList *FindInterpolatorList(KX_Scene *scene, bAction *for_act);
 
+  void RegisterActionClip(KX_Scene *scene, BL_ActionClip *clip);
+  /// Return the baked clip of an action, nullptr if it's played by the animation system.
+  BL_ActionClip *FindActionClip(KX_Scene *scene, bAction *for_act);
+  /** Bake and register the clip of an action when the scene uses baked actions.
+   * \return The clip of the action, nullptr if it's played by the animation system.
+   */
+  BL_ActionClip *BakeActionClip(KX_Scene *scene, bAction *for_act);
+
   Scene *GetBlenderSceneForName(const std::string &name);
   EXP_ListValue<EXP_StringValue> *GetInactiveSceneNames();
 
@@ -154,6 +172,19 @@ class BL_BlenderConverter {
   void FinalizeAsyncLoads();
   void AddScenesToMergeQueue(KX_LibLoadStatus *status);
 
+  /** Convert a list of objects or the objects of a collection in a scene asynchronously.
+   * The objects list is prepared immediately and the objects are converted in
+   * MergeAsyncConversions with a time budget per frame.
+   * \param collection The collection to convert, or nullptr to convert objects.
+   * \param objects The objects to convert when collection is nullptr.
+   */
+  KX_LibLoadStatus *ConvertObjectsAsync(KX_Scene *scene,
+                                        Collection *collection,
+                                        const std::vector<Object *> &objects,
+                                        const std::string &name);
+  /// Convert the prepared objects of the asynchronous conversions in the frame time budget.
+  void MergeAsyncConversions();
+
   void PrintStats();
 
   // LibLoad Options.
@@ -77,6 +77,7 @@
 
 /* end of blender include block */
 
+#include "BL_ActionClip.h"
 #include "BL_ArmatureObject.h"
 #include "BL_BlenderSceneConverter.h"
 #include "BL_ConvertActuators.h"
@@ -1114,7 +1115,7 @@ void BL_ConvertBlenderObjects(struct Main *maggie,
     kxscene->SetGravity(MT_Vector3(0, 0, -blenderscene->gm.gravity));
 
     /* set activity culling parameters */
-    kxscene->SetActivityCulling(false);
+    kxscene->SetActivityCulling((blenderscene->gm.flag & GAME_USE_ACTIVITY_CULLING) != 0);
     kxscene->SetActivityCullingRadius(blenderscene->gm.activityBoxRadius);
     kxscene->SetDbvtCulling(false);
 
@@ -1136,7 +1137,6 @@ void BL_ConvertBlenderObjects(struct Main *maggie,
 
   EXP_ListValue<KX_GameObject> *objectlist = kxscene->GetObjectList();
   EXP_ListValue<KX_GameObject> *inactivelist = kxscene->GetInactiveList();
-  EXP_ListValue<KX_GameObject> *parentlist = kxscene->GetRootParentList();
 
   SCA_LogicManager *logicmgr = kxscene->GetLogicManager();
   SCA_TimeEventManager *timemgr = kxscene->GetTimeEventManager();
@@ -1148,6 +1148,14 @@ void BL_ConvertBlenderObjects(struct Main *maggie,
     bAction *curAct;
     for (curAct = (bAction *)maggie->actions.first; curAct; curAct = (bAction *)curAct->id.next) {
       logicmgr->RegisterActionName(curAct->id.name + 2, curAct);
+
+      // Bake the pose bone curves once to play them without the animation system.
+      if (blenderscene->gm.flag & GAME_USE_BAKED_ACTIONS) {
+        BL_ActionClip *clip = BL_ActionClip::Bake(curAct);
+        if (clip) {
+          converter->RegisterActionClip(clip);
+        }
+      }
     }
   }
   else {
@@ -1381,7 +1389,7 @@ void BL_ConvertBlenderObjects(struct Main *maggie,
       }
     }
     if (gameobj->GetSGNode()->GetSGParent() == 0) {
-      parentlist->Add(CM_AddRef(gameobj));
+      kxscene->AddRootObject(gameobj);
       gameobj->NodeUpdateGS(0);
     }
   }
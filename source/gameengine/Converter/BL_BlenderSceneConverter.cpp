@@ -37,6 +37,7 @@ BL_BlenderSceneConverter::BL_BlenderSceneConverter()
 {
   m_materials = {};
   m_meshobjects = {};
+  m_actionClips = {};
   m_map_blender_to_gameobject = {};
   m_map_mesh_to_gamemesh = {};
   m_map_mesh_to_polyaterial = {};
@@ -48,6 +49,7 @@ BL_BlenderSceneConverter::~BL_BlenderSceneConverter()
 {
   m_materials.clear();
   m_meshobjects.clear();
+  m_actionClips.clear();
   m_map_blender_to_gameobject.clear();
   m_map_mesh_to_gamemesh.clear();
   m_map_mesh_to_polyaterial.clear();
@@ -109,6 +111,11 @@ KX_BlenderMaterial *BL_BlenderSceneConverter::FindMaterial(Material *mat)
   return m_map_mesh_to_polyaterial[mat];
 }
 
+void BL_BlenderSceneConverter::RegisterActionClip(BL_ActionClip *clip)
+{
+  m_actionClips.push_back(clip);
+}
+
 void BL_BlenderSceneConverter::RegisterGameActuator(SCA_IActuator *act, bActuator *for_actuator)
 {
   m_map_blender_to_gameactuator[for_actuator] = act;
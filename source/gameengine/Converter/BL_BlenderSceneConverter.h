@@ -36,6 +36,7 @@
 
 #include "CM_Message.h"
 
+class BL_ActionClip;
 class SCA_IActuator;
 class SCA_IController;
 class RAS_MeshObject;
@@ -59,6 +60,7 @@ class BL_BlenderSceneConverter {
  private:
   std::vector<KX_BlenderMaterial *> m_materials;
   std::vector<RAS_MeshObject *> m_meshobjects;
+  std::vector<BL_ActionClip *> m_actionClips;
 
   std::map<Object *, KX_GameObject *> m_map_blender_to_gameobject;
   std::map<Mesh *, RAS_MeshObject *> m_map_mesh_to_gamemesh;
@@ -83,6 +85,8 @@ class BL_BlenderSceneConverter {
   void RegisterMaterial(KX_BlenderMaterial *blmat, Material *mat);
   KX_BlenderMaterial *FindMaterial(Material *mat);
 
+  void RegisterActionClip(BL_ActionClip *clip);
+
   void RegisterGameActuator(SCA_IActuator *act, bActuator *for_actuator);
   SCA_IActuator *FindGameActuator(bActuator *for_actuator);
 
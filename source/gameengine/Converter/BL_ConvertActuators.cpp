@@ -1001,6 +1001,7 @@ void BL_ConvertActuators(const char *maggiename,
         short facingMode = (stAct->flag & ACT_STEERING_AUTOMATICFACING) ? stAct->facingaxis : 0;
         bool normalup = (stAct->flag & ACT_STEERING_NORMALUP) != 0;
         bool lockzvel = (stAct->flag & ACT_STEERING_LOCKZVEL) != 0;
+        bool crowd = (stAct->flag & ACT_STEERING_CROWD) != 0;
         SCA_SteeringActuator *tmpstact = new SCA_SteeringActuator(gameobj,
                                                                   mode,
                                                                   targetob,
@@ -1015,7 +1016,8 @@ void BL_ConvertActuators(const char *maggiename,
                                                                   facingMode,
                                                                   normalup,
                                                                   enableVisualization,
-                                                                  lockzvel);
+                                                                  lockzvel,
+                                                                  crowd);
         baseact = tmpstact;
         break;
       }
@@ -26,9 +26,13 @@
 
 #include "DEV_InputDevice.h"
 
+#include <fstream>
+
+#include "CM_Message.h"
 #include "GHOST_Types.h"
 
 DEV_InputDevice::DEV_InputDevice()
+    : m_recordMode(RECORD_NONE), m_replayIndex(0), m_frame(0)
 {
   m_reverseKeyTranslateTable[GHOST_kKeyA] = AKEY;
   m_reverseKeyTranslateTable[GHOST_kKeyB] = BKEY;
@@ -170,14 +174,116 @@ DEV_InputDevice::~DEV_InputDevice()
 {
 }
 
+void DEV_InputDevice::StartRecord()
+{
+  m_recordMode = RECORD_WRITE;
+  m_recordEvents.clear();
+  m_frame = 0;
+}
+
+bool DEV_InputDevice::StartReplay(const std::string &filepath)
+{
+  std::ifstream file(filepath);
+  if (!file) {
+    CM_Error("cannot read input record \"" << filepath << "\"");
+    return false;
+  }
+
+  m_recordEvents.clear();
+  RecordEvent event;
+  int type;
+  while (file >> event.frame >> type >> event.input >> event.value >> event.value2) {
+    if (type < RECORD_EVENT || type > RECORD_WHEEL || event.input < 0 ||
+        event.input >= MAX_KEYS) {
+      CM_Error("invalid event in input record \"" << filepath << "\"");
+      m_recordEvents.clear();
+      return false;
+    }
+    event.type = (RecordEventType)type;
+    m_recordEvents.push_back(event);
+  }
+
+  m_recordMode = RECORD_REPLAY;
+  m_replayIndex = 0;
+  m_frame = 0;
+
+  return true;
+}
+
+bool DEV_InputDevice::WriteRecord(const std::string &filepath) const
+{
+  std::ofstream file(filepath);
+  if (!file) {
+    CM_Error("cannot write input record \"" << filepath << "\"");
+    return false;
+  }
+
+  // One event per line: frame, type, input, value and second value.
+  for (const RecordEvent &event : m_recordEvents) {
+    file << event.frame << " " << event.type << " " << event.input << " " << event.value << " "
+         << event.value2 << "\n";
+  }
+
+  return true;
+}
+
+DEV_InputDevice::RecordMode DEV_InputDevice::GetRecordMode() const
+{
+  return m_recordMode;
+}
+
+void DEV_InputDevice::AddRecordEvent(RecordEventType type, int input, int value, int value2)
+{
+  m_recordEvents.push_back({m_frame, type, input, value, value2});
+}
+
+void DEV_InputDevice::ReplayEvents()
+{
+  while (m_replayIndex < m_recordEvents.size() &&
+         m_recordEvents[m_replayIndex].frame <= m_frame) {
+    const RecordEvent &event = m_recordEvents[m_replayIndex++];
+    switch (event.type) {
+      case RECORD_EVENT: {
+        ConvertEvent((SCA_EnumInputs)event.input, event.value, event.value2);
+        break;
+      }
+      case RECORD_MOVE: {
+        ApplyMoveEvent(event.value, event.value2);
+        break;
+      }
+      case RECORD_WHEEL: {
+        ApplyWheelEvent(event.value);
+        break;
+      }
+    }
+  }
+}
+
+void DEV_InputDevice::ClearInputs()
+{
+  SCA_IInputDevice::ClearInputs();
+  // The inputs are cleared once at the end of every logic frame.
+  ++m_frame;
+}
+
+void DEV_InputDevice::ReleaseMoveEvent()
+{
+  /* Replay the events before the logic frame like the user events received
+   * since the last frame. */
+  if (m_recordMode == RECORD_REPLAY) {
+    ReplayEvents();
+  }
+  SCA_IInputDevice::ReleaseMoveEvent();
+}
+
 void DEV_InputDevice::ConvertKeyEvent(int incode, int val, unsigned int unicode)
 {
-  ConvertEvent(m_reverseKeyTranslateTable[incode], val, unicode);
+  ConvertUserEvent(m_reverseKeyTranslateTable[incode], val, unicode);
 }
 
 void DEV_InputDevice::ConvertButtonEvent(int incode, int val)
 {
-  ConvertEvent(m_reverseButtonTranslateTable[incode], val, 0);
+  ConvertUserEvent(m_reverseButtonTranslateTable[incode], val, 0);
 }
 
 void DEV_InputDevice::ConvertWindowEvent(int incode)
@@ -206,7 +312,42 @@ void DEV_InputDevice::ConvertEvent(SCA_IInputDevice::SCA_EnumInputs type,
   }
 }
 
+void DEV_InputDevice::ConvertUserEvent(SCA_IInputDevice::SCA_EnumInputs type,
+                                       int val,
+                                       unsigned int unicode)
+{
+  if (m_recordMode == RECORD_REPLAY) {
+    return;
+  }
+  if (m_recordMode == RECORD_WRITE) {
+    AddRecordEvent(RECORD_EVENT, type, val, unicode);
+  }
+  ConvertEvent(type, val, unicode);
+}
+
 void DEV_InputDevice::ConvertMoveEvent(int x, int y)
+{
+  if (m_recordMode == RECORD_REPLAY) {
+    return;
+  }
+  if (m_recordMode == RECORD_WRITE) {
+    AddRecordEvent(RECORD_MOVE, 0, x, y);
+  }
+  ApplyMoveEvent(x, y);
+}
+
+void DEV_InputDevice::ConvertWheelEvent(int z)
+{
+  if (m_recordMode == RECORD_REPLAY) {
+    return;
+  }
+  if (m_recordMode == RECORD_WRITE) {
+    AddRecordEvent(RECORD_WHEEL, 0, z, 0);
+  }
+  ApplyWheelEvent(z);
+}
+
+void DEV_InputDevice::ApplyMoveEvent(int x, int y)
 {
   SCA_InputEvent &xevent = m_inputsTable[MOUSEX];
   xevent.m_values.push_back(x);
@@ -223,7 +364,7 @@ void DEV_InputDevice::ConvertMoveEvent(int x, int y)
   }
 }
 
-void DEV_InputDevice::ConvertWheelEvent(int z)
+void DEV_InputDevice::ApplyWheelEvent(int z)
 {
   SCA_InputEvent &event = m_inputsTable[(z > 0) ? WHEELUPMOUSE : WHEELDOWNMOUSE];
   event.m_values.push_back(z);
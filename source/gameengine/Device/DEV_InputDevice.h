@@ -27,20 +27,72 @@
 #pragma once
 
 #include <map>
+#include <string>
+#include <vector>
 
 #include "SCA_IInputDevice.h"
 
 class DEV_InputDevice : public SCA_IInputDevice {
+ public:
+  enum RecordMode {
+    /// The user input is used.
+    RECORD_NONE = 0,
+    /// The user input is used and saved.
+    RECORD_WRITE,
+    /// The user input is ignored and replaced by a recorded input.
+    RECORD_REPLAY
+  };
+
  protected:
   /// These maps converts GHOST input number to SCA input enum.
   std::map<int, SCA_EnumInputs> m_reverseKeyTranslateTable;
   std::map<int, SCA_EnumInputs> m_reverseButtonTranslateTable;
   std::map<int, SCA_EnumInputs> m_reverseWindowTranslateTable;
 
+  enum RecordEventType { RECORD_EVENT = 0, RECORD_MOVE, RECORD_WHEEL };
+
+  /// An input event and the logic frame consuming it.
+  struct RecordEvent {
+    unsigned int frame;
+    RecordEventType type;
+    /// SCA input for RECORD_EVENT.
+    int input;
+    /// Event value, X position or wheel delta.
+    int value;
+    /// Unicode character or Y position.
+    int value2;
+  };
+
+  RecordMode m_recordMode;
+  std::vector<RecordEvent> m_recordEvents;
+  /// Next event to replay.
+  unsigned int m_replayIndex;
+  /// Number of logic frames since the record start.
+  unsigned int m_frame;
+
+  /// Record or ignore a user event according to the record mode before converting it.
+  void ConvertUserEvent(SCA_IInputDevice::SCA_EnumInputs type, int val, unsigned int unicode);
+  void ApplyMoveEvent(int x, int y);
+  void ApplyWheelEvent(int z);
+
+  void AddRecordEvent(RecordEventType type, int input, int value, int value2);
+  /// Apply the recorded events of the current logic frame.
+  void ReplayEvents();
+
  public:
   DEV_InputDevice();
   virtual ~DEV_InputDevice();
 
+  /// Save the user events, the record is written by WriteRecord.
+  void StartRecord();
+  /// Replace the user events by the events of a record file, return false if it can't be read.
+  bool StartReplay(const std::string &filepath);
+  bool WriteRecord(const std::string &filepath) const;
+  RecordMode GetRecordMode() const;
+
+  virtual void ClearInputs();
+  virtual void ReleaseMoveEvent();
+
   void ConvertKeyEvent(int incode, int val, unsigned int unicode);
   void ConvertButtonEvent(int incode, int val);
   void ConvertWindowEvent(int incode);
@@ -18,6 +18,8 @@
 
 #pragma once
 
+#include <unordered_map>
+
 #include "EXP_Value.h"
 
 class EXP_BaseListValue : public EXP_PropValue {
@@ -32,6 +34,20 @@ class EXP_BaseListValue : public EXP_PropValue {
   VectorType m_pValueArray;
   bool m_bReleaseContents;
 
+  /** Optional index from name to the first item of this name, rebuilt on demand after
+   * any change other than an append or after an item of any indexed list was renamed.
+   */
+  mutable std::unordered_map<std::string, EXP_Value *> m_nameIndex;
+  bool m_nameIndexEnabled;
+  mutable bool m_nameIndexDirty;
+  /// Value of m_nameGeneration when the index was built.
+  mutable unsigned int m_nameIndexGeneration;
+  /// Incremented when an item which can be in an indexed list is renamed.
+  static unsigned int m_nameGeneration;
+
+  void InvalidateNameIndex();
+  void UpdateNameIndex() const;
+
   void SetValue(int i, EXP_Value *val);
   EXP_Value *GetValue(int i);
   EXP_Value *FindValue(const std::string &name) const;
@@ -51,6 +67,11 @@ class EXP_BaseListValue : public EXP_PropValue {
 
   void SetReleaseOnDestruct(bool bReleaseContents);
 
+  /// Use a hashed index for name lookups, for big lists searched often by name.
+  void SetNameIndexEnabled(bool enabled);
+  /// Invalidate the name index of all the lists, must be called when an item is renamed.
+  static void NotifyNameChanged();
+
   void Remove(int i);
   void Resize(int num);
   void ReleaseAndRemoveAll();
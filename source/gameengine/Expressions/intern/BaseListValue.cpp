@@ -21,7 +21,13 @@
 
 #include "EXP_ListValue.h"
 
-EXP_BaseListValue::EXP_BaseListValue() : m_bReleaseContents(true)
+unsigned int EXP_BaseListValue::m_nameGeneration = 0;
+
+EXP_BaseListValue::EXP_BaseListValue()
+    : m_bReleaseContents(true),
+      m_nameIndexEnabled(false),
+      m_nameIndexDirty(true),
+      m_nameIndexGeneration(0)
 {
 }
 
@@ -34,9 +40,32 @@ EXP_BaseListValue::~EXP_BaseListValue()
   }
 }
 
+void EXP_BaseListValue::InvalidateNameIndex()
+{
+  m_nameIndexDirty = true;
+}
+
+void EXP_BaseListValue::UpdateNameIndex() const
+{
+  if (!m_nameIndexDirty && m_nameIndexGeneration == m_nameGeneration) {
+    return;
+  }
+
+  m_nameIndex.clear();
+  m_nameIndex.reserve(m_pValueArray.size());
+  // Keep the first item of each name to match the linear search.
+  for (EXP_Value *item : m_pValueArray) {
+    m_nameIndex.emplace(item->GetName(), item);
+  }
+
+  m_nameIndexDirty = false;
+  m_nameIndexGeneration = m_nameGeneration;
+}
+
 void EXP_BaseListValue::SetValue(int i, EXP_Value *val)
 {
   m_pValueArray[i] = val;
+  InvalidateNameIndex();
 }
 
 EXP_Value *EXP_BaseListValue::GetValue(int i)
@@ -46,6 +75,12 @@ EXP_Value *EXP_BaseListValue::GetValue(int i)
 
 EXP_Value *EXP_BaseListValue::FindValue(const std::string &name) const
 {
+  if (m_nameIndexEnabled) {
+    UpdateNameIndex();
+    const auto it = m_nameIndex.find(name);
+    return (it != m_nameIndex.end()) ? it->second : nullptr;
+  }
+
   const VectorTypeConstIterator it = std::find_if(
       m_pValueArray.begin(), m_pValueArray.end(), [&name](EXP_Value *item) {
         return item->GetName() == name;
@@ -65,15 +100,31 @@ bool EXP_BaseListValue::SearchValue(EXP_Value *val) const
 void EXP_BaseListValue::Add(EXP_Value *value)
 {
   m_pValueArray.push_back(value);
+  // An appended item is only indexed if it's the first of its name.
+  if (m_nameIndexEnabled && !m_nameIndexDirty) {
+    m_nameIndex.emplace(value->GetName(), value);
+  }
 }
 
 void EXP_BaseListValue::Insert(unsigned int i, EXP_Value *value)
 {
   m_pValueArray.insert(m_pValueArray.begin() + i, value);
+  InvalidateNameIndex();
 }
 
 bool EXP_BaseListValue::RemoveValue(EXP_Value *val)
 {
+  /* The value could be already freed, so its name can't be used. Only the removal of an
+   * indexed item invalidates the index as another item of the same name could follow. */
+  if (m_nameIndexEnabled && !m_nameIndexDirty) {
+    for (const auto &pair : m_nameIndex) {
+      if (pair.second == val) {
+        InvalidateNameIndex();
+        break;
+      }
+    }
+  }
+
   bool result = false;
   for (VectorTypeIterator it = m_pValueArray.begin(); it != m_pValueArray.end();) {
     if (*it == val) {
@@ -127,14 +178,28 @@ void EXP_BaseListValue::SetReleaseOnDestruct(bool bReleaseContents)
   m_bReleaseContents = bReleaseContents;
 }
 
+void EXP_BaseListValue::SetNameIndexEnabled(bool enabled)
+{
+  m_nameIndexEnabled = enabled;
+  m_nameIndex.clear();
+  InvalidateNameIndex();
+}
+
+void EXP_BaseListValue::NotifyNameChanged()
+{
+  ++m_nameGeneration;
+}
+
 void EXP_BaseListValue::Remove(int i)
 {
   m_pValueArray.erase(m_pValueArray.begin() + i);
+  InvalidateNameIndex();
 }
 
 void EXP_BaseListValue::Resize(int num)
 {
   m_pValueArray.resize(num);
+  InvalidateNameIndex();
 }
 
 void EXP_BaseListValue::ReleaseAndRemoveAll()
@@ -143,6 +208,7 @@ void EXP_BaseListValue::ReleaseAndRemoveAll()
     item->Release();
   }
   m_pValueArray.clear();
+  InvalidateNameIndex();
 }
 
 int EXP_BaseListValue::GetCount() const
@@ -470,6 +536,7 @@ PyObject *EXP_BaseListValue::Pyreverse()
   }
 
   std::reverse(m_pValueArray.begin(), m_pValueArray.end());
+  InvalidateNameIndex();
   Py_RETURN_NONE;
 }
 
@@ -36,7 +36,12 @@
 
 SG_QList SCA_IObject::m_activeBookmarkedControllers;
 
-SCA_IObject::SCA_IObject() : m_suspended(false), m_initState(0), m_state(0), m_firstState(nullptr)
+SCA_IObject::SCA_IObject()
+    : m_suspended(false),
+      m_controllersSuspended(false),
+      m_initState(0),
+      m_state(0),
+      m_firstState(nullptr)
 {
 }
 
@@ -256,6 +261,26 @@ void SCA_IObject::ResumeSensors(void)
   }
 }
 
+void SCA_IObject::SuspendControllers()
+{
+  if (!m_controllersSuspended) {
+    m_controllersSuspended = true;
+    for (SCA_IController *controller : m_controllers) {
+      controller->ApplyState(0);
+    }
+  }
+}
+
+void SCA_IObject::ResumeControllers()
+{
+  if (m_controllersSuspended) {
+    m_controllersSuspended = false;
+    for (SCA_IController *controller : m_controllers) {
+      controller->ApplyState(m_state);
+    }
+  }
+}
+
 void SCA_IObject::SetInitState(unsigned int initState)
 {
   m_initState = initState;
@@ -274,6 +299,12 @@ void SCA_IObject::SetState(unsigned int state)
    * that are switching state: no need to deactive and reactive the sensor
    */
 
+  // The controllers are updated when resumed.
+  if (m_controllersSuspended) {
+    m_state = state;
+    return;
+  }
+
   const unsigned int tmpstate = m_state | state;
   if (tmpstate != m_state) {
     // Update the status of the controllers.
@@ -86,6 +86,9 @@ class SCA_IObject : public EXP_Value {
   /// Ignore updates?
   bool m_suspended;
 
+  /// Controllers deactivated independently of the state?
+  bool m_controllersSuspended;
+
   /// Init state of object (used when object is created).
   unsigned int m_initState;
 
@@ -136,6 +139,16 @@ class SCA_IObject : public EXP_Value {
   /// Resume progress.
   void ResumeSensors(void);
 
+  /**
+   * Deactivate all the controllers as if no state was active, unregistering
+   * their sensors from the event managers. The object state is kept and
+   * applied again by ResumeControllers.
+   */
+  void SuspendControllers();
+
+  /// Reactivate the controllers of the current state.
+  void ResumeControllers();
+
   /// Set init state.
   void SetInitState(unsigned int initState);
 
@@ -86,8 +86,9 @@ void SCA_LogicManager::UnregisterGameObj(void *blendobj, EXP_Value *gameobj)
 
 EXP_Value *SCA_LogicManager::GetGameObjectByName(const std::string &gameobjname)
 {
-  std::string mn = gameobjname;
-  return m_mapStringToGameObjects[mn];
+  // Don't use operator[] which would insert an entry for every missing name.
+  const auto it = m_mapStringToGameObjects.find(gameobjname);
+  return (it != m_mapStringToGameObjects.end()) ? it->second : nullptr;
 }
 
 EXP_Value *SCA_LogicManager::FindGameObjByBlendObj(void *blendobj)
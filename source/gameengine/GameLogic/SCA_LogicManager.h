@@ -37,6 +37,7 @@
 #include <list>
 #include <map>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "EXP_Value.h"
@@ -74,7 +75,7 @@ class SCA_LogicManager {
 
   // need to find better way for this
   // also known as FactoryManager...
-  std::map<std::string, EXP_Value *> m_mapStringToGameObjects;
+  std::unordered_map<std::string, EXP_Value *> m_mapStringToGameObjects;
   std::map<std::string, void *> m_mapStringToMeshes;
   std::map<std::string, void *> m_mapStringToActions;
 
@@ -32,6 +32,7 @@
 
 #include "EXP_ListWrapper.h"
 #include "KX_Globals.h"
+#include "KX_NavMeshCrowd.h"
 #include "KX_NavMeshObject.h"
 #include "KX_ObstacleSimulation.h"
 #include "KX_PyMath.h"
@@ -55,7 +56,8 @@ SCA_SteeringActuator::SCA_SteeringActuator(SCA_IObject *gameobj,
                                            short facingmode,
                                            bool normalup,
                                            bool enableVisualization,
-                                           bool lockzvel)
+                                           bool lockzvel,
+                                           bool crowd)
     : SCA_IActuator(gameobj, KX_ACT_STEERING),
       m_target(target),
       m_mode(mode),
@@ -65,6 +67,7 @@ SCA_SteeringActuator::SCA_SteeringActuator(SCA_IObject *gameobj,
       m_turnspeed(turnspeed),
       m_simulation(simulation),
       m_updateTime(0),
+      m_steerDelta(0.0),
       m_obstacle(nullptr),
       m_isActive(false),
       m_isSelfTerminated(isSelfTerminated),
@@ -74,6 +77,8 @@ SCA_SteeringActuator::SCA_SteeringActuator(SCA_IObject *gameobj,
       m_pathLen(0),
       m_pathUpdatePeriod(pathUpdatePeriod),
       m_lockzvel(lockzvel),
+      m_crowd(crowd),
+      m_crowdAgent(-1),
       m_wayPointIdx(-1),
       m_steerVec(MT_Vector3(0, 0, 0))
 {
@@ -95,6 +100,7 @@ SCA_SteeringActuator::SCA_SteeringActuator(SCA_IObject *gameobj,
 
 SCA_SteeringActuator::~SCA_SteeringActuator()
 {
+  ReleaseCrowdAgent();
   if (m_navmesh)
     m_navmesh->UnregisterActuator(this);
   if (m_target)
@@ -111,6 +117,8 @@ EXP_Value *SCA_SteeringActuator::GetReplica()
 
 void SCA_SteeringActuator::ProcessReplica()
 {
+  // The agent belongs to the original actuator.
+  m_crowdAgent = -1;
   if (m_target)
     m_target->RegisterActuator(this);
   if (m_navmesh)
@@ -132,6 +140,8 @@ bool SCA_SteeringActuator::UnlinkObject(SCA_IObject *clientobj)
     return true;
   }
   else if (clientobj == m_navmesh) {
+    // The crowd is freed with the navigation mesh.
+    m_crowdAgent = -1;
     m_navmesh = nullptr;
     return true;
   }
@@ -150,6 +160,7 @@ void SCA_SteeringActuator::Relink(std::map<SCA_IObject *, SCA_IObject *> &obj_ma
 
   KX_NavMeshObject *navobj = static_cast<KX_NavMeshObject *>(obj_map[m_navmesh]);
   if (navobj) {
+    ReleaseCrowdAgent();
     if (m_navmesh)
       m_navmesh->UnregisterActuator(this);
     m_navmesh = navobj;
@@ -213,13 +224,31 @@ bool SCA_SteeringActuator::Update(double curtime)
 
         static const MT_Scalar WAYPOINT_RADIUS(0.25f);
 
-        if (m_pathUpdateTime < 0 ||
-            (m_pathUpdatePeriod >= 0 &&
-             curtime - m_pathUpdateTime > ((double)m_pathUpdatePeriod / 1000.0))) {
+        const bool updatePath = (m_pathUpdateTime < 0 ||
+                                 (m_pathUpdatePeriod >= 0 &&
+                                  curtime - m_pathUpdateTime >
+                                      ((double)m_pathUpdatePeriod / 1000.0)));
+        if (updatePath) {
           m_pathUpdateTime = curtime;
-          m_pathLen = m_navmesh->FindPath(mypos, targpos, m_path, MAX_PATH_LENGTH);
+        }
+
+        if (m_crowd) {
+          if (m_crowdAgent == -1) {
+            m_crowdAgent = m_navmesh->GetCrowd()->AddAgent();
+          }
+          /* The crowd keeps the path corridor and extracts the path from the current
+           * position every frame, the path update period only forces a new search. */
+          m_pathLen = m_navmesh->FindCrowdPath(
+              m_crowdAgent, mypos, targpos, updatePath, curtime, m_path, MAX_PATH_LENGTH);
           m_wayPointIdx = m_pathLen > 1 ? 1 : -1;
         }
+        else {
+          ReleaseCrowdAgent();
+          if (updatePath) {
+            m_pathLen = m_navmesh->FindPath(mypos, targpos, m_path, MAX_PATH_LENGTH);
+            m_wayPointIdx = m_pathLen > 1 ? 1 : -1;
+          }
+        }
 
         if (m_wayPointIdx > 0) {
           MT_Vector3 waypoint(&m_path[3 * m_wayPointIdx]);
@@ -254,36 +283,22 @@ bool SCA_SteeringActuator::Update(double curtime)
       m_steerVec.normalize();
     MT_Vector3 newvel = m_velocity * m_steerVec;
 
-    // adjust velocity to avoid obstacles
+    // adjust velocity to avoid obstacles, the agents are adjusted together after all the
+    // actuators update, see ApplyObstacleVelocity
     if (m_simulation && m_obstacle /*&& !newvel.fuzzyZero()*/) {
       if (m_enableVisualization)
         KX_RasterizerDrawDebugLine(mypos, mypos + newvel, MT_Vector4(1.0f, 0.0f, 0.0f, 1.0f));
-      m_simulation->AdjustObstacleVelocity(m_obstacle,
-                                           m_mode != KX_STEERING_PATHFOLLOWING ? m_navmesh :
-                                                                                 nullptr,
-                                           newvel,
-                                           m_acceleration * (float)delta,
-                                           m_turnspeed / (180.0f * (float)(M_PI * delta)));
-      if (m_enableVisualization)
-        KX_RasterizerDrawDebugLine(mypos, mypos + newvel, MT_Vector4(0.0f, 1.0f, 0.0f, 1.0f));
-    }
-
-    HandleActorFace(newvel);
-    if (isdyna) {
-      // temporary solution: set 2D steering velocity directly to obj
-      // correct way is to apply physical force
-      MT_Vector3 curvel = obj->GetLinearVelocity();
-
-      if (m_lockzvel)
-        newvel.z() = 0.0f;
-      else
-        newvel.z() = curvel.z();
-
-      obj->setLinearVelocity(newvel, false);
+      m_steerDelta = delta;
+      m_simulation->QueueObstacleVelocity(m_obstacle,
+                                          m_mode != KX_STEERING_PATHFOLLOWING ? m_navmesh :
+                                                                                nullptr,
+                                          newvel,
+                                          m_acceleration * (float)delta,
+                                          m_turnspeed / (180.0f * (float)(M_PI * delta)),
+                                          this);
     }
     else {
-      MT_Vector3 movement = delta * newvel;
-      obj->ApplyMovement(movement, false);
+      ApplySteeringVelocity(newvel, delta);
     }
   }
   else {
@@ -299,6 +314,47 @@ bool SCA_SteeringActuator::Update(double curtime)
   return true;
 }
 
+void SCA_SteeringActuator::ReleaseCrowdAgent()
+{
+  if (m_navmesh && m_crowdAgent != -1) {
+    m_navmesh->GetCrowd()->RemoveAgent(m_crowdAgent);
+  }
+  m_crowdAgent = -1;
+}
+
+void SCA_SteeringActuator::ApplyObstacleVelocity(MT_Vector3 &velocity)
+{
+  if (m_enableVisualization) {
+    const MT_Vector3 &mypos = ((KX_GameObject *)GetParent())->NodeGetWorldPosition();
+    KX_RasterizerDrawDebugLine(mypos, mypos + velocity, MT_Vector4(0.0f, 1.0f, 0.0f, 1.0f));
+  }
+
+  ApplySteeringVelocity(velocity, m_steerDelta);
+}
+
+void SCA_SteeringActuator::ApplySteeringVelocity(MT_Vector3 &velocity, double delta)
+{
+  KX_GameObject *obj = (KX_GameObject *)GetParent();
+
+  HandleActorFace(velocity);
+  if (obj->IsDynamic()) {
+    // temporary solution: set 2D steering velocity directly to obj
+    // correct way is to apply physical force
+    MT_Vector3 curvel = obj->GetLinearVelocity();
+
+    if (m_lockzvel)
+      velocity.z() = 0.0f;
+    else
+      velocity.z() = curvel.z();
+
+    obj->setLinearVelocity(velocity, false);
+  }
+  else {
+    MT_Vector3 movement = delta * velocity;
+    obj->ApplyMovement(movement, false);
+  }
+}
+
 const MT_Vector3 &SCA_SteeringActuator::GetSteeringVec()
 {
   static MT_Vector3 ZERO_VECTOR(0, 0, 0);
@@ -340,28 +396,30 @@ inline void flipAxes(float *vec)
   std::swap(vec[1], vec[2]);
 }
 
-static bool getNavmeshNormal(dtStatNavMesh *navmesh, const MT_Vector3 &pos, MT_Vector3 &normal)
+static bool getNavmeshNormal(dtTiledNavMesh *navmesh, const MT_Vector3 &pos, MT_Vector3 &normal)
 {
   static const float polyPickExt[3] = {2, 4, 2};
   float spos[3];
   pos.getValue(spos);
   flipAxes(spos);
-  dtStatPolyRef sPolyRef = navmesh->findNearestPoly(spos, polyPickExt);
-  if (sPolyRef == 0)
+  dtTilePolyRef sPolyRef = navmesh->findNearestPoly(spos, polyPickExt);
+  int polyIndex;
+  const dtTileHeader *header = KX_NavMeshTileGrid::GetPolyTile(navmesh, sPolyRef, polyIndex);
+  if (!header)
     return false;
-  const dtStatPoly *p = navmesh->getPoly(sPolyRef - 1);
-  const dtStatPolyDetail *pd = navmesh->getPolyDetail(sPolyRef - 1);
+  const dtTilePoly *p = &header->polys[polyIndex];
+  const dtTilePolyDetail *pd = &header->dmeshes[polyIndex];
 
   float distMin = FLT_MAX;
   int idxMin = -1;
   for (int i = 0; i < pd->ntris; ++i) {
-    const unsigned char *t = navmesh->getDetailTri(pd->tbase + i);
+    const unsigned char *t = &header->dtris[(pd->tbase + i) * 4];
     const float *v[3];
     for (int j = 0; j < 3; ++j) {
       if (t[j] < p->nv)
-        v[j] = navmesh->getVertex(p->v[t[j]]);
+        v[j] = &header->verts[p->v[t[j]] * 3];
       else
-        v[j] = navmesh->getDetailVertex(pd->vbase + (t[j] - p->nv));
+        v[j] = &header->dverts[(pd->vbase + (t[j] - p->nv)) * 3];
     }
     float dist = barDistSqPointToTri(spos, v[0], v[1], v[2]);
     if (dist < distMin) {
@@ -371,13 +429,13 @@ static bool getNavmeshNormal(dtStatNavMesh *navmesh, const MT_Vector3 &pos, MT_V
   }
 
   if (idxMin >= 0) {
-    const unsigned char *t = navmesh->getDetailTri(pd->tbase + idxMin);
+    const unsigned char *t = &header->dtris[(pd->tbase + idxMin) * 4];
     const float *v[3];
     for (int j = 0; j < 3; ++j) {
       if (t[j] < p->nv)
-        v[j] = navmesh->getVertex(p->v[t[j]]);
+        v[j] = &header->verts[p->v[t[j]] * 3];
       else
-        v[j] = navmesh->getDetailVertex(pd->vbase + (t[j] - p->nv));
+        v[j] = &header->dverts[(pd->vbase + (t[j] - p->nv)) * 3];
     }
     MT_Vector3 tri[3];
     for (size_t j = 0; j < 3; j++)
@@ -406,7 +464,7 @@ void SCA_SteeringActuator::HandleActorFace(MT_Vector3 &velocity)
   MT_Matrix3x3 mat;
 
   if (m_navmesh && m_normalUp) {
-    dtStatNavMesh *navmesh = m_navmesh->GetNavMesh();
+    dtTiledNavMesh *navmesh = m_navmesh->GetNavMesh();
     MT_Vector3 normal;
     MT_Vector3 trpos = m_navmesh->TransformToLocalCoords(curobj->NodeGetWorldPosition());
     if (getNavmeshNormal(navmesh, trpos, normal)) {
@@ -551,6 +609,7 @@ PyAttributeDef SCA_SteeringActuator::Attributes[] = {
     EXP_PYATTRIBUTE_INT_RW(
         "pathUpdatePeriod", -1, 100000, true, SCA_SteeringActuator, m_pathUpdatePeriod),
     EXP_PYATTRIBUTE_BOOL_RW("lockZVelocity", SCA_SteeringActuator, m_lockzvel),
+    EXP_PYATTRIBUTE_BOOL_RW("crowd", SCA_SteeringActuator, m_crowd),
     EXP_PYATTRIBUTE_RO_FUNCTION("path", SCA_SteeringActuator, pyattr_get_path),
     EXP_PYATTRIBUTE_NULL  // Sentinel
 };
@@ -619,6 +678,7 @@ int SCA_SteeringActuator::pyattr_set_navmesh(EXP_PyObjectPlus *self,
     return PY_SET_ATTR_FAIL;
   }
 
+  actuator->ReleaseCrowdAgent();
   if (actuator->m_navmesh != nullptr)
     actuator->m_navmesh->UnregisterActuator(actuator);
 
@@ -50,6 +50,8 @@ class SCA_SteeringActuator : public SCA_IActuator {
   KX_ObstacleSimulation *m_simulation;
 
   double m_updateTime;
+  /// Time step of the steering velocity queued for obstacle avoidance.
+  double m_steerDelta;
   KX_Obstacle *m_obstacle;
   bool m_isActive;
   bool m_isSelfTerminated;
@@ -61,10 +63,18 @@ class SCA_SteeringActuator : public SCA_IActuator {
   int m_pathUpdatePeriod;
   double m_pathUpdateTime;
   bool m_lockzvel;
+  /// Follow the path as an agent of the navigation mesh crowd.
+  bool m_crowd;
+  /// Index of the crowd agent, -1 when not added to the crowd.
+  int m_crowdAgent;
   int m_wayPointIdx;
   MT_Matrix3x3 m_parentlocalmat;
   MT_Vector3 m_steerVec;
   void HandleActorFace(MT_Vector3 &velocity);
+  /// Remove the agent from the crowd of the current navigation mesh.
+  void ReleaseCrowdAgent();
+  /// Face and move the object with the steering velocity.
+  void ApplySteeringVelocity(MT_Vector3 &velocity, double delta);
 
  public:
   enum KX_STEERINGACT_MODE {
@@ -89,7 +99,8 @@ class SCA_SteeringActuator : public SCA_IActuator {
                        short facingmode,
                        bool normalup,
                        bool enableVisualization,
-                       bool lockzvel);
+                       bool lockzvel,
+                       bool crowd);
   virtual ~SCA_SteeringActuator();
   virtual bool Update(double curtime);
 
@@ -99,6 +110,8 @@ class SCA_SteeringActuator : public SCA_IActuator {
   virtual void Relink(std::map<SCA_IObject *, SCA_IObject *> &obj_map);
   virtual bool UnlinkObject(SCA_IObject *clientobj);
   const MT_Vector3 &GetSteeringVec();
+  /// Apply the steering velocity adjusted by the obstacle simulation.
+  void ApplyObstacleVelocity(MT_Vector3 &velocity);
 
 #ifdef WITH_PYTHON
 
@@ -39,6 +39,7 @@
 #include "GPU_framebuffer.h"
 #include "MEM_guardedalloc.h"
 
+#include "CM_Message.h"
 #include "KX_Globals.h"
 
 GPG_Canvas::GPG_Canvas(RAS_Rasterizer *rasty, GHOST_IWindow *window)
@@ -80,6 +81,12 @@ void GPG_Canvas::Resize(int width, int height)
 
 void GPG_Canvas::MakeScreenShot(const std::string &filename)
 {
+  // Nothing is rendered without window.
+  if (!m_window) {
+    CM_Warning("no screenshot in headless mode: " << filename);
+    return;
+  }
+
   // copy image data
   unsigned int dumpsx = GetWidth();
   unsigned int dumpsy = GetHeight();
@@ -170,6 +177,12 @@ void GPG_Canvas::GetDisplayDimensions(int &width, int &height)
   unsigned int uiheight;
 
   GHOST_ISystem *system = GHOST_ISystem::getSystem();
+  if (!system) {
+    width = GetWidth();
+    height = GetHeight();
+    return;
+  }
+
   system->getMainDisplayDimensions(uiwidth, uiheight);
 
   width = uiwidth;
@@ -178,6 +191,11 @@ void GPG_Canvas::GetDisplayDimensions(int &width, int &height)
 
 void GPG_Canvas::ResizeWindow(int width, int height)
 {
+  if (!m_window) {
+    Resize(width, height);
+    return;
+  }
+
   if (m_window->getState() == GHOST_kWindowStateFullScreen) {
     GHOST_ISystem *system = GHOST_ISystem::getSystem();
     GHOST_DisplaySetting setting;
@@ -197,6 +215,10 @@ void GPG_Canvas::ResizeWindow(int width, int height)
 
 void GPG_Canvas::SetFullScreen(bool enable)
 {
+  if (!m_window) {
+    return;
+  }
+
   if (enable) {
     m_window->setState(GHOST_kWindowStateFullScreen);
   }
@@ -207,7 +229,7 @@ void GPG_Canvas::SetFullScreen(bool enable)
 
 bool GPG_Canvas::GetFullScreen()
 {
-  return (m_window->getState() == GHOST_kWindowStateFullScreen);
+  return (m_window && m_window->getState() == GHOST_kWindowStateFullScreen);
 }
 
 void GPG_Canvas::ConvertMousePosition(int x, int y, int &r_x, int &r_y, bool UNUSED(screen))
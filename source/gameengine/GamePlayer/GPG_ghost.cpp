@@ -124,6 +124,7 @@
 #include "wm_window.h"
 
 #include "CM_Message.h"
+#include "CM_Profiler.h"
 #include "KX_Globals.h"
 #include "KX_PythonInit.h"
 #include "LA_PlayerLauncher.h"
@@ -505,6 +506,9 @@ static void usage(const std::string &program, bool isBlenderPlayer)
   CM_Message("  -m: maximum anti-aliasing (eg. 2,4,8,16)" << std::endl);
   CM_Message("  -n: maximum anisotropic filtering (eg. 2,4,8,16)" << std::endl);
   CM_Message("  -i: parent window's ID" << std::endl);
+  CM_Message("  -b: run the game headless, without window, GPU context and render");
+  CM_Message("       The logic, physics and python run at the scene logic rate, or as fast as");
+  CM_Message("       possible with -g fixedtime = 1" << std::endl);
 #ifdef _WIN32
   CM_Message("  -c: keep console window open" << std::endl);
 #endif
@@ -524,9 +528,20 @@ static void usage(const std::string &program, bool isBlenderPlayer)
   CM_Message("       show_camera_frustum            0         Show debug camera frustum volume");
   CM_Message(
       "       show_shadow_frustum            0         Show debug light shadow frustum volume");
+  CM_Message("       frame_pacing                   1         Sleep until the next frame");
+  CM_Message("       adaptive_logic_frames          0         Limit logic frames to the load");
+  CM_Message("       max_dropped_renders            0         Renders skipped to catch up logic");
+  CM_Message("       render_pipelining              0         Run physics during the render");
+  CM_Message("       fixed_timestep                 0         One tic rate step per frame");
+  CM_Message("       frame_limit                    0         Quit after N logic frames");
+  CM_Message("       frame_timings                            Per frame times (.csv/.json)");
+  CM_Message("       record_input                             Record the input to a file");
+  CM_Message("       replay_input                             Replay a recorded input file");
   CM_Message("       ignore_deprecation_warnings    1         Ignore deprecation warnings"
              << std::endl);
   CM_Message("  -p: override python main loop script");
+  CM_Message("  -t: write the engine profiler zones in a Chrome trace file at exit");
+  CM_Message("       Example: -t trace.json  (open in chrome://tracing or Perfetto)");
   CM_Message(std::endl);
   CM_Message(
       "  - : all arguments after this are ignored, allowing python to access them from sys.argv");
@@ -768,6 +783,8 @@ int main(int argc,
   int validArguments = 0;
   bool samplesParFound = false;
   std::string pythonControllerFile;
+  std::string profileTraceFile;
+  bool headless = false;
   uint16_t aasamples = 0;
   int alphaBackground = 0;
 
@@ -1342,6 +1359,25 @@ int main(int argc,
           pythonControllerFile = argv[i++];
           break;
         }
+        case 'b':  // headless mode
+        {
+          ++i;
+          headless = true;
+          break;
+        }
+        case 't':  // profiler trace file
+        {
+          ++i;
+          if ((i + 1) <= validArguments) {
+            profileTraceFile = argv[i++];
+            CM_Profiler::SetEnabled(true);
+          }
+          else {
+            error = true;
+            CM_Error("no argument supplied for -t");
+          }
+          break;
+        }
         default:  // not recognized
         {
           CM_Warning("unknown argument: " << argv[i++]);
@@ -1364,22 +1400,28 @@ int main(int argc,
     return 0;
   }
   GHOST_ISystem *system = nullptr;
+  if (headless) {
+    // Avoid any GPU resource creation in Blender code too.
+    G.background = true;
+  }
 #ifdef WIN32
   if (scr_saver_mode != SCREEN_SAVER_MODE_CONFIGURATION)
 #endif
   {
-    // Create the system
-    if (GHOST_ISystem::createSystem() == GHOST_kSuccess) {
-      system = GHOST_ISystem::getSystem();
-      BLI_assert(system);
-
-      if (!fullScreenWidth || !fullScreenHeight)
-        system->getMainDisplayDimensions(fullScreenWidth, fullScreenHeight);
-      // process first batch of events. If the user
-      // drops a file on top off the blenderplayer icon, we
-      // receive an event with the filename
-
-      system->processEvents(0);
+    // Create the system, the headless mode doesn't need any window or display.
+    if (headless || GHOST_ISystem::createSystem() == GHOST_kSuccess) {
+      if (!headless) {
+        system = GHOST_ISystem::getSystem();
+        BLI_assert(system);
+
+        if (!fullScreenWidth || !fullScreenHeight)
+          system->getMainDisplayDimensions(fullScreenWidth, fullScreenHeight);
+        // process first batch of events. If the user
+        // drops a file on top off the blenderplayer icon, we
+        // receive an event with the filename
+
+        system->processEvents(0);
+      }
 
       // this bracket is needed for app (see below) to get out
       // of scope before GHOST_ISystem::disposeSystem() is called.
@@ -1498,7 +1540,7 @@ int main(int argc,
             /* Setting options according to the blend file if not overriden in the command line */
 #ifdef WIN32
 #  if !defined(DEBUG)
-            if (closeConsole) {
+            if (closeConsole && system) {
               system->toggleConsole(0);  // Close a console window
             }
 #  endif  // !defined(DEBUG)
@@ -1583,7 +1625,10 @@ int main(int argc,
             if (firstTimeRunning) {
               firstTimeRunning = false;
 
-              if (fullScreen) {
+              if (headless) {
+                // The game runs without window.
+              }
+              else if (fullScreen) {
 #ifdef WIN32
                 if (scr_saver_mode == SCREEN_SAVER_MODE_SAVER) {
                   window = startScreenSaverFullScreen(system,
@@ -1674,19 +1719,25 @@ int main(int argc,
             CTX_wm_manager_set(C, wm);
             CTX_wm_window_set(C, win);
             InitBlenderContextVariables(C, wm, bfd->curscene);
-            wm_window_ghostwindow_blenderplayer_ensure(wm, win, window, first_time_window);
+            if (!headless) {
+              wm_window_ghostwindow_blenderplayer_ensure(wm, win, window, first_time_window);
 
-            /* The following is needed to run some bpy operators in blenderplayer */
-            ED_screen_refresh_blenderplayer(win);
+              /* The following is needed to run some bpy operators in blenderplayer */
+              ED_screen_refresh_blenderplayer(win);
+            }
 
             if (first_time_window) {
-              /* We need to have first an ogl context bound and it's done
-               * in wm_window_ghostwindow_blenderplayer_ensure.
-               */
-              WM_init_opengl_blenderplayer(G_MAIN, system, win);
+              if (!headless) {
+                /* We need to have first an ogl context bound and it's done
+                 * in wm_window_ghostwindow_blenderplayer_ensure.
+                 */
+                WM_init_opengl_blenderplayer(G_MAIN, system, win);
+              }
 
               UI_theme_init_default();
-              UI_init();
+              if (!headless) {
+                UI_init();
+              }
 
               /* Set Viewport render mode and shading type for the whole runtime */
               useViewportRender = scene->gm.flag & GAME_USE_VIEWPORT_RENDER;
@@ -1741,6 +1792,13 @@ int main(int argc,
             ED_screen_exit(C, win, WM_window_get_active_screen(win));
           }
         } while (!quitGame(exitcode));
+
+        if (!profileTraceFile.empty()) {
+          CM_Profiler::SetEnabled(false);
+          if (CM_Profiler::ExportChromeTrace(profileTraceFile)) {
+            CM_Message("profiler trace written to \"" << profileTraceFile << "\"");
+          }
+        }
 #ifdef WITH_PYTHON
         // Free globalDict OUTSIDE runtime loop.
         if (globalDict) {
@@ -1838,18 +1896,22 @@ int main(int argc,
 
   BLF_exit();
 
-  DRW_opengl_context_enable_ex(false);
-  GPU_pass_cache_free();
-  GPU_exit();
-  DRW_opengl_context_disable_ex(false);
-  DRW_opengl_context_destroy();
+  if (!headless) {
+    DRW_opengl_context_enable_ex(false);
+    GPU_pass_cache_free();
+    GPU_exit();
+    DRW_opengl_context_disable_ex(false);
+    DRW_opengl_context_destroy();
+  }
 
   if (window) {
     system->disposeWindow(window);
   }
 
   // Dispose the system
-  GHOST_ISystem::disposeSystem();
+  if (system) {
+    GHOST_ISystem::disposeSystem();
+  }
 
 #ifdef WITH_INTERNATIONAL
   BLT_lang_free();
@@ -1863,14 +1925,18 @@ int main(int argc,
 
   ED_file_exit(); /* for fsmenu */
 
-  UI_exit();
+  if (!headless) {
+    UI_exit();
+  }
   BKE_blender_userdef_data_free(&U, false);
 
   RNA_exit(); /* should be after BPY_python_end so struct python slots are cleared */
 
   SYS_DeleteSystem(syshandle);
 
-  GPU_backend_exit();
+  if (!headless) {
+    GPU_backend_exit();
+  }
 
   wm_ghost_exit();
 
@@ -41,6 +41,7 @@
 #include "RNA_access.h"
 
 #include "BL_ArmatureObject.h"
+#include "BL_BlenderConverter.h"
 #include "BL_IpoConvert.h"
 #include "CM_Message.h"
 
@@ -49,6 +50,7 @@ BL_Action::BL_Action(class KX_GameObject *gameobj)
       m_blendpose(nullptr),
       m_blendinpose(nullptr),
       m_obj(gameobj),
+      m_clip(nullptr),
       m_startframe(0.f),
       m_endframe(0.f),
       m_localframe(0.f),
@@ -63,6 +65,7 @@ BL_Action::BL_Action(class KX_GameObject *gameobj)
       m_done(true),
       m_appliedToObject(true),
       m_calc_localtime(true),
+      m_requestApply(false),
       m_prevUpdate(-1.0f)
 {
   bContext *C = KX_GetActiveEngine()->GetContext();
@@ -195,9 +198,24 @@ bool BL_Action::Play(const std::string &name,
   // Setup blendin shapes/poses
   if (m_obj->GetGameObjectType() == SCA_IObject::OBJ_ARMATURE) {
     BL_ArmatureObject *obj = (BL_ArmatureObject *)m_obj;
-    obj->GetPose(&m_blendinpose);
+    m_clip = KX_GetActiveEngine()->GetConverter()->FindActionClip(kxscene, m_action);
+    if (m_clip) {
+      m_clip->Bind(obj->GetPose(), m_clipChannels);
+      obj->GetBoneRotationModes(m_rotModes);
+      obj->GetBoneTransforms(m_blendinTransforms);
+      obj->GetConstraintInfluences(m_blendinInfluences);
+    }
+    else {
+      obj->GetPose(&m_blendinpose);
+      /* Allocate the layer blending pose here as the pose copy is not thread safe,
+       * UpdatePose only extracts the pose channels into it. */
+      if (layer_weight >= 0 && !m_blendpose) {
+        obj->GetPose(&m_blendpose);
+      }
+    }
   }
   else {
+    m_clip = nullptr;
   }
 
   // Now that we have an action, we have something we can play
@@ -214,6 +232,7 @@ bool BL_Action::Play(const std::string &name,
 
   m_done = false;
   m_appliedToObject = false;
+  m_requestApply = false;
 
   m_prevUpdate = -1.0f;
 
@@ -257,6 +276,46 @@ const std::string BL_Action::GetName()
   }
 }
 
+float BL_Action::GetStartFrame() const
+{
+  return m_startframe;
+}
+
+float BL_Action::GetEndFrame() const
+{
+  return m_endframe;
+}
+
+short BL_Action::GetPriority() const
+{
+  return m_priority;
+}
+
+short BL_Action::GetPlayMode() const
+{
+  return m_playmode;
+}
+
+float BL_Action::GetLayerWeight() const
+{
+  return m_layer_weight;
+}
+
+short BL_Action::GetIpoFlags() const
+{
+  return m_ipo_flags;
+}
+
+float BL_Action::GetSpeed() const
+{
+  return m_speed;
+}
+
+short BL_Action::GetBlendMode() const
+{
+  return m_blendmode;
+}
+
 void BL_Action::SetFrame(float frame)
 {
   // Clamp the frame to the start and end frame
@@ -364,6 +423,12 @@ static bool ActionMatchesName(bAction *action, char *name, eActionType type)
 }
 
 void BL_Action::Update(float curtime, bool applyToObject)
+{
+  UpdatePose(curtime, applyToObject);
+  ApplyToScene(curtime);
+}
+
+void BL_Action::UpdatePose(float curtime, bool applyToObject)
 {
   /* Don't bother if we're done with the animation and if the animation was already applied to the
    * object. of if the animation made a double update for the same time and that it was applied to
@@ -374,8 +439,6 @@ void BL_Action::Update(float curtime, bool applyToObject)
   }
   m_prevUpdate = curtime;
 
-  KX_Scene *scene = m_obj->GetScene();
-
   if (m_calc_localtime)
     SetLocalTime(curtime);
   else {
@@ -420,27 +483,57 @@ void BL_Action::Update(float curtime, bool applyToObject)
     return;
   }
 
-  // Update controllers time. The controllers list is cleared when action is done
-  for (SG_Controller *cont : m_sg_contr_list) {
-    cont->SetSimulatedTime(m_localframe);  // update spatial controllers
-    cont->Update(m_localframe);
-  }
+  m_requestApply = true;
 
-  Object *ob = m_obj->GetBlenderObject();  // eevee
+  if (m_obj->GetGameObjectType() == SCA_IObject::OBJ_ARMATURE && m_clip) {
+    BL_ArmatureObject *obj = (BL_ArmatureObject *)m_obj;
 
-  /* Create an AnimationEvalContext based on the current local frame time (See comment in
-   * constructor) */
-  AnimationEvalContext animEvalContext = BKE_animsys_eval_context_construct_at(&m_animEvalCtx,
-                                                                               m_localframe);
+    const bool blendin = (m_blendin && m_blendframe < m_blendin);
+    // The constraint influences are not animated by the clip, they only change by blending.
+    const bool blendInfluences = (blendin || m_layer_weight >= 0);
 
-  if (m_obj->GetGameObjectType() == SCA_IObject::OBJ_ARMATURE) {
-    if (ob->gameflag & OB_OVERLAY_COLLECTION) {
-      scene->AppendToExtraObjectsToUpdateInOverlayPass(ob, ID_RECALC_TRANSFORM);
+    // Sample the baked clip over the current bone transforms, without any channel lookup.
+    obj->GetBoneTransforms(m_transforms);
+    if (blendInfluences) {
+      obj->GetConstraintInfluences(m_influences);
     }
-    else {
-      scene->AppendToExtraObjectsToUpdateInAllRenderPasses(ob, ID_RECALC_TRANSFORM);
+    if (m_layer_weight >= 0) {
+      m_blendTransforms = m_transforms;
+      m_blendInfluences = m_influences;
     }
 
+    m_clip->Evaluate(m_localframe, m_clipChannels, m_transforms);
+
+    // Handle blending between armature actions
+    if (blendin) {
+      IncrementBlending(curtime);
+
+      // Calculate weight
+      float weight = 1.f - (m_blendframe / m_blendin);
+
+      BL_BlendBoneTransforms(
+          m_transforms, m_blendinTransforms, m_rotModes, weight, ACT_BLEND_BLEND);
+      BL_BlendConstraintInfluences(m_influences, m_blendinInfluences, weight);
+    }
+
+    // Handle layer blending
+    if (m_layer_weight >= 0) {
+      BL_BlendBoneTransforms(
+          m_transforms, m_blendTransforms, m_rotModes, m_layer_weight, m_blendmode);
+      BL_BlendConstraintInfluences(m_influences, m_blendInfluences, m_layer_weight);
+    }
+
+    obj->SetBoneTransforms(m_transforms);
+    if (blendInfluences) {
+      obj->SetConstraintInfluences(m_influences);
+    }
+  }
+  else if (m_obj->GetGameObjectType() == SCA_IObject::OBJ_ARMATURE) {
+    /* Create an AnimationEvalContext based on the current local frame time (See comment in
+     * constructor) */
+    AnimationEvalContext animEvalContext = BKE_animsys_eval_context_construct_at(&m_animEvalCtx,
+                                                                                 m_localframe);
+
     BL_ArmatureObject *obj = (BL_ArmatureObject *)m_obj;
 
     if (m_layer_weight >= 0)
@@ -449,8 +542,6 @@ void BL_Action::Update(float curtime, bool applyToObject)
     // Extract the pose from the action
     obj->SetPoseByAction(m_action, &animEvalContext);
 
-    m_obj->ForceIgnoreParentTx();
-
     // Handle blending between armature actions
     if (m_blendin && m_blendframe < m_blendin) {
       IncrementBlending(curtime);
@@ -465,10 +556,45 @@ void BL_Action::Update(float curtime, bool applyToObject)
     // Handle layer blending
     if (m_layer_weight >= 0)
       obj->BlendInPose(m_blendpose, m_layer_weight, m_blendmode);
+  }
+}
+
+void BL_Action::ApplyToScene(float curtime)
+{
+  if (!m_requestApply) {
+    return;
+  }
+  m_requestApply = false;
 
+  KX_Scene *scene = m_obj->GetScene();
+
+  // Update controllers time. The controllers list is cleared when action is done
+  for (SG_Controller *cont : m_sg_contr_list) {
+    cont->SetSimulatedTime(m_localframe);  // update spatial controllers
+    cont->Update(m_localframe);
+  }
+
+  Object *ob = m_obj->GetBlenderObject();  // eevee
+
+  if (m_obj->GetGameObjectType() == SCA_IObject::OBJ_ARMATURE) {
+    if (ob->gameflag & OB_OVERLAY_COLLECTION) {
+      scene->AppendToExtraObjectsToUpdateInOverlayPass(ob, ID_RECALC_TRANSFORM);
+    }
+    else {
+      scene->AppendToExtraObjectsToUpdateInAllRenderPasses(ob, ID_RECALC_TRANSFORM);
+    }
+
+    m_obj->ForceIgnoreParentTx();
+
+    BL_ArmatureObject *obj = (BL_ArmatureObject *)m_obj;
     obj->UpdateTimestep(curtime);
   }
   else {
+    /* Create an AnimationEvalContext based on the current local frame time (See comment in
+     * constructor) */
+    AnimationEvalContext animEvalContext = BKE_animsys_eval_context_construct_at(
+        &m_animEvalCtx, m_localframe);
+
     /* To skip some code if not needed */
     bool actionIsUpdated = false;
 
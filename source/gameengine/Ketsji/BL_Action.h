@@ -31,6 +31,8 @@
 
 #include "BKE_animsys.h"
 
+#include "BL_ActionClip.h"
+
 class BL_Action {
  private:
   struct bAction *m_action;
@@ -41,6 +43,20 @@ class BL_Action {
   std::vector<float> m_blendshape;
   std::vector<float> m_blendinshape;
 
+  /// Baked clip of the action played instead of the animation system, nullptr if not baked.
+  BL_ActionClip *m_clip;
+  /// Pose channel ordinal of every clip track.
+  std::vector<int> m_clipChannels;
+  /// Bone transforms used by the clip playback, indexed by pose channel ordinal.
+  std::vector<BL_BoneTransform> m_transforms;
+  std::vector<BL_BoneTransform> m_blendTransforms;
+  std::vector<BL_BoneTransform> m_blendinTransforms;
+  std::vector<short> m_rotModes;
+  /// Bone constraint influences blended with the bone transforms.
+  std::vector<float> m_influences;
+  std::vector<float> m_blendInfluences;
+  std::vector<float> m_blendinInfluences;
+
   AnimationEvalContext m_animEvalCtx;
 
   float m_startframe;
@@ -72,6 +88,9 @@ class BL_Action {
 
   bool m_calc_localtime;
 
+  /// Set by UpdatePose when ApplyToScene has to apply the action to the object.
+  bool m_requestApply;
+
   // The last update time to avoid double animation update.
   float m_prevUpdate;
 
@@ -105,15 +124,38 @@ class BL_Action {
   bool IsDone();
   /**
    * Update the action's frame, etc.
-   * \param curtime The current time used to compute the action's' frame.
+   * \param curtime The current time used to compute the action's frame.
    * \param applyToObject Set to true when the action must be applied to the object,
    * else it only manages action's' time/end.
    */
   void Update(float curtime, bool applyToObject);
 
+  /**
+   * First part of Update: compute the action's frame and evaluate the armature pose.
+   * It only modifies data owned by the action's object and can be called in parallel
+   * for different objects.
+   * \param curtime The current time used to compute the action's frame.
+   * \param applyToObject Set to true when the action must be applied to the object.
+   */
+  void UpdatePose(float curtime, bool applyToObject);
+  /**
+   * Second part of Update: apply the action to the scene graph and request the depsgraph
+   * updates. Must be called from the main thread after UpdatePose.
+   * \param curtime The current time used to compute the action's frame.
+   */
+  void ApplyToScene(float curtime);
+
   // Accessors
   float GetFrame();
   const std::string GetName();
+  float GetStartFrame() const;
+  float GetEndFrame() const;
+  short GetPriority() const;
+  short GetPlayMode() const;
+  float GetLayerWeight() const;
+  short GetIpoFlags() const;
+  float GetSpeed() const;
+  short GetBlendMode() const;
 
   struct bAction *GetAction();
 
@@ -133,6 +133,14 @@ void BL_ActionManager::StopAction(short layer)
   }
 }
 
+void BL_ActionManager::StopAllActions()
+{
+  for (BL_ActionMap::iterator it = m_layers.begin(), end = m_layers.end(); it != end; ++it) {
+    delete it->second;
+  }
+  m_layers.clear();
+}
+
 void BL_ActionManager::RemoveTaggedActions()
 {
   for (BL_ActionMap::iterator it = m_layers.begin(); it != m_layers.end();) {
@@ -152,9 +160,71 @@ bool BL_ActionManager::IsActionDone(short layer)
   return action ? action->IsDone() : true;
 }
 
+std::vector<BL_ActionManager::LayerState> BL_ActionManager::GetLayerStates()
+{
+  std::vector<LayerState> states;
+  for (const auto &pair : m_layers) {
+    BL_Action *action = pair.second;
+    if (action->IsDone()) {
+      continue;
+    }
+
+    LayerState state;
+    state.layer = pair.first;
+    state.name = action->GetName();
+    state.start = action->GetStartFrame();
+    state.end = action->GetEndFrame();
+    state.frame = action->GetFrame();
+    state.layerWeight = action->GetLayerWeight();
+    state.speed = action->GetSpeed();
+    state.priority = action->GetPriority();
+    state.playMode = action->GetPlayMode();
+    state.ipoFlags = action->GetIpoFlags();
+    state.blendMode = action->GetBlendMode();
+    states.push_back(state);
+  }
+
+  return states;
+}
+
+void BL_ActionManager::SetLayerStates(const std::vector<LayerState> &states)
+{
+  StopAllActions();
+
+  for (const LayerState &state : states) {
+    if (PlayAction(state.name,
+                   state.start,
+                   state.end,
+                   state.layer,
+                   state.priority,
+                   0.0f,
+                   state.playMode,
+                   state.layerWeight,
+                   state.ipoFlags,
+                   state.speed,
+                   state.blendMode)) {
+      SetActionFrame(state.layer, state.frame);
+    }
+  }
+}
+
 void BL_ActionManager::Update(float curtime, bool applyToObject)
 {
   for (const auto &pair : m_layers) {
     pair.second->Update(curtime, applyToObject);
   }
 }
+
+void BL_ActionManager::UpdatePoses(float curtime, bool applyToObject)
+{
+  for (const auto &pair : m_layers) {
+    pair.second->UpdatePose(curtime, applyToObject);
+  }
+}
+
+void BL_ActionManager::ApplyToScene(float curtime)
+{
+  for (const auto &pair : m_layers) {
+    pair.second->ApplyToScene(curtime);
+  }
+}
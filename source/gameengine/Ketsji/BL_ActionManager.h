@@ -28,6 +28,8 @@
 
 #include <iostream>
 #include <map>
+#include <string>
+#include <vector>
 
 // Currently, we use the max value of a short.
 // We should switch to unsigned short; doesn't make sense to support negative layers.
@@ -52,6 +54,21 @@ class BL_ActionManager {
   BL_Action *GetAction(short layer);
 
  public:
+  /// Playback settings and frame of the action of a layer, used to save and restore actions.
+  struct LayerState {
+    short layer;
+    std::string name;
+    float start;
+    float end;
+    float frame;
+    float layerWeight;
+    float speed;
+    short priority;
+    short playMode;
+    short ipoFlags;
+    short blendMode;
+  };
+
   BL_ActionManager(class KX_GameObject *obj);
   ~BL_ActionManager();
 
@@ -96,6 +113,11 @@ class BL_ActionManager {
    */
   void StopAction(short layer);
 
+  /**
+   * Stop playing the actions on all layers
+   */
+  void StopAllActions();
+
   /**
    * Remove playing tagged actions.
    */
@@ -106,6 +128,15 @@ class BL_ActionManager {
    */
   bool IsActionDone(short layer);
 
+  /**
+   * Get the state of the actions still playing, in layer order.
+   */
+  std::vector<LayerState> GetLayerStates();
+  /**
+   * Stop all the actions and play the actions of the states from their saved frame.
+   */
+  void SetLayerStates(const std::vector<LayerState> &states);
+
   /**
    * Update any running actions
    * \param curtime The current time used to compute the actions' frame.
@@ -113,4 +144,19 @@ class BL_ActionManager {
    * manages actions' frames.
    */
   void Update(float curtime, bool applyToObject);
+
+  /**
+   * Update the frames and armature poses of the running actions without touching the scene,
+   * safe to call in parallel for different objects.
+   * \param curtime The current time used to compute the actions' frame.
+   * \param applyToObject Set to true if the actions must transform the object, else it only
+   * manages actions' frames.
+   */
+  void UpdatePoses(float curtime, bool applyToObject);
+
+  /**
+   * Apply the actions updated by UpdatePoses to the scene, must be called from the main thread.
+   * \param curtime The current time used to compute the actions' frame.
+   */
+  void ApplyToScene(float curtime);
 };
@@ -59,4 +59,6 @@ class KX_BoneParentRelation : public SG_ParentRelation {
 
   /// Create a copy of this relationship
   virtual SG_ParentRelation *NewCopy();
+
+  virtual bool IsBoneRelation();
 };
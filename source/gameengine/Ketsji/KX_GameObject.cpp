@@ -87,6 +87,8 @@ KX_GameObject::KX_GameObject(void *sgReplicationInfo, SG_Callbacks callbacks)
       m_isReplica(false),              // eevee
       m_visibleAtGameStart(false),     // eevee
       m_forceIgnoreParentTx(false),    // eevee
+      m_inDirtyTransformList(false),   // eevee
+      m_poolTemplate(nullptr),         // eevee
       m_previousLodLevel(-1),          // eevee
       m_layer(0),
       m_lodManager(nullptr),
@@ -96,7 +98,10 @@ KX_GameObject::KX_GameObject(void *sgReplicationInfo, SG_Callbacks callbacks)
       m_bIsNegativeScaling(false),
       m_objectColor(1.0f, 1.0f, 1.0f, 1.0f),
       m_bVisible(true),
+      m_bCulled(false),
       m_bOccluder(false),
+      m_activityCulled(false),
+      m_activityPhysicsSuspended(false),
       m_pPhysicsController(nullptr),
       m_components(NULL),
       m_pInstanceObjects(nullptr),
@@ -253,6 +258,8 @@ void KX_GameObject::SyncTransformWithDepsgraph()
 void KX_GameObject::ForceIgnoreParentTx()
 {
   m_forceIgnoreParentTx = true;
+  // The children compensation is done while synchronizing the object with the depsgraph.
+  GetScene()->AddDirtyTransformObject(this);
 }
 
 void KX_GameObject::TagForTransformUpdate(bool is_last_render_pass)
@@ -557,6 +564,26 @@ float *KX_GameObject::GetPrevObmat()
   return (float *)m_prevObmat;
 }
 
+bool KX_GameObject::GetInDirtyTransformList() const
+{
+  return m_inDirtyTransformList;
+}
+
+void KX_GameObject::SetInDirtyTransformList(bool dirty)
+{
+  m_inDirtyTransformList = dirty;
+}
+
+KX_GameObject *KX_GameObject::GetPoolTemplate() const
+{
+  return m_poolTemplate;
+}
+
+void KX_GameObject::SetPoolTemplate(KX_GameObject *poolTemplate)
+{
+  m_poolTemplate = poolTemplate;
+}
+
 /********************End of EEVEE INTEGRATION*********************/
 
 KX_GameObject *KX_GameObject::GetClientObject(KX_ClientObjectInfo *info)
@@ -575,6 +602,8 @@ std::string KX_GameObject::GetName()
 void KX_GameObject::SetName(const std::string &name)
 {
   m_name = name;
+  // The object lists index objects by name.
+  EXP_BaseListValue::NotifyNameChanged();
 }
 
 PHY_IPhysicsController *KX_GameObject::GetPhysicsController()
@@ -696,8 +725,7 @@ void KX_GameObject::SetParent(KX_GameObject *obj, bool addToCompound, bool ghost
     NodeSetLocalOrientation(invori * NodeGetWorldOrientation());
     NodeUpdateGS(0.f);
     // object will now be a child, it must be removed from the parent list
-    EXP_ListValue<KX_GameObject> *rootlist = scene->GetRootParentList();
-    if (rootlist->RemoveValue(this))
+    if (scene->RemoveRootObject(this))
       // the object was in parent list, decrement ref count as it's now removed
       Release();
     // if the new parent is a compound object, add this object shape to the compound shape.
@@ -732,10 +760,9 @@ void KX_GameObject::RemoveParent()
 
     KX_Scene *scene = GetScene();
     // the object is now a root object, add it to the parentlist
-    EXP_ListValue<KX_GameObject> *rootlist = scene->GetRootParentList();
-    if (!rootlist->SearchValue(this))
+    if (!scene->GetRootParentList()->SearchValue(this))
       // object was not in root list, add it now and increment ref count
-      rootlist->Add(CM_AddRef(this));
+      scene->AddRootObject(this);
     if (m_pPhysicsController) {
       // in case this controller was added as a child shape to the parent
       if (rootobj != nullptr && rootobj->m_pPhysicsController != nullptr &&
@@ -799,6 +826,13 @@ void KX_GameObject::StopAction(short layer)
   GetActionManager()->StopAction(layer);
 }
 
+void KX_GameObject::StopAllActions()
+{
+  if (m_actionManager) {
+    m_actionManager->StopAllActions();
+  }
+}
+
 void KX_GameObject::RemoveTaggedActions()
 {
   GetActionManager()->RemoveTaggedActions();
@@ -809,11 +843,38 @@ bool KX_GameObject::IsActionDone(short layer)
   return GetActionManager()->IsActionDone(layer);
 }
 
+std::vector<BL_ActionManager::LayerState> KX_GameObject::GetActionLayerStates()
+{
+  if (!m_actionManager) {
+    return {};
+  }
+  return m_actionManager->GetLayerStates();
+}
+
+void KX_GameObject::SetActionLayerStates(const std::vector<BL_ActionManager::LayerState> &states)
+{
+  if (states.empty()) {
+    StopAllActions();
+    return;
+  }
+  GetActionManager()->SetLayerStates(states);
+}
+
 void KX_GameObject::UpdateActionManager(float curtime, bool applyToObject)
 {
   GetActionManager()->Update(curtime, applyToObject);
 }
 
+void KX_GameObject::UpdateActionManagerPoses(float curtime, bool applyToObject)
+{
+  GetActionManager()->UpdatePoses(curtime, applyToObject);
+}
+
+void KX_GameObject::ApplyActionManager(float curtime)
+{
+  GetActionManager()->ApplyToScene(curtime);
+}
+
 float KX_GameObject::GetActionFrame(short layer)
 {
   return GetActionManager()->GetActionFrame(layer);
@@ -856,6 +917,10 @@ void KX_GameObject::ProcessReplica()
   m_pClient_info = new KX_ClientObjectInfo(*m_pClient_info);
   m_pClient_info->m_gameobject = this;
   m_actionManager = nullptr;
+  m_inDirtyTransformList = false;
+  m_poolTemplate = nullptr;
+  m_activityCulled = false;
+  m_activityPhysicsSuspended = false;
   m_state = 0;
 
   if (m_lodManager) {
@@ -1064,6 +1129,11 @@ KX_LodManager *KX_GameObject::GetLodManager() const
   return m_lodManager;
 }
 
+short KX_GameObject::GetCurrentLodLevel() const
+{
+  return m_currentLodLevel;
+}
+
 void KX_GameObject::UpdateLod(const MT_Vector3 &cam_pos, float lodfactor)
 {
   if (!m_lodManager) {
@@ -1126,6 +1196,8 @@ void KX_GameObject::UpdateTransform()
 void KX_GameObject::UpdateTransformFunc(SG_Node *node, void *gameobj, void *scene)
 {
   ((KX_GameObject *)gameobj)->UpdateTransform();
+  // The node world transform changed and is tagged DIRTY_RENDER, sync it with the depsgraph.
+  ((KX_Scene *)scene)->AddDirtyTransformObject((KX_GameObject *)gameobj);
 }
 
 void KX_GameObject::SynchronizeTransform()
@@ -1138,6 +1210,7 @@ void KX_GameObject::SynchronizeTransform()
 void KX_GameObject::SynchronizeTransformFunc(SG_Node *node, void *gameobj, void *scene)
 {
   ((KX_GameObject *)gameobj)->SynchronizeTransform();
+  ((KX_Scene *)scene)->AddDirtyTransformObject((KX_GameObject *)gameobj);
 }
 
 void KX_GameObject::InitIPO(bool ipo_as_force, bool ipo_add, bool ipo_local)
@@ -1165,22 +1238,22 @@ bool KX_GameObject::GetVisible(void)
   return m_bVisible;
 }
 
-static void setVisible_recursive(SG_Node *node, bool v)
+static void setVisible_recursive(SG_Node *node, bool v, bool syncLayer)
 {
   const NodeList &children = node->GetSGChildren();
 
   for (SG_Node *childnode : children) {
     KX_GameObject *clientgameobj = static_cast<KX_GameObject *>(childnode->GetSGClientObject());
     if (clientgameobj != nullptr)  // This is a GameObject
-      clientgameobj->SetVisible(v, 0);
+      clientgameobj->SetVisible(v, 0, syncLayer);
 
     // if the childobj is nullptr then this may be an inverse parent link
     // so a non recursive search should still look down this node.
-    setVisible_recursive(childnode, v);
+    setVisible_recursive(childnode, v, syncLayer);
   }
 }
 
-void KX_GameObject::SetVisible(bool v, bool recursive)
+void KX_GameObject::SetVisible(bool v, bool recursive, bool syncLayer)
 {
   Object *ob = GetBlenderObject();
   if (ob) {
@@ -1195,18 +1268,49 @@ void KX_GameObject::SetVisible(bool v, bool recursive)
         base->flag |= BASE_HIDDEN;
       }
 
-      BKE_layer_collection_sync(scene, view_layer);
-      DEG_id_tag_update(&scene->id, ID_RECALC_BASE_FLAGS);
+      if (syncLayer) {
+        BKE_layer_collection_sync(scene, view_layer);
+        DEG_id_tag_update(&scene->id, ID_RECALC_BASE_FLAGS);
+      }
     }
   }
 
   if (recursive) {
-    setVisible_recursive(GetSGNode(), v);
+    setVisible_recursive(GetSGNode(), v, syncLayer);
   }
 
   m_bVisible = v;
 }
 
+void KX_GameObject::SetActivityCulled(bool culled)
+{
+  if (m_activityCulled == culled) {
+    return;
+  }
+  m_activityCulled = culled;
+
+  if (culled) {
+    SuspendControllers();
+    for (SCA_IActuator *actuator : m_actuators) {
+      actuator->Deactivate();
+    }
+
+    // Don't restore later the physics suspended by the user.
+    m_activityPhysicsSuspended = m_pPhysicsController &&
+                                 !m_pPhysicsController->IsPhysicsSuspended();
+    if (m_activityPhysicsSuspended) {
+      m_pPhysicsController->SuspendPhysics(false);
+    }
+  }
+  else {
+    ResumeControllers();
+    if (m_activityPhysicsSuspended) {
+      m_pPhysicsController->RestorePhysics();
+      m_activityPhysicsSuspended = false;
+    }
+  }
+}
+
 static void setOccluder_recursive(SG_Node *node, bool v)
 {
   const NodeList &children = node->GetSGChildren();
@@ -44,6 +44,7 @@
 #include "DNA_constraint_types.h" /* for constraint replication */
 #include "DNA_object_types.h"
 
+#include "BL_ActionManager.h"
 #include "EXP_ListValue.h"
 #include "KX_KetsjiEngine.h" /* for m_anim_framerate */
 #include "KX_Scene.h"
@@ -60,7 +61,6 @@ class KX_PythonComponent;
 class RAS_MeshObject;
 class PHY_IPhysicsEnvironment;
 class PHY_IPhysicsController;
-class BL_ActionManager;
 struct Object;
 class KX_ObstacleSimulation;
 class KX_CollisionContactPointList;
@@ -93,6 +93,10 @@ class KX_GameObject : public SCA_IObject {
   bool m_useCopy;
   bool m_visibleAtGameStart;
   bool m_forceIgnoreParentTx;
+  /// True when the object is registered in its scene's dirty transform list.
+  bool m_inDirtyTransformList;
+  /// The inactive object this replica was spawned from when it belongs to an object pool.
+  KX_GameObject *m_poolTemplate;
   short m_previousLodLevel;
   /* END OF EEVEE INTEGRATION */
 
@@ -115,8 +119,14 @@ class KX_GameObject : public SCA_IObject {
   // visible = user setting
   // culled = while rendering, depending on camera
   bool m_bVisible;
+  bool m_bCulled;
   bool m_bOccluder;
 
+  // activity culled = logic and physics suspended, depending on cameras distance
+  bool m_activityCulled;
+  /// The physics was suspended by the activity culling and not by the user.
+  bool m_activityPhysicsSuspended;
+
   PHY_IPhysicsController *m_pPhysicsController;
   SG_Node *m_pSGNode;
 
@@ -152,6 +162,10 @@ class KX_GameObject : public SCA_IObject {
   void SyncTransformWithDepsgraph();
   void SetIsReplicaObject();
   float *GetPrevObmat();
+  bool GetInDirtyTransformList() const;
+  void SetInDirtyTransformList(bool dirty);
+  KX_GameObject *GetPoolTemplate() const;
+  void SetPoolTemplate(KX_GameObject *poolTemplate);
   /* END OF EEVEE INTEGRATION */
 
   /**
@@ -293,6 +307,11 @@ class KX_GameObject : public SCA_IObject {
    */
   void StopAction(short layer);
 
+  /**
+   * Stop playing the actions on all layers, doesn't create an action manager if none exists.
+   */
+  void StopAllActions();
+
   /**
    * Remove playing tagged actions.
    */
@@ -303,6 +322,15 @@ class KX_GameObject : public SCA_IObject {
    */
   bool IsActionDone(short layer);
 
+  /**
+   * Get the state of the playing actions, doesn't create an action manager if none exists.
+   */
+  std::vector<BL_ActionManager::LayerState> GetActionLayerStates();
+  /**
+   * Stop all the actions and play the actions of the states.
+   */
+  void SetActionLayerStates(const std::vector<BL_ActionManager::LayerState> &states);
+
   /**
    * Kick the object's action manager
    * \param curtime The current time used to compute the actions frame.
@@ -311,6 +339,21 @@ class KX_GameObject : public SCA_IObject {
    */
   void UpdateActionManager(float curtime, bool applyObject);
 
+  /**
+   * Update the frames and poses of the object's actions, safe to call in parallel for different
+   * objects. ApplyActionManager must be called afterward from the main thread.
+   * \param curtime The current time used to compute the actions frame.
+   * \param applyObject Set to true if the actions must transform this object, else it only manages
+   * actions' frames.
+   */
+  void UpdateActionManagerPoses(float curtime, bool applyObject);
+
+  /**
+   * Apply the actions updated by UpdateActionManagerPoses to the scene graph and depsgraph.
+   * \param curtime The current time used to compute the actions frame.
+   */
+  void ApplyActionManager(float curtime);
+
   /*********************************
    * End Animation API
    *********************************/
@@ -634,6 +677,8 @@ class KX_GameObject : public SCA_IObject {
   void SetLodManager(KX_LodManager *lodManager);
   /// Get current lod manager.
   KX_LodManager *GetLodManager() const;
+  /// Get the lod level computed by the last UpdateLod.
+  short GetCurrentLodLevel() const;
 
   /**
    * Updates the current lod level based on distance from camera.
@@ -668,8 +713,39 @@ class KX_GameObject : public SCA_IObject {
 
   /**
    * Set visibility flag of this object
+   * \param syncLayer Synchronize the view layer bases immediately, when false
+   * the caller is in charge of calling KX_Scene::TagBaseFlagsUpdate.
+   */
+  void SetVisible(bool b, bool recursive, bool syncLayer = true);
+
+  /**
+   * Was this object outside of the culling camera frustum during the last animation update?
+   */
+  inline bool GetCulled(void)
+  {
+    return m_bCulled;
+  }
+
+  /**
+   * Set culled flag of this object
+   */
+  inline void SetCulled(bool c)
+  {
+    m_bCulled = c;
+  }
+
+  /**
+   * Was this object suspended by the scene activity culling?
+   */
+  inline bool GetActivityCulled() const
+  {
+    return m_activityCulled;
+  }
+
+  /**
+   * Suspend or resume the logic bricks and physics of this object for the activity culling.
    */
-  void SetVisible(bool b, bool recursive);
+  void SetActivityCulled(bool culled);
 
   /**
    * Is this object an occluder?
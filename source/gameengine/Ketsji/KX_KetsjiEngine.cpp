@@ -36,7 +36,12 @@
 
 #include "KX_KetsjiEngine.h"
 
+#include <algorithm>
 #include <boost/format.hpp>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <thread>
 
 #include "DNA_scene_types.h"
 #include "DRW_render.h"
@@ -47,6 +52,7 @@
 #include "BL_BlenderConverter.h"
 #include "BL_BlenderSceneConverter.h"
 #include "CM_Message.h"
+#include "CM_Profiler.h"
 #include "DEV_Joystick.h"  // for DEV_Joystick::HandleEvents
 #include "KX_Camera.h"
 #include "KX_Globals.h"
@@ -143,12 +149,23 @@ KX_KetsjiEngine::KX_KetsjiEngine(KX_ISystem *system,
       m_ticrate(DEFAULT_LOGIC_TIC_RATE),
       m_anim_framerate(25.0),
       m_doRender(true),
+      m_maxDroppedRenders(0),
+      m_droppedRenders(0),
+      m_logicFrameCost(0.0),
+      m_renderCost(0.0),
+      m_lastNextFrameEnd(0.0),
+      m_lastFrameRendered(false),
+      m_pacingOversleep(0.0),
+      m_pacingJitter(0.0),
       m_exitkey(130),
       m_exitcode(KX_ExitRequest::NO_REQUEST),
       m_exitstring(""),
       m_cameraZoom(1.0f),
       m_overrideCamZoom(1.0f),
       m_logger(KX_TimeCategoryLogger(m_clock, 25)),
+      m_depsgraphProfileBegin(0),
+      m_frameCount(0),
+      m_frameLimit(0),
       m_average_framerate(0.0),
       m_showBoundingBox(KX_DebugOption::DISABLE),
       m_showArmature(KX_DebugOption::DISABLE),
@@ -201,10 +218,14 @@ int KX_KetsjiEngine::ShadingTypeRuntime()
 void KX_KetsjiEngine::CountDepsgraphTime()
 {
   m_logger.StartLog(tc_depsgraph);
+  m_depsgraphProfileBegin = CM_Profiler::GetTime();
 }
 
 void KX_KetsjiEngine::EndCountDepsgraphTime()
 {
+  if (CM_Profiler::IsEnabled()) {
+    CM_Profiler::AddZone("Depsgraph", m_depsgraphProfileBegin, CM_Profiler::GetTime());
+  }
   m_logger.StartLog(tc_rasterizer);
 }
 
@@ -269,6 +290,7 @@ void KX_KetsjiEngine::BeginFrame()
 
 void KX_KetsjiEngine::EndFrame()
 {
+  CM_PROFILE_ZONE("EndFrame");
 
   DRW_state_reset();
   GPU_matrix_reset();
@@ -299,12 +321,20 @@ void KX_KetsjiEngine::EndFrame()
     PyDict_SetItemString(m_pyprofiledict, m_profileLabels[i].c_str(), val);
     Py_DECREF(val);
   }
+  if (m_flags & FRAME_PACING) {
+    PyObject *val = PyTuple_New(2);
+    PyTuple_SetItem(val, 0, PyFloat_FromDouble(m_pacingJitter * 1000.0));
+    PyTuple_SetItem(val, 1, PyFloat_FromDouble(m_pacingJitter / tottime * 100.0));
+
+    PyDict_SetItemString(m_pyprofiledict, "Pacing jitter:", val);
+    Py_DECREF(val);
+  }
 #endif
 
   m_average_framerate = 1.0 / tottime;
 
   // Go to next profiling measurement, time spent after this call is shown in the next frame.
-  m_logger.NextMeasurement();
+  NextMeasurement();
 
   m_logger.StartLog(tc_rasterizer);
   m_rasterizer->EndFrame();
@@ -344,12 +374,20 @@ void KX_KetsjiEngine::EndFrameViewportRender()
     PyDict_SetItemString(m_pyprofiledict, m_profileLabels[i].c_str(), val);
     Py_DECREF(val);
   }
+  if (m_flags & FRAME_PACING) {
+    PyObject *val = PyTuple_New(2);
+    PyTuple_SetItem(val, 0, PyFloat_FromDouble(m_pacingJitter * 1000.0));
+    PyTuple_SetItem(val, 1, PyFloat_FromDouble(m_pacingJitter / tottime * 100.0));
+
+    PyDict_SetItemString(m_pyprofiledict, "Pacing jitter:", val);
+    Py_DECREF(val);
+  }
 #endif
 
   m_average_framerate = 1.0 / tottime;
 
   // Go to next profiling measurement, time spent after this call is shown in the next frame.
-  m_logger.NextMeasurement();
+  NextMeasurement();
 
   m_logger.StartLog(tc_rasterizer);
   // m_rasterizer->EndFrame();
@@ -391,8 +429,19 @@ KX_KetsjiEngine::FrameTimes KX_KetsjiEngine::GetFrameTimes()
     m_clockTime = m_clock.GetTimeSecond();
   }
 
+  // The frames of a reproducible run don't depend on the elapsed time.
+  if (m_flags & FIXED_TIMESTEP) {
+    m_previousRealTime = m_clockTime;
+
+    FrameTimes times;
+    times.frames = 1;
+    times.timestep = 1.0 / m_ticrate;
+    times.framestep = times.timestep * m_timescale;
+    return times;
+  }
+
   // Get elapsed time.
-  const double dt = m_clockTime - m_previousRealTime;
+  double dt = m_clockTime - m_previousRealTime;
 
   // Time of a frame (without scale).
   double timestep;
@@ -410,36 +459,54 @@ KX_KetsjiEngine::FrameTimes KX_KetsjiEngine::GetFrameTimes()
   if (m_flags & FIXED_FRAMERATE) {
     // As many as possible for the elapsed time.
     frames = int(dt * m_ticrate);
+
+    // Sleep until the next frame instead of polling the clock again.
+    if (frames == 0 && (m_flags & FRAME_PACING) && !(m_flags & USE_EXTERNAL_CLOCK)) {
+      const double deadline = m_previousRealTime + timestep;
+      WaitFrameDeadline(deadline);
+
+      m_clockTime = m_clock.GetTimeSecond();
+      dt = m_clockTime - m_previousRealTime;
+      // The deadline is reached, ignore the rounding.
+      frames = std::max(int(dt * m_ticrate), 1);
+
+      const double jitter = std::fabs(m_clockTime - deadline);
+      m_pacingJitter = m_pacingJitter * 0.9 + jitter * 0.1;
+      if (CM_Profiler::IsEnabled()) {
+        // In microseconds.
+        CM_Profiler::AddCounter("FramePacingJitter", CM_Profiler::GetTime(), jitter * 1.0e6);
+      }
+    }
   }
   else {
     // Proceed always one frame in non-fixed framerate.
     frames = 1;
   }
 
+  int maxLogicFrame = m_maxLogicFrame;
+  /* Limit the logic frames to the number that can be proceeded with the render in one
+   * logic period, else the late frames cost more time than they make up for. */
+  if ((m_flags & (ADAPTIVE_LOGIC_FRAMES | FIXED_FRAMERATE)) ==
+          (ADAPTIVE_LOGIC_FRAMES | FIXED_FRAMERATE) &&
+      m_logicFrameCost > 0.0) {
+    const double budget = 1.0 / m_ticrate - m_renderCost;
+    maxLogicFrame = std::max(std::min(int(budget / m_logicFrameCost), m_maxLogicFrame), 1);
+  }
+
   // Fix timestep to not exceed max physics and logic frames.
   if (frames > m_maxPhysicsFrame) {
     timestep = dt / m_maxPhysicsFrame;
     frames = m_maxPhysicsFrame;
   }
-  if (frames > m_maxLogicFrame) {
-    timestep = dt / m_maxLogicFrame;
-    frames = m_maxLogicFrame;
+  if (frames > maxLogicFrame) {
+    timestep = dt / maxLogicFrame;
+    frames = maxLogicFrame;
   }
 
   // If the number of frame is non-zero, update previous time.
   if (frames > 0) {
     m_previousRealTime = m_clockTime;
   }
-  //// Else in case of fixed framerate, try to sleep until the next frame.
-  //else if (m_flags & FIXED_FRAMERATE) {
-  //  const double sleeptime = timestep - dt - 1.0e-3;
-  //  /* If the remaining time is greather than 1ms (sleep resolution) sleep this thread.
-  //   * The other 1ms will be busy wait.
-  //   */
-  //  if (sleeptime > 0.0) {
-  //    std::this_thread::sleep_for(std::chrono::nanoseconds((long)(sleeptime * 1.0e9)));
-  //  }
-  //}
 
   // Frame time with time scale.
   const double framestep = timestep * m_timescale;
@@ -452,10 +519,45 @@ KX_KetsjiEngine::FrameTimes KX_KetsjiEngine::GetFrameTimes()
   return times;
 }
 
+void KX_KetsjiEngine::WaitFrameDeadline(double deadline)
+{
+  CM_PROFILE_ZONE("FramePacing");
+
+  // Spin at least the average oversleep of the system and never more than a few milliseconds.
+  const double spintime = std::min(std::max(m_pacingOversleep * 1.5, 1.0e-4), 2.0e-3);
+  const double sleepstart = m_clock.GetTimeSecond();
+  const double sleeptime = deadline - sleepstart - spintime;
+  if (sleeptime > 0.0) {
+    std::this_thread::sleep_for(std::chrono::nanoseconds((long long)(sleeptime * 1.0e9)));
+
+    const double oversleep = std::max(m_clock.GetTimeSecond() - sleepstart - sleeptime, 0.0);
+    m_pacingOversleep = m_pacingOversleep * 0.9 + oversleep * 0.1;
+  }
+
+  while (m_clock.GetTimeSecond() < deadline) {
+    std::this_thread::yield();
+  }
+}
+
+void KX_KetsjiEngine::FinishPipelinedPhysics()
+{
+  for (KX_Scene *scene : m_scenes) {
+    scene->FinishPhysics();
+  }
+}
+
 bool KX_KetsjiEngine::NextFrame()
 {
+  CM_PROFILE_ZONE("NextFrame");
+
   m_logger.StartLog(tc_services);
 
+  // Measure the time spent since the last frame, mainly the render.
+  const double starttime = m_clock.GetTimeSecond();
+  if (m_lastFrameRendered) {
+    m_renderCost = m_renderCost * 0.9 + (starttime - m_lastNextFrameEnd) * 0.1;
+  }
+
   const FrameTimes times = GetFrameTimes();
 
   // Exit if zero frame is sheduled.
@@ -463,13 +565,31 @@ bool KX_KetsjiEngine::NextFrame()
     // Start logging time spent outside main loop
     m_logger.StartLog(tc_outside);
 
+    m_lastNextFrameEnd = m_clock.GetTimeSecond();
+    m_lastFrameRendered = false;
     return false;
   }
 
+  const double logicstart = m_clock.GetTimeSecond();
+  const bool headless = (m_flags & HEADLESS);
+  /* Without render the physics step would be waited at the next frame without anything
+   * done meanwhile. */
+  const bool pipelinePhysics = (m_flags & RENDER_PIPELINING) && m_doRender && !headless;
+
   for (unsigned short i = 0; i < times.frames; ++i) {
+    CM_PROFILE_ZONE("LogicFrame");
+
+    // The logic needs the result of the physics step started during the last render.
+    FinishPipelinedPhysics();
+
     m_frameTime += times.framestep;
+    ++m_frameCount;
 
-    m_converter->MergeAsyncLoads();
+    {
+      CM_PROFILE_ZONE("MergeAsync");
+      m_converter->MergeAsyncLoads();
+      m_converter->MergeAsyncConversions();
+    }
 
     m_inputDevice->ReleaseMoveEvent();
 
@@ -493,13 +613,18 @@ bool KX_KetsjiEngine::NextFrame()
 
     // for each scene, call the proceed functions
     for (KX_Scene *scene : m_scenes) {
+      CM_PROFILE_ZONE("Scene");
+
       /* Suspension holds the physics and logic processing for an
        * entire scene. Objects can be suspended individually, and
        * the settings for that precede the logic and physics
        * update. */
       m_logger.StartLog(tc_logic);
 
-      scene->UpdateObjectActivity();
+      {
+        CM_PROFILE_ZONE("ObjectActivity");
+        scene->UpdateObjectActivity();
+      }
 
       m_logger.StartLog(tc_physics);
       // set Python hooks for each scene
@@ -510,43 +635,91 @@ bool KX_KetsjiEngine::NextFrame()
 
       // Process sensors, and controllers
       m_logger.StartLog(tc_logic);
-      scene->LogicBeginFrame(m_frameTime, times.framestep);
+      {
+        CM_PROFILE_ZONE("LogicBeginFrame");
+        scene->LogicBeginFrame(m_frameTime, times.framestep);
+      }
 
       // Scenegraph needs to be updated again, because Logic Controllers
       // can affect the local matrices.
       m_logger.StartLog(tc_scenegraph);
-      scene->UpdateParents(m_frameTime);
+      {
+        CM_PROFILE_ZONE("SceneGraph");
+        scene->UpdateParents(m_frameTime);
+      }
 
       // Process actuators
 
       // Do some cleanup work for this logic frame
       m_logger.StartLog(tc_logic);
-      scene->LogicUpdateFrame(m_frameTime);
+      {
+        CM_PROFILE_ZONE("LogicUpdateFrame");
+        scene->LogicUpdateFrame(m_frameTime);
 
-      scene->LogicEndFrame();
+        scene->LogicEndFrame();
+      }
 
       // Actuators can affect the scenegraph
       m_logger.StartLog(tc_scenegraph);
-      scene->UpdateParents(m_frameTime);
+      {
+        CM_PROFILE_ZONE("SceneGraph");
+        scene->UpdateParents(m_frameTime);
+      }
 
       m_logger.StartLog(tc_physics);
 
-      // Perform physics calculations on the scene. This can involve
-      // many iterations of the physics solver.
-      scene->GetPhysicsEnvironment()->ProceedDeltaTime(
-          m_frameTime, times.timestep, times.framestep);  // m_deltatimerealDeltaTime);
+      // The physics step of the last frame is started once the logic of all scenes is done.
+      if (pipelinePhysics && i == times.frames - 1) {
+        m_logger.StartLog(tc_services);
+        continue;
+      }
+
+      {
+        CM_PROFILE_ZONE("Physics");
+        // Perform physics calculations on the scene. This can involve
+        // many iterations of the physics solver.
+        scene->GetPhysicsEnvironment()->ProceedDeltaTime(
+            m_frameTime, times.timestep, times.framestep);  // m_deltatimerealDeltaTime);
 
-      /* No need to call sofbody update more than 1 time */
-      if (i == times.frames - 1) {
-        scene->GetPhysicsEnvironment()->UpdateSoftBodies();
+        /* No need to call sofbody update more than 1 time */
+        if (i == times.frames - 1) {
+          scene->GetPhysicsEnvironment()->UpdateSoftBodies();
+        }
       }
 
       m_logger.StartLog(tc_scenegraph);
-      scene->UpdateParents(m_frameTime);
+      {
+        CM_PROFILE_ZONE("SceneGraph");
+        scene->UpdateParents(m_frameTime);
+      }
 
       m_logger.StartLog(tc_services);
     }
 
+    if ((pipelinePhysics || headless) && i == times.frames - 1) {
+      /* The animations modify the scene graph and the physics controllers, they are updated
+       * before the physics steps instead of during the render, which doesn't happen at all
+       * in headless mode. */
+      m_logger.StartLog(tc_animations);
+      for (KX_Scene *scene : m_scenes) {
+        CM_PROFILE_ZONE("Animations");
+        UpdateAnimations(scene);
+      }
+
+      m_logger.StartLog(tc_scenegraph);
+      for (KX_Scene *scene : m_scenes) {
+        CM_PROFILE_ZONE("SceneGraph");
+        scene->UpdateParents(m_frameTime);
+      }
+
+      if (pipelinePhysics) {
+        m_logger.StartLog(tc_physics);
+        for (KX_Scene *scene : m_scenes) {
+          scene->ProceedPhysicsAsync(m_frameTime, times.timestep, times.framestep);
+        }
+      }
+    }
+
     m_logger.StartLog(tc_network);
     m_networkMessageManager->ClearMessages();
 
@@ -555,13 +728,45 @@ bool KX_KetsjiEngine::NextFrame()
     m_inputDevice->ClearInputs();
 
     // scene management
+    CM_PROFILE_ZONE("ScheduledScenes");
     ProcessScheduledScenes();
   }
 
+  const double logicend = m_clock.GetTimeSecond();
+  m_logicFrameCost = m_logicFrameCost * 0.9 + (logicend - logicstart) / times.frames * 0.1;
+
+  if (m_frameLimit > 0 && m_frameCount >= m_frameLimit) {
+    RequestExit(KX_ExitRequest::QUIT_GAME);
+  }
+
+  bool render = m_doRender && !headless;
+  if (headless) {
+    // The debug shapes requested by the logic are never drawn.
+    m_rasterizer->GetDebugDraw().Clear();
+    // Without EndFrame the measurements are done per logic update.
+    NextMeasurement();
+  }
+
+  /* Skip the render while the next logic frame is already late, to catch up with
+   * the logic time before rendering a frame. */
+  if (render && m_maxDroppedRenders > 0 && (m_flags & FIXED_FRAMERATE) &&
+      !(m_flags & USE_EXTERNAL_CLOCK)) {
+    const bool late = (logicend - m_previousRealTime) * m_ticrate >= 1.0;
+    if (late && m_droppedRenders < m_maxDroppedRenders) {
+      ++m_droppedRenders;
+      render = false;
+    }
+    else {
+      m_droppedRenders = 0;
+    }
+  }
+
   // Start logging time spent outside main loop
   m_logger.StartLog(tc_outside);
 
-  return m_doRender;
+  m_lastNextFrameEnd = m_clock.GetTimeSecond();
+  m_lastFrameRendered = render;
+  return render;
 }
 
 KX_KetsjiEngine::CameraRenderData KX_KetsjiEngine::GetCameraRenderData(
@@ -743,6 +948,8 @@ bool KX_KetsjiEngine::GetFrameRenderData(std::vector<FrameRenderData> &frameData
 
 void KX_KetsjiEngine::Render()
 {
+  CM_PROFILE_ZONE("Render");
+
   m_logger.StartLog(tc_rasterizer);
 
   BeginFrame();
@@ -1011,6 +1218,8 @@ void KX_KetsjiEngine::RenderCamera(KX_Scene *scene,
                                    const CameraRenderData &cameraFrameData,
                                    unsigned short pass)
 {
+  CM_PROFILE_ZONE("RenderCamera");
+
   KX_Camera *rendercam = cameraFrameData.m_renderCamera;
   // KX_Camera *cullingcam = cameraFrameData.m_cullingCamera;
   // const RAS_Rect &area = cameraFrameData.m_area;
@@ -1030,7 +1239,11 @@ void KX_KetsjiEngine::RenderCamera(KX_Scene *scene,
   m_logger.StartLog(tc_scenegraph);
 
   m_logger.StartLog(tc_animations);
-  UpdateAnimations(scene);
+  // The animations of a pipelined frame are updated before its physics step.
+  if (!(m_flags & RENDER_PIPELINING)) {
+    CM_PROFILE_ZONE("Animations");
+    UpdateAnimations(scene);
+  }
 
   m_logger.StartLog(tc_rasterizer);
 
@@ -1054,8 +1267,13 @@ void KX_KetsjiEngine::RenderCamera(KX_Scene *scene,
 
   scene->RenderAfterCameraSetup(rendercam, viewport, is_overlay_pass, is_last_render_pass);
 
-  if (scene->GetPhysicsEnvironment()) {
-    scene->GetPhysicsEnvironment()->DebugDrawWorld();
+  PHY_IPhysicsEnvironment *physEnv = scene->GetPhysicsEnvironment();
+  if (physEnv) {
+    // The debug draw reads the physics world.
+    if (physEnv->GetDebugMode() > 0) {
+      scene->WaitPhysics();
+    }
+    physEnv->DebugDrawWorld();
   }
 }
 
@@ -1097,6 +1315,7 @@ void KX_KetsjiEngine::StopEngine()
 {
   if (m_bInitialized) {
     m_converter->FinalizeAsyncLoads();
+    FinishPipelinedPhysics();
 
     while (m_scenes->GetCount() > 0) {
       KX_Scene *scene = m_scenes->GetFront();
@@ -1106,8 +1325,83 @@ void KX_KetsjiEngine::StopEngine()
     }
 
     // cleanup all the stuff
-    m_rasterizer->Exit();
+    if (!(m_flags & HEADLESS)) {
+      m_rasterizer->Exit();
+    }
+
+    WriteFrameTimings();
+  }
+}
+
+void KX_KetsjiEngine::NextMeasurement()
+{
+  m_logger.NextMeasurement();
+
+  if (!m_frameTimingsFile.empty()) {
+    std::array<double, tc_numCategories> times;
+    for (int i = tc_first; i < tc_numCategories; ++i) {
+      times[i] = m_logger.GetLast((KX_TimeCategory)i);
+    }
+    m_frameTimings.push_back(times);
+  }
+}
+
+void KX_KetsjiEngine::WriteFrameTimings()
+{
+  if (m_frameTimingsFile.empty()) {
+    return;
+  }
+
+  std::ofstream file(m_frameTimingsFile);
+  if (!file) {
+    CM_Error("cannot write frame timings \"" << m_frameTimingsFile << "\"");
+    return;
+  }
+
+  // Category names without the colon of the profile labels.
+  std::array<std::string, tc_numCategories> names;
+  for (int i = tc_first; i < tc_numCategories; ++i) {
+    const std::string &label = m_profileLabels[i];
+    names[i] = label.substr(0, label.size() - 1);
+  }
+
+  const std::string &path = m_frameTimingsFile;
+  const bool json = (path.size() > 5 && path.compare(path.size() - 5, 5, ".json") == 0);
+
+  // The times are in milliseconds.
+  if (json) {
+    file << "{\"categories\": [";
+    for (int i = tc_first; i < tc_numCategories; ++i) {
+      file << ((i == tc_first) ? "" : ", ") << "\"" << names[i] << "\"";
+    }
+    file << "],\n \"frames\": [";
+    for (unsigned int j = 0, size = m_frameTimings.size(); j < size; ++j) {
+      file << ((j == 0) ? "\n  [" : ",\n  [");
+      for (int i = tc_first; i < tc_numCategories; ++i) {
+        file << ((i == tc_first) ? "" : ", ") << m_frameTimings[j][i] * 1000.0;
+      }
+      file << "]";
+    }
+    file << "]}\n";
+  }
+  else {
+    file << "frame";
+    for (int i = tc_first; i < tc_numCategories; ++i) {
+      file << "," << names[i];
+    }
+    file << "\n";
+    for (unsigned int j = 0, size = m_frameTimings.size(); j < size; ++j) {
+      file << j;
+      for (int i = tc_first; i < tc_numCategories; ++i) {
+        file << "," << m_frameTimings[j][i] * 1000.0;
+      }
+      file << "\n";
+    }
   }
+
+  CM_Message("frame timings of " << m_frameTimings.size() << " frames written to \"" << path
+                                 << "\"");
+  m_frameTimings.clear();
 }
 
 // Scene Management is able to switch between scenes
@@ -1158,7 +1452,7 @@ void KX_KetsjiEngine::PostProcessScene(KX_Scene *scene)
     scene->GetCameraList()->Add(CM_AddRef(activecam));
     scene->SetActiveCamera(activecam);
     scene->GetObjectList()->Add(CM_AddRef(activecam));
-    scene->GetRootParentList()->Add(CM_AddRef(activecam));
+    scene->AddRootObject(activecam);
     // done with activecam
     activecam->Release();
   }
@@ -1233,6 +1527,16 @@ void KX_KetsjiEngine::RenderDebugProperties()
           MT_Vector2(xcoord + (int)(2.2 * profile_indent), ycoord), boxSize, white);
       ycoord += const_ysize;
     }
+
+    // Average distance of the frame starts to their deadlines.
+    if (m_flags & FRAME_PACING) {
+      debugDraw.RenderText2D("Pacing jitter:", MT_Vector2(xcoord + const_xindent, ycoord), white);
+
+      debugtxt = (boost::format("%5.2fms") % (m_pacingJitter * 1000.0)).str();
+      debugDraw.RenderText2D(
+          debugtxt, MT_Vector2(xcoord + const_xindent + profile_indent, ycoord), white);
+      ycoord += const_ysize;
+    }
   }
   // Add the ymargin for titles below the other section of debug info
   ycoord += title_y_top_margin;
@@ -1429,6 +1733,31 @@ void KX_KetsjiEngine::SetTimeScale(double timescale)
   m_timescale = timescale;
 }
 
+int KX_KetsjiEngine::GetMaxDroppedRenders() const
+{
+  return m_maxDroppedRenders;
+}
+
+void KX_KetsjiEngine::SetMaxDroppedRenders(int renders)
+{
+  m_maxDroppedRenders = renders;
+}
+
+unsigned int KX_KetsjiEngine::GetFrameCount() const
+{
+  return m_frameCount;
+}
+
+void KX_KetsjiEngine::SetFrameLimit(unsigned int frames)
+{
+  m_frameLimit = frames;
+}
+
+void KX_KetsjiEngine::SetFrameTimingsFile(const std::string &filepath)
+{
+  m_frameTimingsFile = filepath;
+}
+
 int KX_KetsjiEngine::GetMaxLogicFrame()
 {
   return m_maxLogicFrame;
@@ -1523,6 +1852,7 @@ void KX_KetsjiEngine::ProcessScheduledScenes(void)
 {
   // Check whether there will be changes to the list of scenes
   if (m_replace_scenes.size() || m_removingScenes.size()) {
+    FinishPipelinedPhysics();
 
     // Change the scene list
     ReplaceScheduledScenes();
@@ -32,6 +32,8 @@
 
 #pragma once
 
+#include <array>
+#include <stdint.h>
 #include <string>
 #include <vector>
 
@@ -92,7 +94,17 @@ class KX_KetsjiEngine {
     /// Automatic add debug properties to the debug list.
     AUTO_ADD_DEBUG_PROPERTIES = (1 << 6),
     /// Use override camera?
-    CAMERA_OVERRIDE = (1 << 7)
+    CAMERA_OVERRIDE = (1 << 7),
+    /// Sleep until the next logic frame instead of polling the clock in fixed framerate.
+    FRAME_PACING = (1 << 8),
+    /// Reduce the number of logic frames per render frame to the measured frame costs.
+    ADAPTIVE_LOGIC_FRAMES = (1 << 9),
+    /// Run the physics step of the last logic frame while the frame is rendered.
+    RENDER_PIPELINING = (1 << 10),
+    /// Run the logic without canvas, GPU context and render, e.g. for a game server.
+    HEADLESS = (1 << 11),
+    /// Proceed one logic frame of the tic rate period per frame whatever the elapsed time.
+    FIXED_TIMESTEP = (1 << 12)
   };
 
  private:
@@ -194,6 +206,22 @@ class KX_KetsjiEngine {
 
   bool m_doRender; /* whether or not the scene should be rendered after the logic frame */
 
+  /// Maximum number of consecutive render frames skipped while the logic is late.
+  int m_maxDroppedRenders;
+  /// Number of render frames skipped since the last rendered frame.
+  int m_droppedRenders;
+  /// Average duration of a logic frame.
+  double m_logicFrameCost;
+  /// Average duration spent out of NextFrame for a rendered frame.
+  double m_renderCost;
+  /// Clock time at the end of the last NextFrame and whether the frame was rendered.
+  double m_lastNextFrameEnd;
+  bool m_lastFrameRendered;
+  /// Average oversleep of the system, the end of the wait for a frame is spun instead.
+  double m_pacingOversleep;
+  /// Average absolute difference between the frame start and its deadline.
+  double m_pacingJitter;
+
   /// Key used to exit the BGE
   short m_exitkey;
 
@@ -228,6 +256,15 @@ class KX_KetsjiEngine {
 
   /// Time logger.
   KX_TimeCategoryLogger m_logger;
+  /// Start time of the depsgraph update profile zone.
+  int64_t m_depsgraphProfileBegin;
+
+  /// Number of logic frames proceeded and number of logic frames before exiting, 0 for no limit.
+  unsigned int m_frameCount;
+  unsigned int m_frameLimit;
+  /// File receiving the time of every category for every measurement, empty for none.
+  std::string m_frameTimingsFile;
+  std::vector<std::array<double, tc_numCategories>> m_frameTimings;
 
   /// Labels for profiling display.
   static const std::string m_profileLabels[tc_numCategories];
@@ -288,6 +325,14 @@ class KX_KetsjiEngine {
 
   void BeginFrame();
   FrameTimes GetFrameTimes();
+  /// Sleep until the frame deadline and spin the last part the sleep isn't accurate enough for.
+  void WaitFrameDeadline(double deadline);
+  /// Apply the result of the pipelined physics steps of all the scenes.
+  void FinishPipelinedPhysics();
+  /// Start the next profiling measurement and store the last one for the frame timings file.
+  void NextMeasurement();
+  /// Write the frame timings as JSON if the file name ends by .json, else as CSV.
+  void WriteFrameTimings();
 
  public:
   KX_KetsjiEngine(KX_ISystem *system,
@@ -434,6 +479,30 @@ class KX_KetsjiEngine {
    */
   void SetMaxPhysicsFrame(int frame);
 
+  /**
+   * Gets the maximum number of consecutive render frames skipped when the logic is late.
+   */
+  int GetMaxDroppedRenders() const;
+  /**
+   * Sets the maximum number of consecutive render frames skipped when the logic is late,
+   * 0 to always render.
+   */
+  void SetMaxDroppedRenders(int renders);
+
+  /**
+   * Gets the number of logic frames proceeded since the engine start.
+   */
+  unsigned int GetFrameCount() const;
+  /**
+   * Sets the number of logic frames after which the game is quit, 0 for no limit.
+   */
+  void SetFrameLimit(unsigned int frames);
+  /**
+   * Sets the file the time of each profiling category is written to for every frame
+   * when the engine stops.
+   */
+  void SetFrameTimingsFile(const std::string &filepath);
+
   /**
    * Gets the framerate for playing animations. (actions and ipos)
    */
@@ -110,6 +110,11 @@ class KX_Scene *KX_LibLoadStatus::GetMergeScene()
   return m_mergescene;
 }
 
+void KX_LibLoadStatus::SetMergeScene(class KX_Scene *scene)
+{
+  m_mergescene = scene;
+}
+
 void KX_LibLoadStatus::SetData(void *data)
 {
   m_data = data;
@@ -60,6 +60,7 @@ class KX_LibLoadStatus : public EXP_PyObjectPlus {
   class BL_BlenderConverter *GetConverter();
   class KX_KetsjiEngine *GetEngine();
   class KX_Scene *GetMergeScene();
+  void SetMergeScene(class KX_Scene *scene);
 
   void SetData(void *data);
   void *GetData();
@@ -39,6 +39,7 @@
 #  include "KX_PolyProxy.h"
 #  include "KX_PyMath.h"
 #  include "KX_Scene.h"
+#  include "KX_VertexBuffer.h"
 #  include "KX_VertexProxy.h"
 #  include "RAS_BucketManager.h"
 #  include "RAS_DisplayArray.h"
@@ -93,6 +94,7 @@ PyMethodDef KX_MeshProxy::Methods[] = {
     {"transform", (PyCFunction)KX_MeshProxy::sPyTransform, METH_VARARGS},
     {"transformUV", (PyCFunction)KX_MeshProxy::sPyTransformUV, METH_VARARGS},
     {"replaceMaterial", (PyCFunction)KX_MeshProxy::sPyReplaceMaterial, METH_VARARGS},
+    {"getVertexBuffer", (PyCFunction)KX_MeshProxy::sPyGetVertexBuffer, METH_VARARGS},
     {nullptr, nullptr}  // Sentinel
 };
 
@@ -190,6 +192,41 @@ PyObject *KX_MeshProxy::PyGetVertex(PyObject *args, PyObject *kwds)
   return (new KX_VertexProxy(array, vertex))->NewProxy(true);
 }
 
+PyObject *KX_MeshProxy::PyGetVertexBuffer(PyObject *args, PyObject *kwds)
+{
+  int matindex;
+  const char *name;
+  int layer = 0;
+
+  if (!PyArg_ParseTuple(args, "is|i:getVertexBuffer", &matindex, &name, &layer))
+    return nullptr;
+
+  if (matindex < 0 || matindex >= m_meshobj->NumMaterials()) {
+    PyErr_SetString(PyExc_ValueError,
+                    "mesh.getVertexBuffer(mat_idx, type, layer): KX_MeshProxy, invalid material "
+                    "index");
+    return nullptr;
+  }
+
+  const KX_VertexBuffer::StreamType stream = KX_VertexBuffer::GetStreamType(name);
+  if (stream == KX_VertexBuffer::STREAM_MAX) {
+    PyErr_Format(PyExc_ValueError,
+                 "mesh.getVertexBuffer(mat_idx, type, layer): KX_MeshProxy, invalid type '%s', "
+                 "expected position, normal, tangent, uv or color",
+                 name);
+    return nullptr;
+  }
+
+  RAS_IDisplayArray *array = m_meshobj->GetDisplayArray(matindex);
+  if (layer < 0 || !KX_VertexBuffer::IsValidLayer(array, stream, layer)) {
+    PyErr_SetString(PyExc_ValueError,
+                    "mesh.getVertexBuffer(mat_idx, type, layer): KX_MeshProxy, invalid layer");
+    return nullptr;
+  }
+
+  return (new KX_VertexBuffer(array, stream, layer))->NewProxy(true);
+}
+
 PyObject *KX_MeshProxy::PyGetPolygon(PyObject *args, PyObject *kwds)
 {
   int polyindex = 1;
@@ -0,0 +1,293 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+#include "KX_NavMeshCrowd.h"
+
+#include "BLI_math_vector.h"
+
+#include "KX_NavMeshTileGrid.h"
+
+#define MAX_PATH_LEN 256
+#define DEFAULT_MAX_PATH_QUERIES 8
+static const float polyPickExt[3] = {2, 4, 2};
+
+static bool polysAreNeighbours(dtTiledNavMesh *navmesh, dtTilePolyRef a, dtTilePolyRef b)
+{
+  int index;
+  const dtTileHeader *header = KX_NavMeshTileGrid::GetPolyTile(navmesh, a, index);
+  if (!header) {
+    return false;
+  }
+  const dtTilePoly &poly = header->polys[index];
+  for (unsigned int i = 0; i < poly.nlinks; ++i) {
+    if (header->links[poly.links + i].ref == b) {
+      return true;
+    }
+  }
+  return false;
+}
+
+KX_NavMeshCrowd::KX_NavMeshCrowd(dtTiledNavMesh *navmesh)
+    : m_navMesh(navmesh), m_maxPathQueries(DEFAULT_MAX_PATH_QUERIES), m_lastUpdateTime(-1.0)
+{
+}
+
+KX_NavMeshCrowd::~KX_NavMeshCrowd()
+{
+}
+
+void KX_NavMeshCrowd::SetNavMesh(dtTiledNavMesh *navmesh)
+{
+  m_navMesh = navmesh;
+  for (Agent &agent : m_agents) {
+    agent.request = REQUEST_NONE;
+    agent.corridor.clear();
+  }
+  m_requests.clear();
+}
+
+void KX_NavMeshCrowd::UpdateTiles()
+{
+  // The references to the polygons of a replaced tile are no longer valid.
+  for (Agent &agent : m_agents) {
+    if (!agent.active || agent.request != REQUEST_VALID) {
+      continue;
+    }
+    // The unreachable targets may be reachable through the new tiles, search them again.
+    agent.targetRef = 0;
+    for (dtTilePolyRef ref : agent.corridor) {
+      if (!m_navMesh->getPolyByRef(ref)) {
+        agent.request = REQUEST_NONE;
+        agent.corridor.clear();
+        break;
+      }
+    }
+  }
+}
+
+int KX_NavMeshCrowd::AddAgent()
+{
+  int index;
+  if (m_freeAgents.empty()) {
+    index = m_agents.size();
+    m_agents.emplace_back();
+  }
+  else {
+    index = m_freeAgents.back();
+    m_freeAgents.pop_back();
+  }
+
+  Agent &agent = m_agents[index];
+  agent.active = true;
+  agent.request = REQUEST_NONE;
+  agent.targetRef = 0;
+  agent.corridor.clear();
+  zero_v3(agent.pos);
+  zero_v3(agent.target);
+
+  return index;
+}
+
+void KX_NavMeshCrowd::RemoveAgent(int agent)
+{
+  if (agent < 0 || agent >= (int)m_agents.size() || !m_agents[agent].active) {
+    return;
+  }
+
+  m_agents[agent].active = false;
+  m_agents[agent].request = REQUEST_NONE;
+  m_agents[agent].corridor.clear();
+  m_freeAgents.push_back(agent);
+}
+
+int KX_NavMeshCrowd::GetMaxPathQueries() const
+{
+  return m_maxPathQueries;
+}
+
+void KX_NavMeshCrowd::SetMaxPathQueries(int maxPathQueries)
+{
+  m_maxPathQueries = maxPathQueries;
+}
+
+int KX_NavMeshCrowd::GetNumPendingRequests() const
+{
+  return m_requests.size();
+}
+
+void KX_NavMeshCrowd::Update(double time)
+{
+  if (!m_navMesh || time == m_lastUpdateTime) {
+    return;
+  }
+  m_lastUpdateTime = time;
+
+  dtTilePolyRef polys[MAX_PATH_LEN];
+  int numQueries = 0;
+  while (numQueries < m_maxPathQueries && !m_requests.empty()) {
+    const int index = m_requests.front();
+    m_requests.pop_front();
+
+    Agent &agent = m_agents[index];
+    // The agent was removed or reused since its request.
+    if (!agent.active || agent.request != REQUEST_QUEUED) {
+      continue;
+    }
+
+    const dtTilePolyRef startRef = m_navMesh->findNearestPoly(agent.pos, polyPickExt);
+    const dtTilePolyRef endRef = m_navMesh->findNearestPoly(agent.target, polyPickExt);
+
+    int npolys = 0;
+    if (startRef && endRef) {
+      npolys = m_navMesh->findPath(
+          startRef, endRef, agent.pos, agent.target, polys, MAX_PATH_LEN);
+      ++numQueries;
+    }
+
+    agent.corridor.assign(polys, polys + npolys);
+    agent.targetRef = endRef;
+    agent.request = REQUEST_VALID;
+  }
+}
+
+bool KX_NavMeshCrowd::MoveStart(Agent &agent, dtTilePolyRef startRef)
+{
+  std::vector<dtTilePolyRef> &corridor = agent.corridor;
+  for (unsigned int i = 0, size = corridor.size(); i < size; ++i) {
+    if (corridor[i] == startRef) {
+      corridor.erase(corridor.begin(), corridor.begin() + i);
+      return true;
+    }
+  }
+
+  // The agent slipped to a polygon next to the corridor.
+  if (polysAreNeighbours(m_navMesh, corridor.front(), startRef)) {
+    corridor.insert(corridor.begin(), startRef);
+    return true;
+  }
+
+  return false;
+}
+
+bool KX_NavMeshCrowd::MoveTarget(Agent &agent, dtTilePolyRef endRef)
+{
+  std::vector<dtTilePolyRef> &corridor = agent.corridor;
+  for (unsigned int i = 0, size = corridor.size(); i < size; ++i) {
+    if (corridor[i] == endRef) {
+      corridor.resize(i + 1);
+      return true;
+    }
+  }
+
+  // The target moved to a polygon next to the corridor end.
+  if (polysAreNeighbours(m_navMesh, corridor.back(), endRef)) {
+    corridor.push_back(endRef);
+    return true;
+  }
+
+  return false;
+}
+
+bool KX_NavMeshCrowd::OptimizeVisibility(Agent &agent, dtTilePolyRef startRef, const float *corner)
+{
+  dtTilePolyRef visited[MAX_PATH_LEN];
+  float t;
+  const int nvisited = m_navMesh->raycast(startRef, agent.pos, corner, t, visited, MAX_PATH_LEN);
+  // A wall is between the agent and the corner.
+  if (t < 1.0f) {
+    return false;
+  }
+
+  // Find the furthest corridor polygon crossed by the ray and replace the corridor
+  // until it by the polygons of the ray.
+  std::vector<dtTilePolyRef> &corridor = agent.corridor;
+  for (int i = corridor.size() - 1; i > 0; --i) {
+    for (int j = nvisited - 1; j >= 0; --j) {
+      if (corridor[i] != visited[j]) {
+        continue;
+      }
+      if (j >= i) {
+        // The shortcut isn't shorter than the corridor.
+        return false;
+      }
+      corridor.erase(corridor.begin(), corridor.begin() + i);
+      corridor.insert(corridor.begin(), visited, visited + j);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+int KX_NavMeshCrowd::GetAgentPath(
+    int agent, const float *pos, const float *target, bool replan, float *path, int maxPathLen)
+{
+  if (!m_navMesh || agent < 0 || agent >= (int)m_agents.size()) {
+    return 0;
+  }
+
+  Agent &ag = m_agents[agent];
+  copy_v3_v3(ag.pos, pos);
+  copy_v3_v3(ag.target, target);
+
+  const dtTilePolyRef startRef = m_navMesh->findNearestPoly(pos, polyPickExt);
+  const dtTilePolyRef endRef = m_navMesh->findNearestPoly(target, polyPickExt);
+  if (!startRef || !endRef) {
+    return 0;
+  }
+
+  /* The last search was done for the same target polygon, if it didn't reach it the target
+   * is unreachable and searching again would give the same result. */
+  const bool sameTarget = (ag.request == REQUEST_VALID && ag.targetRef == endRef);
+  if (!replan && sameTarget && ag.corridor.empty()) {
+    return 0;
+  }
+
+  const bool startValid = !ag.corridor.empty() && MoveStart(ag, startRef);
+  // A partial corridor toward the same unreachable target is still the best path.
+  const bool targetValid = startValid && (MoveTarget(ag, endRef) || sameTarget);
+
+  /* Queue a path search when the corridor doesn't lead to the target anymore, meanwhile
+   * the agent keeps following its old corridor if it's still on it. */
+  if ((replan || !targetValid) && ag.request != REQUEST_QUEUED) {
+    ag.request = REQUEST_QUEUED;
+    m_requests.push_back(agent);
+  }
+
+  if (!startValid) {
+    return 0;
+  }
+
+  int pathLen = m_navMesh->findStraightPath(
+      pos, target, ag.corridor.data(), ag.corridor.size(), path, maxPathLen);
+
+  if (pathLen > 2 && ag.corridor.size() > 2) {
+    float corner[3];
+    copy_v3_v3(corner, &path[3 * 2]);
+    if (OptimizeVisibility(ag, startRef, corner)) {
+      pathLen = m_navMesh->findStraightPath(
+          pos, target, ag.corridor.data(), ag.corridor.size(), path, maxPathLen);
+    }
+  }
+
+  return pathLen;
+}
@@ -0,0 +1,96 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+#pragma once
+
+#include <deque>
+#include <vector>
+
+#include "DetourTileNavMesh.h"
+
+/** Crowd navigation on a tiled navigation mesh.
+ * Every agent keeps a corridor of polygons leading to its target, the corridor is
+ * trimmed and shortened as the agent moves and the straight path is extracted from it
+ * each frame. Full path searches are only done when the target leaves the corridor,
+ * they are queued and served with a limited number of searches per frame.
+ * All positions are in the navigation mesh space.
+ */
+class KX_NavMeshCrowd {
+ private:
+  enum RequestState { REQUEST_NONE = 0, REQUEST_QUEUED, REQUEST_VALID };
+
+  struct Agent {
+    bool active;
+    RequestState request;
+    /// Polygons from the agent polygon to the target polygon.
+    std::vector<dtTilePolyRef> corridor;
+    float pos[3];
+    float target[3];
+    /// Target polygon of the last completed path search, reached or not.
+    dtTilePolyRef targetRef;
+  };
+
+  dtTiledNavMesh *m_navMesh;
+  std::vector<Agent> m_agents;
+  std::vector<int> m_freeAgents;
+  /// Agents waiting for a path search, in request order.
+  std::deque<int> m_requests;
+  /// Maximum number of path searches per frame.
+  int m_maxPathQueries;
+  double m_lastUpdateTime;
+
+  /// Move the start of the corridor to the agent polygon, return false if the agent left it.
+  bool MoveStart(Agent &agent, dtTilePolyRef startRef);
+  /// Move the end of the corridor to the target polygon, return false if the target left it.
+  bool MoveTarget(Agent &agent, dtTilePolyRef endRef);
+  /// Skip the corridor polygons between the agent and a visible corner.
+  bool OptimizeVisibility(Agent &agent, dtTilePolyRef startRef, const float *corner);
+
+ public:
+  KX_NavMeshCrowd(dtTiledNavMesh *navmesh);
+  ~KX_NavMeshCrowd();
+
+  /// Change the navigation mesh, all the corridors are invalidated.
+  void SetNavMesh(dtTiledNavMesh *navmesh);
+  /// Invalidate the corridors crossing the tiles replaced by a rebuild.
+  void UpdateTiles();
+
+  int AddAgent();
+  void RemoveAgent(int agent);
+
+  int GetMaxPathQueries() const;
+  void SetMaxPathQueries(int maxPathQueries);
+  int GetNumPendingRequests() const;
+
+  /** Serve the queued path searches within the per frame budget, only the first call
+   * for a given logic time does the work.
+   */
+  void Update(double time);
+
+  /** Update the agent corridor for its current position and target and extract the
+   * straight path.
+   * \param replan Force a new path search even if the target is still in the corridor.
+   * \return The number of points in the path, zero while the path search is pending.
+   */
+  int GetAgentPath(
+      int agent, const float *pos, const float *target, bool replan, float *path, int maxPathLen);
+};
@@ -27,21 +27,25 @@
 
 #include "KX_NavMeshObject.h"
 
+#include <atomic>
+
 #include "BKE_cdderivedmesh.h"
 #include "BKE_DerivedMesh.h"
 #include "BKE_context.h"
 #include "BKE_layer.h"
 #include "BKE_scene.h"
 #include "BLI_sort.h"
+#include "BLI_task.h"
 #include "DEG_depsgraph_query.h"
 #include "MEM_guardedalloc.h"
 
 #include "BL_BlenderConverter.h"
 #include "CM_Message.h"
-#include "DetourStatNavMeshBuilder.h"
 #include "KX_Globals.h"
+#include "KX_NavMeshCrowd.h"
 #include "KX_ObstacleSimulation.h"
 #include "KX_PyMath.h"
+#include "KX_Scene.h"
 #include "RAS_IVertex.h"
 #include "RAS_Polygon.h"
 #include "Recast.h"
@@ -49,28 +53,6 @@
 #define MAX_PATH_LEN 256
 static const float polyPickExt[3] = {2, 4, 2};
 
-static void calcMeshBounds(const float *vert, int nverts, float *bmin, float *bmax)
-{
-  bmin[0] = bmax[0] = vert[0];
-  bmin[1] = bmax[1] = vert[1];
-  bmin[2] = bmax[2] = vert[2];
-  for (int i = 1; i < nverts; i++) {
-    if (bmin[0] > vert[3 * i + 0])
-      bmin[0] = vert[3 * i + 0];
-    if (bmin[1] > vert[3 * i + 1])
-      bmin[1] = vert[3 * i + 1];
-    if (bmin[2] > vert[3 * i + 2])
-      bmin[2] = vert[3 * i + 2];
-
-    if (bmax[0] < vert[3 * i + 0])
-      bmax[0] = vert[3 * i + 0];
-    if (bmax[1] < vert[3 * i + 1])
-      bmax[1] = vert[3 * i + 1];
-    if (bmax[2] < vert[3 * i + 2])
-      bmax[2] = vert[3 * i + 2];
-  }
-}
-
 inline void flipAxes(float *vec)
 {
   std::swap(vec[1], vec[2]);
@@ -575,15 +557,63 @@ static int polyFindVertex(const unsigned short *p,
   return res;
 }
 
+/// Navigation mesh arrays gathered from the mesh and the tiles built from them.
+struct KX_NavMeshBuildData {
+  float *vertices = nullptr;
+  float *dvertices = nullptr;
+  unsigned short *polys = nullptr;
+  unsigned short *dmeshes = nullptr;
+  unsigned short *dtris = nullptr;
+  int nverts = 0;
+  int npolys = 0;
+  int ndvertsuniq = 0;
+  int ndtris = 0;
+  int vertsPerPoly = 0;
+
+  /// The grid of the navigation mesh, only read by the background task.
+  const KX_NavMeshTileGrid *tileGrid = nullptr;
+  /// The tiles whose polygons changed.
+  std::vector<KX_NavMeshTileGrid::Tile> tiles;
+  /// Set by the background task once the tiles are built.
+  std::atomic<bool> done{false};
+
+  ~KX_NavMeshBuildData()
+  {
+    KX_NavMeshTileGrid::FreeTiles(tiles);
+    delete[] vertices;
+    delete[] dvertices;
+    /* navmesh conversion is using C guarded alloc for memory allocaitons */
+    if (polys)
+      MEM_freeN(polys);
+    if (dmeshes)
+      MEM_freeN(dmeshes);
+    if (dtris)
+      MEM_freeN(dtris);
+  }
+};
+
 KX_NavMeshObject::KX_NavMeshObject(void *sgReplicationInfo, SG_Callbacks callbacks)
-    : KX_GameObject(sgReplicationInfo, callbacks), m_navMesh(nullptr)
+    : KX_GameObject(sgReplicationInfo, callbacks),
+      m_navMesh(nullptr),
+      m_crowd(nullptr),
+      m_rebuildPool(nullptr),
+      m_rebuildData(nullptr),
+      m_rebuildRequested(false)
 {
 }
 
 KX_NavMeshObject::~KX_NavMeshObject()
 {
+  if (m_rebuildData) {
+    BLI_task_pool_work_and_wait(m_rebuildPool);
+    delete m_rebuildData;
+  }
+  if (m_rebuildPool)
+    BLI_task_pool_free(m_rebuildPool);
+  if (m_crowd)
+    delete m_crowd;
   if (m_navMesh)
-    delete m_navMesh;
+    KX_NavMeshTileGrid::FreeNavMesh(m_navMesh);
 }
 
 EXP_Value *KX_NavMeshObject::GetReplica()
@@ -597,6 +627,10 @@ void KX_NavMeshObject::ProcessReplica()
 {
   KX_GameObject::ProcessReplica();
   m_navMesh = nullptr; /* without this, building frees the navmesh we copied from */
+  m_crowd = nullptr;
+  m_rebuildPool = nullptr;
+  m_rebuildData = nullptr;
+  m_rebuildRequested = false;
   if (!BuildNavMesh()) {
     CM_FunctionError("unable to build navigation mesh");
     return;
@@ -786,246 +820,179 @@ bool KX_NavMeshObject::BuildVertIndArrays(float *&vertices,
   return true;
 }
 
-bool KX_NavMeshObject::BuildNavMesh()
+static void build_navmesh_task_func(TaskPool *__restrict UNUSED(pool), void *taskdata)
 {
-  if (m_navMesh) {
-    delete m_navMesh;
-    m_navMesh = nullptr;
-  }
+  KX_NavMeshBuildData *build = (KX_NavMeshBuildData *)taskdata;
+  build->tileGrid->BuildTiles(
+      build->vertices, build->polys, build->npolys, build->vertsPerPoly, build->tiles);
+  build->done = true;
+}
 
+KX_NavMeshBuildData *KX_NavMeshObject::GatherBuildData()
+{
   if (GetMeshCount() == 0) {
     CM_Error("can't find mesh for navmesh object: " << m_name);
-    return false;
+    return nullptr;
   }
 
-  float *vertices = nullptr, *dvertices = nullptr;
-  unsigned short *polys = nullptr, *dtris = nullptr, *dmeshes = nullptr;
-  int nverts = 0, npolys = 0, ndvertsuniq = 0, ndtris = 0;
-  int vertsPerPoly = 0;
-  if (!BuildVertIndArrays(vertices,
-                          nverts,
-                          polys,
-                          npolys,
-                          dmeshes,
-                          dvertices,
-                          ndvertsuniq,
-                          dtris,
-                          ndtris,
-                          vertsPerPoly) ||
-      vertsPerPoly < 3) {
+  KX_NavMeshBuildData *build = new KX_NavMeshBuildData();
+  if (!BuildVertIndArrays(build->vertices,
+                          build->nverts,
+                          build->polys,
+                          build->npolys,
+                          build->dmeshes,
+                          build->dvertices,
+                          build->ndvertsuniq,
+                          build->dtris,
+                          build->ndtris,
+                          build->vertsPerPoly) ||
+      build->vertsPerPoly < 3) {
     CM_Error("can't build navigation mesh data for object: " << m_name);
-    if (vertices) {
-      delete[] vertices;
-    }
-    if (dvertices) {
-      delete[] dvertices;
-    }
-    if (polys) {
-      MEM_freeN(polys);
-    }
-    if (dmeshes) {
-      MEM_freeN(dmeshes);
-    }
-    if (dtris) {
-      MEM_freeN(dtris);
-    }
-    return false;
+    delete build;
+    return nullptr;
   }
 
-  MT_Vector3 pos;
-  if (dmeshes == nullptr) {
-    for (int i = 0; i < nverts; i++) {
-      flipAxes(&vertices[i * 3]);
-    }
-    for (int i = 0; i < ndvertsuniq; i++) {
-      flipAxes(&dvertices[i * 3]);
+  if (build->dmeshes == nullptr) {
+    for (int i = 0; i < build->nverts; i++) {
+      flipAxes(&build->vertices[i * 3]);
     }
   }
 
-  if (!buildMeshAdjacency(polys, npolys, nverts, vertsPerPoly)) {
-    CM_FunctionError("unable to build mesh adjacency information.");
-    if (vertices) {
-      delete[] vertices;
-    }
-    if (dvertices) {
-      delete[] dvertices;
-    }
-    if (polys) {
-      MEM_freeN(polys);
-    }
-    if (dmeshes) {
-      MEM_freeN(dmeshes);
-    }
-    if (dtris) {
-      MEM_freeN(dtris);
+  // The polygons got denser than the tiles can hold, build all the tiles again.
+  if (m_navMesh &&
+      !m_tileGrid.Fits(build->vertices, build->polys, build->npolys, build->vertsPerPoly)) {
+    KX_NavMeshTileGrid::FreeNavMesh(m_navMesh);
+    m_navMesh = nullptr;
+    if (m_crowd)
+      m_crowd->SetNavMesh(nullptr);
+  }
+
+  if (!m_navMesh) {
+    // The tile grid is kept for the next rebuilds.
+    m_tileGrid.Init(
+        build->vertices, build->nverts, build->polys, build->npolys, build->vertsPerPoly);
+    if (m_tileGrid.IsInitialized()) {
+      m_navMesh = m_tileGrid.CreateNavMesh();
+      if (m_crowd)
+        m_crowd->SetNavMesh(m_navMesh);
     }
+  }
+  build->tileGrid = &m_tileGrid;
+
+  return build;
+}
+
+bool KX_NavMeshObject::BuildNavMesh()
+{
+  // A direct build supersedes the background rebuild.
+  if (m_rebuildData) {
+    BLI_task_pool_work_and_wait(m_rebuildPool);
+    delete m_rebuildData;
+    m_rebuildData = nullptr;
+    m_rebuildRequested = false;
+  }
+
+  if (m_navMesh) {
+    KX_NavMeshTileGrid::FreeNavMesh(m_navMesh);
+    m_navMesh = nullptr;
+    if (m_crowd)
+      m_crowd->SetNavMesh(nullptr);
+  }
+
+  // All the tiles are built in a new navigation mesh.
+  KX_NavMeshBuildData *build = GatherBuildData();
+  if (!build) {
+    return false;
+  }
+  if (!m_navMesh) {
+    delete build;
     return false;
   }
 
-  float cs = 0.2f;
+  m_tileGrid.BuildTiles(build->vertices, build->polys, build->npolys, build->vertsPerPoly,
+                        build->tiles);
+  m_tileGrid.ApplyTiles(m_navMesh, build->tiles);
+  delete build;
 
-  if (!nverts || !npolys) {
-    if (vertices) {
-      delete[] vertices;
-    }
-    if (dvertices) {
-      delete[] dvertices;
-    }
-    if (polys) {
-      MEM_freeN(polys);
-    }
-    if (dmeshes) {
-      MEM_freeN(dmeshes);
-    }
-    if (dtris) {
-      MEM_freeN(dtris);
-    }
+  if (m_crowd)
+    m_crowd->SetNavMesh(m_navMesh);
+
+  return true;
+}
+
+bool KX_NavMeshObject::StartRebuild()
+{
+  m_rebuildData = GatherBuildData();
+  if (!m_rebuildData) {
     return false;
   }
 
-  float bmin[3], bmax[3];
-  calcMeshBounds(vertices, nverts, bmin, bmax);
-  // quantize vertex pos
-  unsigned short *vertsi = new unsigned short[3 * nverts];
-  float ics = 1.f / cs;
-  for (int i = 0; i < nverts; i++) {
-    vertsi[3 * i + 0] = static_cast<unsigned short>((vertices[3 * i + 0] - bmin[0]) * ics);
-    vertsi[3 * i + 1] = static_cast<unsigned short>((vertices[3 * i + 1] - bmin[1]) * ics);
-    vertsi[3 * i + 2] = static_cast<unsigned short>((vertices[3 * i + 2] - bmin[2]) * ics);
+  if (!m_rebuildPool) {
+    m_rebuildPool = BLI_task_pool_create_background(nullptr, TASK_PRIORITY_LOW);
   }
+  BLI_task_pool_push(m_rebuildPool, build_navmesh_task_func, m_rebuildData, false, nullptr);
 
-  // Calculate data size
-  const int headerSize = sizeof(dtStatNavMeshHeader);
-  const int vertsSize = sizeof(float) * 3 * nverts;
-  const int polysSize = sizeof(dtStatPoly) * npolys;
-  const int nodesSize = sizeof(dtStatBVNode) * npolys * 2;
-  const int detailMeshesSize = sizeof(dtStatPolyDetail) * npolys;
-  const int detailVertsSize = sizeof(float) * 3 * ndvertsuniq;
-  const int detailTrisSize = sizeof(unsigned char) * 4 * ndtris;
-
-  const int dataSize = headerSize + vertsSize + polysSize + nodesSize + detailMeshesSize +
-                       detailVertsSize + detailTrisSize;
-  unsigned char *data = new unsigned char[dataSize];
-
-  memset(data, 0, dataSize);
-
-  unsigned char *d = data;
-  dtStatNavMeshHeader *header = (dtStatNavMeshHeader *)d;
-  d += headerSize;
-  float *navVerts = (float *)d;
-  d += vertsSize;
-  dtStatPoly *navPolys = (dtStatPoly *)d;
-  d += polysSize;
-  dtStatBVNode *navNodes = (dtStatBVNode *)d;
-  d += nodesSize;
-  dtStatPolyDetail *navDMeshes = (dtStatPolyDetail *)d;
-  d += detailMeshesSize;
-  float *navDVerts = (float *)d;
-  d += detailVertsSize;
-  unsigned char *navDTris = (unsigned char *)d;
-  d += detailTrisSize;
-
-  // Store header
-  header->magic = DT_STAT_NAVMESH_MAGIC;
-  header->version = DT_STAT_NAVMESH_VERSION;
-  header->npolys = npolys;
-  header->nverts = nverts;
-  header->cs = cs;
-  header->bmin[0] = bmin[0];
-  header->bmin[1] = bmin[1];
-  header->bmin[2] = bmin[2];
-  header->bmax[0] = bmax[0];
-  header->bmax[1] = bmax[1];
-  header->bmax[2] = bmax[2];
-  header->ndmeshes = npolys;
-  header->ndverts = ndvertsuniq;
-  header->ndtris = ndtris;
-
-  // Store vertices
-  for (int i = 0; i < nverts; ++i) {
-    const unsigned short *iv = &vertsi[i * 3];
-    float *v = &navVerts[i * 3];
-    v[0] = bmin[0] + iv[0] * cs;
-    v[1] = bmin[1] + iv[1] * cs;
-    v[2] = bmin[2] + iv[2] * cs;
+  return true;
+}
+
+bool KX_NavMeshObject::RebuildNavMesh()
+{
+  // Rebuild again once the current build is swapped, the geometry changed meanwhile.
+  if (m_rebuildData) {
+    m_rebuildRequested = true;
+    return true;
   }
-  // memcpy(navVerts, vertices, nverts*3*sizeof(float));
-
-  // Store polygons
-  const unsigned short *src = polys;
-  for (int i = 0; i < npolys; ++i) {
-    dtStatPoly *p = &navPolys[i];
-    p->nv = 0;
-    for (int j = 0; j < vertsPerPoly; ++j) {
-      if (src[j] == 0xffff)
-        break;
-      p->v[j] = src[j];
-      p->n[j] = src[vertsPerPoly + j] + 1;
-      p->nv++;
-    }
-    src += vertsPerPoly * 2;
+
+  if (!StartRebuild()) {
+    return false;
   }
 
-  header->nnodes = createBVTree(
-      vertsi, nverts, polys, npolys, vertsPerPoly, cs, cs, npolys * 2, navNodes);
-
-  if (dmeshes == nullptr) {
-    // create fake detail meshes
-    for (int i = 0; i < npolys; ++i) {
-      dtStatPolyDetail &dtl = navDMeshes[i];
-      dtl.vbase = 0;
-      dtl.nverts = 0;
-      dtl.tbase = i;
-      dtl.ntris = 1;
-    }
-    // setup triangles.
-    unsigned char *tri = navDTris;
-    for (size_t i = 0; i < ndtris; i++) {
-      for (size_t j = 0; j < 3; j++)
-        tri[4 * i + j] = j;
-    }
+  GetScene()->AddNavMeshRebuild(this);
+  return true;
+}
+
+bool KX_NavMeshObject::IsRebuilding() const
+{
+  return (m_rebuildData != nullptr);
+}
+
+bool KX_NavMeshObject::UpdateRebuild()
+{
+  if (!m_rebuildData) {
+    return false;
   }
-  else {
-    // verts
-    memcpy(navDVerts, dvertices, ndvertsuniq * 3 * sizeof(float));
-    // tris
-    unsigned char *tri = navDTris;
-    for (size_t i = 0; i < ndtris; i++) {
-      for (size_t j = 0; j < 3; j++)
-        tri[4 * i + j] = dtris[6 * i + j];
-    }
-    // detailed meshes
-    for (int i = 0; i < npolys; ++i) {
-      dtStatPolyDetail &dtl = navDMeshes[i];
-      dtl.vbase = dmeshes[i * 4 + 0];
-      dtl.nverts = dmeshes[i * 4 + 1];
-      dtl.tbase = dmeshes[i * 4 + 2];
-      dtl.ntris = dmeshes[i * 4 + 3];
-    }
+  if (!m_rebuildData->done) {
+    return true;
   }
 
-  m_navMesh = new dtStatNavMesh;
-  m_navMesh->init(data, dataSize, true);
+  BLI_task_pool_work_and_wait(m_rebuildPool);
 
-  delete[] vertices;
+  if (m_navMesh && !m_rebuildData->tiles.empty()) {
+    m_tileGrid.ApplyTiles(m_navMesh, m_rebuildData->tiles);
 
-  /* navmesh conversion is using C guarded alloc for memory allocaitons */
-  MEM_freeN(polys);
-  if (dmeshes)
-    MEM_freeN(dmeshes);
-  if (dtris)
-    MEM_freeN(dtris);
+    if (m_crowd)
+      m_crowd->UpdateTiles();
 
-  if (dvertices)
-    delete[] dvertices;
+    // Replace the walls obstacles of the previous tiles.
+    KX_ObstacleSimulation *obssimulation = GetScene()->GetObstacleSimulation();
+    if (obssimulation) {
+      obssimulation->DestroyObstacleForObj(this);
+      obssimulation->AddObstaclesForNavMesh(this);
+    }
+  }
 
-  if (vertsi)
-    delete[] vertsi;
+  delete m_rebuildData;
+  m_rebuildData = nullptr;
 
-  return true;
+  if (m_rebuildRequested) {
+    m_rebuildRequested = false;
+    return StartRebuild();
+  }
+
+  return false;
 }
 
-dtStatNavMesh *KX_NavMeshObject::GetNavMesh()
+dtTiledNavMesh *KX_NavMeshObject::GetNavMesh()
 {
   return m_navMesh;
 }
@@ -1036,56 +1003,62 @@ void KX_NavMeshObject::DrawNavMesh(NavMeshRenderMode renderMode)
     return;
   MT_Vector4 color(0.0f, 0.0f, 0.0f, 1.0f);
 
-  switch (renderMode) {
-    case RM_POLYS:
-    case RM_WALLS:
-      for (int pi = 0; pi < m_navMesh->getPolyCount(); pi++) {
-        const dtStatPoly *poly = m_navMesh->getPoly(pi);
-
-        for (int i = 0, j = (int)poly->nv - 1; i < (int)poly->nv; j = i++) {
-          if (poly->n[j] && renderMode == RM_WALLS)
-            continue;
-          const float *vif = m_navMesh->getVertex(poly->v[i]);
-          const float *vjf = m_navMesh->getVertex(poly->v[j]);
-          MT_Vector3 vi(vif[0], vif[2], vif[1]);
-          MT_Vector3 vj(vjf[0], vjf[2], vjf[1]);
-          vi = TransformToWorldCoords(vi);
-          vj = TransformToWorldCoords(vj);
-          KX_RasterizerDrawDebugLine(vi, vj, color);
-        }
-      }
-      break;
-    case RM_TRIS:
-      for (int i = 0; i < m_navMesh->getPolyDetailCount(); ++i) {
-        const dtStatPoly *p = m_navMesh->getPoly(i);
-        const dtStatPolyDetail *pd = m_navMesh->getPolyDetail(i);
-
-        for (int j = 0; j < pd->ntris; ++j) {
-          const unsigned char *t = m_navMesh->getDetailTri(pd->tbase + j);
-          MT_Vector3 tri[3];
-          for (int k = 0; k < 3; ++k) {
-            const float *v;
-            if (t[k] < p->nv)
-              v = m_navMesh->getVertex(p->v[t[k]]);
-            else
-              v = m_navMesh->getDetailVertex(pd->vbase + (t[k] - p->nv));
-            float pos[3];
-            rcVcopy(pos, v);
-            flipAxes(pos);
-            tri[k].setValue(pos);
+  for (int ti = 0; ti < DT_MAX_TILES; ti++) {
+    const dtTileHeader *header = m_navMesh->getTile(ti)->header;
+    if (!header)
+      continue;
+
+    switch (renderMode) {
+      case RM_POLYS:
+      case RM_WALLS:
+        for (int pi = 0; pi < header->npolys; pi++) {
+          const dtTilePoly *poly = &header->polys[pi];
+
+          for (int i = 0, j = (int)poly->nv - 1; i < (int)poly->nv; j = i++) {
+            if (renderMode == RM_WALLS && !KX_NavMeshTileGrid::IsWallEdge(header, poly, j))
+              continue;
+            const float *vif = &header->verts[poly->v[i] * 3];
+            const float *vjf = &header->verts[poly->v[j] * 3];
+            MT_Vector3 vi(vif[0], vif[2], vif[1]);
+            MT_Vector3 vj(vjf[0], vjf[2], vjf[1]);
+            vi = TransformToWorldCoords(vi);
+            vj = TransformToWorldCoords(vj);
+            KX_RasterizerDrawDebugLine(vi, vj, color);
           }
+        }
+        break;
+      case RM_TRIS:
+        for (int i = 0; i < header->ndmeshes; ++i) {
+          const dtTilePoly *p = &header->polys[i];
+          const dtTilePolyDetail *pd = &header->dmeshes[i];
+
+          for (int j = 0; j < pd->ntris; ++j) {
+            const unsigned char *t = &header->dtris[(pd->tbase + j) * 4];
+            MT_Vector3 tri[3];
+            for (int k = 0; k < 3; ++k) {
+              const float *v;
+              if (t[k] < p->nv)
+                v = &header->verts[p->v[t[k]] * 3];
+              else
+                v = &header->dverts[(pd->vbase + (t[k] - p->nv)) * 3];
+              float pos[3];
+              rcVcopy(pos, v);
+              flipAxes(pos);
+              tri[k].setValue(pos);
+            }
 
-          for (int k = 0; k < 3; k++)
-            tri[k] = TransformToWorldCoords(tri[k]);
+            for (int k = 0; k < 3; k++)
+              tri[k] = TransformToWorldCoords(tri[k]);
 
-          for (int k = 0; k < 3; k++)
-            KX_RasterizerDrawDebugLine(tri[k], tri[(k + 1) % 3], color);
+            for (int k = 0; k < 3; k++)
+              KX_RasterizerDrawDebugLine(tri[k], tri[(k + 1) % 3], color);
+          }
         }
-      }
-      break;
-    default:
-      /* pass */
-      break;
+        break;
+      default:
+        /* pass */
+        break;
+    }
   }
 }
 
@@ -1125,12 +1098,12 @@ int KX_NavMeshObject::FindPath(const MT_Vector3 &from,
   flipAxes(spos);
   localto.getValue(epos);
   flipAxes(epos);
-  dtStatPolyRef sPolyRef = m_navMesh->findNearestPoly(spos, polyPickExt);
-  dtStatPolyRef ePolyRef = m_navMesh->findNearestPoly(epos, polyPickExt);
+  dtTilePolyRef sPolyRef = m_navMesh->findNearestPoly(spos, polyPickExt);
+  dtTilePolyRef ePolyRef = m_navMesh->findNearestPoly(epos, polyPickExt);
 
   int pathLen = 0;
   if (sPolyRef && ePolyRef) {
-    dtStatPolyRef *polys = new dtStatPolyRef[maxPathLen];
+    dtTilePolyRef *polys = new dtTilePolyRef[maxPathLen];
     int npolys;
     npolys = m_navMesh->findPath(sPolyRef, ePolyRef, spos, epos, polys, maxPathLen);
     if (npolys) {
@@ -1160,13 +1133,53 @@ float KX_NavMeshObject::Raycast(const MT_Vector3 &from, const MT_Vector3 &to)
   flipAxes(spos);
   localto.getValue(epos);
   flipAxes(epos);
-  dtStatPolyRef sPolyRef = m_navMesh->findNearestPoly(spos, polyPickExt);
+  dtTilePolyRef sPolyRef = m_navMesh->findNearestPoly(spos, polyPickExt);
   float t = 0;
-  static dtStatPolyRef polys[MAX_PATH_LEN];
+  static dtTilePolyRef polys[MAX_PATH_LEN];
   m_navMesh->raycast(sPolyRef, spos, epos, t, polys, MAX_PATH_LEN);
   return t;
 }
 
+KX_NavMeshCrowd *KX_NavMeshObject::GetCrowd()
+{
+  if (!m_crowd)
+    m_crowd = new KX_NavMeshCrowd(m_navMesh);
+  return m_crowd;
+}
+
+int KX_NavMeshObject::FindCrowdPath(int agent,
+                                    const MT_Vector3 &from,
+                                    const MT_Vector3 &to,
+                                    bool replan,
+                                    double time,
+                                    float *path,
+                                    int maxPathLen)
+{
+  if (!m_navMesh)
+    return 0;
+  KX_NavMeshCrowd *crowd = GetCrowd();
+  // Serve the searches queued during the previous frame.
+  crowd->Update(time);
+
+  MT_Vector3 localfrom = TransformToLocalCoords(from);
+  MT_Vector3 localto = TransformToLocalCoords(to);
+  float spos[3], epos[3];
+  localfrom.getValue(spos);
+  flipAxes(spos);
+  localto.getValue(epos);
+  flipAxes(epos);
+
+  int pathLen = crowd->GetAgentPath(agent, spos, epos, replan, path, maxPathLen);
+  for (int i = 0; i < pathLen; i++) {
+    flipAxes(&path[i * 3]);
+    MT_Vector3 waypoint(&path[i * 3]);
+    waypoint = TransformToWorldCoords(waypoint);
+    waypoint.getValue(&path[i * 3]);
+  }
+
+  return pathLen;
+}
+
 void KX_NavMeshObject::DrawPath(const float *path, int pathLen, const MT_Vector4 &color)
 {
   MT_Vector3 a, b;
@@ -1220,6 +1233,11 @@ PyTypeObject KX_NavMeshObject::Type = {PyVarObject_HEAD_INIT(nullptr, 0) "KX_Nav
                                        py_base_new};
 
 PyAttributeDef KX_NavMeshObject::Attributes[] = {
+    EXP_PYATTRIBUTE_RO_FUNCTION("rebuilding", KX_NavMeshObject, pyattr_get_rebuilding),
+    EXP_PYATTRIBUTE_RW_FUNCTION("crowdMaxPathQueries",
+                                KX_NavMeshObject,
+                                pyattr_get_crowd_max_path_queries,
+                                pyattr_set_crowd_max_path_queries),
     EXP_PYATTRIBUTE_NULL  // Sentinel
 };
 
@@ -1283,10 +1301,51 @@ EXP_PYMETHODDEF_DOC(KX_NavMeshObject,
   Py_RETURN_NONE;
 }
 
-EXP_PYMETHODDEF_DOC_NOARGS(KX_NavMeshObject, rebuild, "rebuild(): rebuild navigation mesh\n")
+EXP_PYMETHODDEF_DOC(KX_NavMeshObject,
+                    rebuild,
+                    "rebuild(background=False): rebuild navigation mesh\n"
+                    "background: build in a background task and swap at the next frame\n")
 {
-  BuildNavMesh();
+  int background = 0;
+  if (!PyArg_ParseTuple(args, "|i:rebuild", &background))
+    return nullptr;
+
+  if (background)
+    RebuildNavMesh();
+  else
+    BuildNavMesh();
   Py_RETURN_NONE;
 }
 
+PyObject *KX_NavMeshObject::pyattr_get_rebuilding(EXP_PyObjectPlus *self_v,
+                                                  const EXP_PYATTRIBUTE_DEF *attrdef)
+{
+  KX_NavMeshObject *self = static_cast<KX_NavMeshObject *>(self_v);
+  return PyBool_FromLong(self->IsRebuilding());
+}
+
+PyObject *KX_NavMeshObject::pyattr_get_crowd_max_path_queries(EXP_PyObjectPlus *self_v,
+                                                              const EXP_PYATTRIBUTE_DEF *attrdef)
+{
+  KX_NavMeshObject *self = static_cast<KX_NavMeshObject *>(self_v);
+  return PyLong_FromLong(self->GetCrowd()->GetMaxPathQueries());
+}
+
+int KX_NavMeshObject::pyattr_set_crowd_max_path_queries(EXP_PyObjectPlus *self_v,
+                                                        const EXP_PYATTRIBUTE_DEF *attrdef,
+                                                        PyObject *value)
+{
+  KX_NavMeshObject *self = static_cast<KX_NavMeshObject *>(self_v);
+  const int maxPathQueries = PyLong_AsLong(value);
+  if (maxPathQueries < 1 || PyErr_Occurred()) {
+    PyErr_SetString(PyExc_ValueError,
+                    "navmesh.crowdMaxPathQueries = int: KX_NavMeshObject, expected an integer "
+                    "greater than 0");
+    return PY_SET_ATTR_FAIL;
+  }
+
+  self->GetCrowd()->SetMaxPathQueries(maxPathQueries);
+  return PY_SET_ATTR_SUCCESS;
+}
+
 #endif  // WITH_PYTHON
@@ -28,17 +28,35 @@
 
 #include <vector>
 
-#include "DetourStatNavMesh.h"
+#include "DetourTileNavMesh.h"
 #include "EXP_PyObjectPlus.h"
 #include "KX_GameObject.h"
+#include "KX_NavMeshTileGrid.h"
 
+class KX_NavMeshCrowd;
+struct KX_NavMeshBuildData;
+struct TaskPool;
 class RAS_MeshObject;
 class MT_Transform;
 
 class KX_NavMeshObject : public KX_GameObject {
   Py_Header
 
-      protected : dtStatNavMesh *m_navMesh;
+      protected : dtTiledNavMesh *m_navMesh;
+  /// Tiles of the navigation mesh, only the tiles whose polygons changed are rebuilt.
+  KX_NavMeshTileGrid m_tileGrid;
+  /// Crowd of the steering actuators using this navigation mesh, created on demand.
+  KX_NavMeshCrowd *m_crowd;
+  /// Pool running the background rebuild.
+  TaskPool *m_rebuildPool;
+  /// Data of the running background rebuild, nullptr if none.
+  KX_NavMeshBuildData *m_rebuildData;
+  /// Geometry changed during the background rebuild, rebuild again after.
+  bool m_rebuildRequested;
+
+  /// Gather the navigation polygons from the mesh, must run in the main thread.
+  KX_NavMeshBuildData *GatherBuildData();
+  bool StartRebuild();
 
   bool BuildVertIndArrays(float *&vertices,
                           int &nverts,
@@ -59,10 +77,32 @@ class KX_NavMeshObject : public KX_GameObject {
   virtual void ProcessReplica();
 
   bool BuildNavMesh();
-  dtStatNavMesh *GetNavMesh();
+  /** Rebuild the tiles whose polygons changed in a background task, the current tiles
+   * are used until the new ones are swapped in by UpdateRebuild.
+   */
+  bool RebuildNavMesh();
+  bool IsRebuilding() const;
+  /** Swap in the rebuilt tiles once the background rebuild is done, called by the scene
+   * at the beginning of the logic frame.
+   * \return True while a rebuild is running.
+   */
+  bool UpdateRebuild();
+  dtTiledNavMesh *GetNavMesh();
   int FindPath(const MT_Vector3 &from, const MT_Vector3 &to, float *path, int maxPathLen);
   float Raycast(const MT_Vector3 &from, const MT_Vector3 &to);
 
+  KX_NavMeshCrowd *GetCrowd();
+  /** Return the path of a crowd agent, path searches are queued and served with a
+   * limited number per frame, the returned path is empty until the first search is done.
+   */
+  int FindCrowdPath(int agent,
+                    const MT_Vector3 &from,
+                    const MT_Vector3 &to,
+                    bool replan,
+                    double time,
+                    float *path,
+                    int maxPathLen);
+
   enum NavMeshRenderMode { RM_WALLS, RM_POLYS, RM_TRIS, RM_MAX };
   void DrawNavMesh(NavMeshRenderMode mode);
   void DrawPath(const float *path, int pathLen, const MT_Vector4 &color);
@@ -77,6 +117,14 @@ class KX_NavMeshObject : public KX_GameObject {
   EXP_PYMETHOD_DOC(KX_NavMeshObject, findPath);
   EXP_PYMETHOD_DOC(KX_NavMeshObject, raycast);
   EXP_PYMETHOD_DOC(KX_NavMeshObject, draw);
-  EXP_PYMETHOD_DOC_NOARGS(KX_NavMeshObject, rebuild);
+  EXP_PYMETHOD_DOC(KX_NavMeshObject, rebuild);
+
+  static PyObject *pyattr_get_rebuilding(EXP_PyObjectPlus *self_v,
+                                         const EXP_PYATTRIBUTE_DEF *attrdef);
+  static PyObject *pyattr_get_crowd_max_path_queries(EXP_PyObjectPlus *self_v,
+                                                     const EXP_PYATTRIBUTE_DEF *attrdef);
+  static int pyattr_set_crowd_max_path_queries(EXP_PyObjectPlus *self_v,
+                                               const EXP_PYATTRIBUTE_DEF *attrdef,
+                                               PyObject *value);
 #endif /* WITH_PYTHON */
 };
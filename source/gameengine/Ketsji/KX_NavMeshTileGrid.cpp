@@ -0,0 +1,536 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+#include "KX_NavMeshTileGrid.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#include "CM_Message.h"
+#include "DetourTileNavMeshBuilder.h"
+#include "Recast.h"
+
+/// Size of the cells used to quantize the vertices.
+static const float cellSize = 0.2f;
+/// Height of the portals between the tiles.
+static const float portalHeight = 4.0f * cellSize;
+/// Average number of polygons per tile, a tile holds at most DT_MAX_POLYGONS.
+static const float tilePolygons = 32.0f;
+/// Maximum number of tiles along an axis for the initial tile size.
+static const int maxTilesPerAxis = 60;
+/// Maximum number of halvings of the tile size to fit the densest tile.
+static const int maxTileSplits = 8;
+
+static uint64_t tileKey(int x, int y)
+{
+  return ((uint64_t)(uint32_t)x << 32) | (uint32_t)y;
+}
+
+/// Return the number of vertices of a polygon and the range of the tiles overlapping it.
+static int polyTileRange(const float *verts,
+                         const unsigned short *poly,
+                         int vertsPerPoly,
+                         const float orig[3],
+                         float tileSize,
+                         int range[4])
+{
+  int nv = 0;
+  float pmin[2] = {FLT_MAX, FLT_MAX}, pmax[2] = {-FLT_MAX, -FLT_MAX};
+  for (; nv < vertsPerPoly && poly[nv] != 0xffff; ++nv) {
+    const float *v = &verts[poly[nv] * 3];
+    pmin[0] = std::min(pmin[0], v[0]);
+    pmin[1] = std::min(pmin[1], v[2]);
+    pmax[0] = std::max(pmax[0], v[0]);
+    pmax[1] = std::max(pmax[1], v[2]);
+  }
+  range[0] = (int)std::floor((pmin[0] - orig[0]) / tileSize);
+  range[1] = (int)std::floor((pmax[0] - orig[0]) / tileSize);
+  range[2] = (int)std::floor((pmin[1] - orig[2]) / tileSize);
+  range[3] = (int)std::floor((pmax[1] - orig[2]) / tileSize);
+  return nv;
+}
+
+/** Compute the maximum number of Detour polygons built in a tile and the number of tiles.
+ * A polygon gains a vertex per tile border crossing it and is split in fans of
+ * DT_TILE_VERTS_PER_POLYGON vertices.
+ */
+static void countTilePolygons(const float *verts,
+                              const unsigned short *polys,
+                              int npolys,
+                              int vertsPerPoly,
+                              const float orig[3],
+                              float tileSize,
+                              int &maxPolys,
+                              int &ntiles)
+{
+  const int fan = DT_TILE_VERTS_PER_POLYGON - 2;
+  std::unordered_map<uint64_t, int> counts;
+  for (int i = 0; i < npolys; ++i) {
+    int range[4];
+    const int nv = polyTileRange(
+        verts, &polys[i * vertsPerPoly * 2], vertsPerPoly, orig, tileSize, range);
+    if (nv < 3) {
+      continue;
+    }
+    for (int y = range[2]; y <= range[3]; ++y) {
+      for (int x = range[0]; x <= range[1]; ++x) {
+        const int clipped = (x != range[0]) + (x != range[1]) + (y != range[2]) +
+                            (y != range[3]);
+        counts[tileKey(x, y)] += (nv + clipped - 2 + fan - 1) / fan;
+      }
+    }
+  }
+
+  maxPolys = 0;
+  for (const auto &item : counts) {
+    maxPolys = std::max(maxPolys, item.second);
+  }
+  ntiles = counts.size();
+}
+
+static unsigned int polyHash(const float *verts, const unsigned short *poly, int nv)
+{
+  // FNV-1a of the vertex positions.
+  unsigned int hash = 2166136261u;
+  for (int i = 0; i < nv; ++i) {
+    const unsigned char *bytes = (const unsigned char *)&verts[poly[i] * 3];
+    for (unsigned int j = 0; j < sizeof(float) * 3; ++j) {
+      hash = (hash ^ bytes[j]) * 16777619u;
+    }
+  }
+  return hash;
+}
+
+/// Clip a convex polygon to a side of an axis aligned plane, the new points are on the plane.
+static void clipPolygon(
+    const std::vector<float> &in, std::vector<float> &out, int axis, float value, bool keepAbove)
+{
+  out.clear();
+  const int nv = in.size() / 3;
+  for (int i = 0, j = nv - 1; i < nv; j = i++) {
+    const float *a = &in[j * 3];
+    const float *b = &in[i * 3];
+    const float da = keepAbove ? a[axis] - value : value - a[axis];
+    const float db = keepAbove ? b[axis] - value : value - b[axis];
+    if ((da >= 0.0f) != (db >= 0.0f)) {
+      const float t = da / (da - db);
+      for (int k = 0; k < 3; ++k) {
+        out.push_back((k == axis) ? value : a[k] + (b[k] - a[k]) * t);
+      }
+    }
+    if (db >= 0.0f) {
+      out.insert(out.end(), b, b + 3);
+    }
+  }
+}
+
+KX_NavMeshTileGrid::KX_NavMeshTileGrid() : m_tileSize(0.0f), m_maxPolygons(DT_MAX_POLYGONS)
+{
+  m_orig[0] = m_orig[1] = m_orig[2] = 0.0f;
+}
+
+void KX_NavMeshTileGrid::Init(
+    const float *verts, int nverts, const unsigned short *polys, int npolys, int vertsPerPoly)
+{
+  m_tileHashes.clear();
+  m_tileSize = 0.0f;
+  m_maxPolygons = DT_MAX_POLYGONS;
+  if (nverts == 0 || npolys == 0) {
+    return;
+  }
+
+  float bmin[3], bmax[3];
+  for (int k = 0; k < 3; ++k) {
+    bmin[k] = bmax[k] = verts[k];
+  }
+  for (int i = 1; i < nverts; ++i) {
+    for (int k = 0; k < 3; ++k) {
+      bmin[k] = std::min(bmin[k], verts[i * 3 + k]);
+      bmax[k] = std::max(bmax[k], verts[i * 3 + k]);
+    }
+  }
+
+  const float width = std::max(bmax[0] - bmin[0], cellSize);
+  const float depth = std::max(bmax[2] - bmin[2], cellSize);
+  float size = std::sqrt(width * depth * tilePolygons / npolys);
+  size = std::max(size, std::max(width, depth) / maxTilesPerAxis);
+  // A whole number of cells puts the tile borders on the quantized positions.
+  m_tileSize = std::max(std::ceil(size / cellSize), 1.0f) * cellSize;
+  for (int k = 0; k < 3; ++k) {
+    m_orig[k] = bmin[k];
+  }
+
+  // Split the tiles while the densest one exceeds the polygons of a tile.
+  int maxPolys, ntiles;
+  countTilePolygons(verts, polys, npolys, vertsPerPoly, m_orig, m_tileSize, maxPolys, ntiles);
+  for (int i = 0; i < maxTileSplits && maxPolys > DT_MAX_POLYGONS; ++i) {
+    const float tileSize = std::max(std::floor(m_tileSize / cellSize / 2.0f), 1.0f) * cellSize;
+    int splitMaxPolys, splitTiles;
+    countTilePolygons(
+        verts, polys, npolys, vertsPerPoly, m_orig, tileSize, splitMaxPolys, splitTiles);
+    if (tileSize == m_tileSize || splitTiles > DT_MAX_TILES) {
+      break;
+    }
+    m_tileSize = tileSize;
+    maxPolys = splitMaxPolys;
+  }
+
+  if (maxPolys > DT_MAX_POLYGONS) {
+    m_maxPolygons = maxPolys;
+    CM_Warning("navigation mesh too dense for " << DT_MAX_TILES << " tiles, a tile may have "
+               << maxPolys << " polygons > " << DT_MAX_POLYGONS);
+  }
+}
+
+bool KX_NavMeshTileGrid::Fits(const float *verts,
+                              const unsigned short *polys,
+                              int npolys,
+                              int vertsPerPoly) const
+{
+  int maxPolys, ntiles;
+  countTilePolygons(verts, polys, npolys, vertsPerPoly, m_orig, m_tileSize, maxPolys, ntiles);
+  return (maxPolys <= m_maxPolygons && ntiles <= DT_MAX_TILES);
+}
+
+bool KX_NavMeshTileGrid::IsInitialized() const
+{
+  return (m_tileSize > 0.0f);
+}
+
+bool KX_NavMeshTileGrid::BuildTile(int x,
+                                   int y,
+                                   const float *verts,
+                                   const unsigned short *polys,
+                                   const std::vector<int> &tilePolys,
+                                   int vertsPerPoly,
+                                   Tile &tile) const
+{
+  const int nvp = DT_TILE_VERTS_PER_POLYGON;
+  const int cells = (int)std::lround(m_tileSize / cellSize);
+  const float tmin[2] = {m_orig[0] + x * m_tileSize, m_orig[2] + y * m_tileSize};
+  const float tmax[2] = {tmin[0] + m_tileSize, tmin[1] + m_tileSize};
+
+  // Clip the polygons to the tile.
+  std::vector<std::vector<float>> clipped;
+  std::vector<float> points, tmp;
+  float ymin = FLT_MAX, ymax = -FLT_MAX;
+  for (int pi : tilePolys) {
+    const unsigned short *poly = &polys[pi * vertsPerPoly * 2];
+    points.clear();
+    for (int j = 0; j < vertsPerPoly && poly[j] != 0xffff; ++j) {
+      points.insert(points.end(), &verts[poly[j] * 3], &verts[poly[j] * 3 + 3]);
+    }
+    clipPolygon(points, tmp, 0, tmin[0], true);
+    clipPolygon(tmp, points, 0, tmax[0], false);
+    clipPolygon(points, tmp, 2, tmin[1], true);
+    clipPolygon(tmp, points, 2, tmax[1], false);
+    if (points.size() < 9) {
+      continue;
+    }
+    for (unsigned int i = 1; i < points.size(); i += 3) {
+      ymin = std::min(ymin, points[i]);
+      ymax = std::max(ymax, points[i]);
+    }
+    clipped.push_back(points);
+  }
+
+  // The quantized vertices are stored in 16 bits.
+  if (!clipped.empty() && (ymax - ymin) / cellSize >= 0xffff) {
+    CM_Warning("navigation mesh tile (" << x << ", " << y << ") is too high");
+    return false;
+  }
+
+  // Quantize and weld the vertices, split the polygons exceeding the Detour vertex count.
+  std::vector<unsigned short> qverts;
+  std::vector<unsigned short> qpolys;
+  std::unordered_map<uint64_t, unsigned short> vertMap;
+  std::vector<unsigned short> indices;
+  for (const std::vector<float> &clippedPoly : clipped) {
+    indices.clear();
+    for (unsigned int i = 0; i < clippedPoly.size(); i += 3) {
+      const int q[3] = {
+          std::clamp((int)std::lround((clippedPoly[i] - tmin[0]) / cellSize), 0, cells),
+          (int)std::lround((clippedPoly[i + 1] - ymin) / cellSize),
+          std::clamp((int)std::lround((clippedPoly[i + 2] - tmin[1]) / cellSize), 0, cells)};
+      const uint64_t key = (uint64_t)q[0] | ((uint64_t)q[1] << 21) | ((uint64_t)q[2] << 42);
+      auto it = vertMap.find(key);
+      if (it == vertMap.end()) {
+        if (qverts.size() / 3 >= 0xfffe) {
+          CM_Warning("too many vertices in navigation mesh tile (" << x << ", " << y << ")");
+          return false;
+        }
+        it = vertMap.emplace(key, qverts.size() / 3).first;
+        qverts.insert(qverts.end(), q, q + 3);
+      }
+      if (indices.empty() || indices.back() != it->second) {
+        indices.push_back(it->second);
+      }
+    }
+    while (indices.size() > 1 && indices.front() == indices.back()) {
+      indices.pop_back();
+    }
+
+    const int nv = indices.size();
+    int area = 0;
+    for (int i = 0, j = nv - 1; i < nv; j = i++) {
+      const unsigned short *a = &qverts[indices[j] * 3];
+      const unsigned short *b = &qverts[indices[i] * 3];
+      area += (int)a[0] * b[2] - (int)b[0] * a[2];
+    }
+    // Polygons flattened by the quantization are dropped.
+    if (nv < 3 || area == 0) {
+      continue;
+    }
+
+    for (int start = 1; start < nv - 1; start += nvp - 2) {
+      const int end = std::min(start + nvp - 2, nv - 1);
+      const unsigned int base = qpolys.size();
+      qpolys.resize(base + nvp * 2, 0xffff);
+      qpolys[base] = indices[0];
+      for (int i = start; i <= end; ++i) {
+        qpolys[base + 1 + i - start] = indices[i];
+      }
+    }
+  }
+
+  const int nverts = qverts.size() / 3;
+  const int npolys = qpolys.size() / (nvp * 2);
+  if (npolys == 0) {
+    tile.data = nullptr;
+    tile.dataSize = 0;
+    return true;
+  }
+  if (npolys > DT_MAX_POLYGONS) {
+    CM_Warning("too many polygons in navigation mesh tile (" << x << ", " << y << "), "
+               << npolys << " > " << DT_MAX_POLYGONS);
+    return false;
+  }
+
+  if (!buildMeshAdjacency(qpolys.data(), npolys, nverts, nvp)) {
+    CM_Warning("unable to build adjacency of navigation mesh tile (" << x << ", " << y << ")");
+    return false;
+  }
+
+  /* The detail meshes are a triangle fan of each polygon, the heights inside the polygons
+   * are interpolated from its vertices. */
+  std::vector<unsigned short> dmeshes(npolys * 4);
+  std::vector<unsigned char> dtris;
+  for (int i = 0; i < npolys; ++i) {
+    const unsigned short *poly = &qpolys[i * nvp * 2];
+    int nv = 0;
+    while (nv < nvp && poly[nv] != 0xffff) {
+      ++nv;
+    }
+    dmeshes[i * 4 + 0] = 0;
+    dmeshes[i * 4 + 1] = nv;
+    dmeshes[i * 4 + 2] = dtris.size() / 4;
+    dmeshes[i * 4 + 3] = nv - 2;
+    for (int j = 1; j < nv - 1; ++j) {
+      const unsigned char tri[4] = {0, (unsigned char)j, (unsigned char)(j + 1), 0};
+      dtris.insert(dtris.end(), tri, tri + 4);
+    }
+  }
+  // No detail vertex is used but the builder requires an array.
+  static const float dverts[3] = {0.0f, 0.0f, 0.0f};
+
+  const float bmin[3] = {tmin[0], ymin, tmin[1]};
+  const float bmax[3] = {tmax[0], ymax, tmax[1]};
+  if (!dtCreateNavMeshTileData(qverts.data(),
+                               nverts,
+                               qpolys.data(),
+                               npolys,
+                               nvp,
+                               dmeshes.data(),
+                               dverts,
+                               0,
+                               dtris.data(),
+                               dtris.size() / 4,
+                               bmin,
+                               bmax,
+                               cellSize,
+                               cellSize,
+                               cells,
+                               0,
+                               &tile.data,
+                               &tile.dataSize)) {
+    CM_Warning("unable to create navigation mesh tile (" << x << ", " << y << ")");
+    return false;
+  }
+
+  return true;
+}
+
+void KX_NavMeshTileGrid::BuildTiles(const float *verts,
+                                    const unsigned short *polys,
+                                    int npolys,
+                                    int vertsPerPoly,
+                                    std::vector<Tile> &tiles) const
+{
+  if (!IsInitialized()) {
+    return;
+  }
+
+  struct TileSource {
+    unsigned int hash = 0;
+    std::vector<int> polys;
+  };
+
+  // Find the polygons overlapping each tile and hash them independently of their order.
+  std::unordered_map<uint64_t, TileSource> sources;
+  for (int i = 0; i < npolys; ++i) {
+    const unsigned short *poly = &polys[i * vertsPerPoly * 2];
+    int range[4];
+    const int nv = polyTileRange(verts, poly, vertsPerPoly, m_orig, m_tileSize, range);
+    if (nv < 3) {
+      continue;
+    }
+
+    const unsigned int hash = polyHash(verts, poly, nv);
+    for (int y = range[2]; y <= range[3]; ++y) {
+      for (int x = range[0]; x <= range[1]; ++x) {
+        TileSource &source = sources[tileKey(x, y)];
+        source.hash += hash;
+        source.polys.push_back(i);
+      }
+    }
+  }
+
+  for (const auto &item : sources) {
+    const auto it = m_tileHashes.find(item.first);
+    if (it != m_tileHashes.end() && it->second == item.second.hash) {
+      continue;
+    }
+
+    Tile tile;
+    tile.x = (int32_t)(item.first >> 32);
+    tile.y = (int32_t)(item.first & 0xffffffff);
+    tile.hash = item.second.hash;
+    tile.data = nullptr;
+    tile.dataSize = 0;
+    // A failed tile is removed and built again on the next rebuild.
+    if (!BuildTile(tile.x, tile.y, verts, polys, item.second.polys, vertsPerPoly, tile)) {
+      tile.data = nullptr;
+    }
+    tiles.push_back(tile);
+  }
+
+  // Remove the tiles without polygons.
+  for (const auto &item : m_tileHashes) {
+    if (sources.find(item.first) == sources.end()) {
+      tiles.push_back({(int32_t)(item.first >> 32), (int32_t)(item.first & 0xffffffff), 0,
+                       nullptr, 0});
+    }
+  }
+}
+
+void KX_NavMeshTileGrid::ApplyTiles(dtTiledNavMesh *navmesh, std::vector<Tile> &tiles)
+{
+  for (Tile &tile : tiles) {
+    const uint64_t key = tileKey(tile.x, tile.y);
+    dtTile *oldTile = navmesh->getTileAt(tile.x, tile.y);
+    if (oldTile) {
+      navmesh->removeTileAt(tile.x, tile.y, nullptr, nullptr);
+      // The salt is compared to the bits of the polygon references, keep it in range.
+      oldTile->salt &= DT_TILE_REF_SALT_MASK;
+    }
+
+    if (tile.data && navmesh->addTileAt(tile.x, tile.y, tile.data, tile.dataSize, true)) {
+      m_tileHashes[key] = tile.hash;
+    }
+    else {
+      if (tile.data) {
+        CM_Warning("too many navigation mesh tiles, can't add tile (" << tile.x << ", "
+                   << tile.y << ")");
+        delete[] tile.data;
+      }
+      m_tileHashes.erase(key);
+    }
+    tile.data = nullptr;
+  }
+  tiles.clear();
+}
+
+dtTiledNavMesh *KX_NavMeshTileGrid::CreateNavMesh() const
+{
+  dtTiledNavMesh *navmesh = new dtTiledNavMesh();
+  if (!navmesh->init(m_orig, m_tileSize, portalHeight)) {
+    delete navmesh;
+    return nullptr;
+  }
+  return navmesh;
+}
+
+void KX_NavMeshTileGrid::FreeNavMesh(dtTiledNavMesh *navmesh)
+{
+  // The navigation mesh destructor doesn't free the owned tile data.
+  for (int i = 0; i < DT_MAX_TILES; ++i) {
+    const dtTile *tile = navmesh->getTile(i);
+    if (tile->header) {
+      navmesh->removeTileAt(tile->x, tile->y, nullptr, nullptr);
+    }
+  }
+  delete navmesh;
+}
+
+void KX_NavMeshTileGrid::FreeTiles(std::vector<Tile> &tiles)
+{
+  for (Tile &tile : tiles) {
+    delete[] tile.data;
+  }
+  tiles.clear();
+}
+
+const dtTileHeader *KX_NavMeshTileGrid::GetPolyTile(const dtTiledNavMesh *navmesh,
+                                                    dtTilePolyRef ref,
+                                                    int &index)
+{
+  unsigned int salt, it, ip;
+  dtDecodeTileId(ref, salt, it, ip);
+  if (it >= DT_MAX_TILES) {
+    return nullptr;
+  }
+  const dtTile *tile = navmesh->getTile(it);
+  if (tile->salt != (int)salt || !tile->header || ip >= (unsigned int)tile->header->npolys) {
+    return nullptr;
+  }
+  index = ip;
+  return tile->header;
+}
+
+bool KX_NavMeshTileGrid::IsWallEdge(const dtTileHeader *header, const dtTilePoly *poly, int edge)
+{
+  const unsigned short neighbour = poly->n[edge];
+  if (neighbour == 0) {
+    return true;
+  }
+  if (!(neighbour & 0x8000)) {
+    return false;
+  }
+  // Tile border, connected if a neighbour tile is linked to the edge.
+  for (int i = 0; i < poly->nlinks; ++i) {
+    if (header->links[poly->links + i].e == edge) {
+      return false;
+    }
+  }
+  return true;
+}
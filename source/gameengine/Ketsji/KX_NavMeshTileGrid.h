@@ -0,0 +1,104 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+
+#include "DetourTileNavMesh.h"
+
+/** Square tiles of a Detour tiled navigation mesh built from navigation polygons.
+ * The polygons are clipped to the tile borders which become the portals between the
+ * tiles. The grid keeps a hash of the polygons of each tile in the navigation mesh so
+ * that a rebuild only replaces the tiles whose polygons changed.
+ * All positions are in the navigation mesh space.
+ */
+class KX_NavMeshTileGrid {
+ public:
+  /// A tile built from the polygons, to be applied to the navigation mesh.
+  struct Tile {
+    int x;
+    int y;
+    /// Hash of the polygons overlapping the tile.
+    unsigned int hash;
+    /// Detour tile data, nullptr when the tile must be removed.
+    unsigned char *data;
+    int dataSize;
+  };
+
+ private:
+  float m_orig[3];
+  float m_tileSize;
+  /// Polygons of the densest tile at the initialization, more than a tile holds if too dense.
+  int m_maxPolygons;
+  /// Hash of the polygons of the tiles in the navigation mesh.
+  std::unordered_map<uint64_t, unsigned int> m_tileHashes;
+
+  bool BuildTile(int x,
+                 int y,
+                 const float *verts,
+                 const unsigned short *polys,
+                 const std::vector<int> &tilePolys,
+                 int vertsPerPoly,
+                 Tile &tile) const;
+
+ public:
+  KX_NavMeshTileGrid();
+
+  /** Choose the tile size from the polygon density, the densest tile must hold its polygons.
+   * All the tiles are built again after.
+   */
+  void Init(
+      const float *verts, int nverts, const unsigned short *polys, int npolys, int vertsPerPoly);
+  bool IsInitialized() const;
+  /// Return true if no tile is denser than at the initialization or than a tile holds.
+  bool Fits(const float *verts, const unsigned short *polys, int npolys, int vertsPerPoly) const;
+
+  /** Build the tiles whose polygons changed since they were applied, the grid is not
+   * modified so the build can run in a background task.
+   * \param polys The polygons in the Recast layout: vertsPerPoly vertex indices padded
+   * with 0xffff followed by vertsPerPoly unused values.
+   */
+  void BuildTiles(const float *verts,
+                  const unsigned short *polys,
+                  int npolys,
+                  int vertsPerPoly,
+                  std::vector<Tile> &tiles) const;
+  /// Replace the built tiles in the navigation mesh, the navigation mesh owns their data after.
+  void ApplyTiles(dtTiledNavMesh *navmesh, std::vector<Tile> &tiles);
+
+  /// Create an empty navigation mesh for the grid tiles.
+  dtTiledNavMesh *CreateNavMesh() const;
+  /// Free a navigation mesh and the data of its tiles.
+  static void FreeNavMesh(dtTiledNavMesh *navmesh);
+  /// Free the data of tiles not applied.
+  static void FreeTiles(std::vector<Tile> &tiles);
+
+  /// Return the header of the tile containing a polygon and the polygon index, nullptr if invalid.
+  static const dtTileHeader *GetPolyTile(const dtTiledNavMesh *navmesh,
+                                         dtTilePolyRef ref,
+                                         int &index);
+  /// Return true if the polygon edge isn't connected to another polygon.
+  static bool IsWallEdge(const dtTileHeader *header, const dtTilePoly *poly, int edge);
+};
@@ -28,8 +28,14 @@
 
 #include "KX_ObstacleSimulation.h"
 
+#include <algorithm>
+
+#include "BLI_task.h"
+#include "BLI_utildefines.h"
+
 #include "KX_Globals.h"
 #include "KX_NavMeshObject.h"
+#include "SCA_SteeringActuator.h"
 
 namespace {
 inline float perp(const MT_Vector2 &a, const MT_Vector2 &b)
@@ -186,8 +192,19 @@ static float interpolateToi(float a, const float *dir, const float *toi, const i
   return 0;
 }
 
+/// Pack the 32 lower bits of each grid cell coordinate.
+static uint64_t obstacle_cell_key(int64_t x, int64_t y)
+{
+  return ((uint64_t)x & 0xFFFFFFFF) | (((uint64_t)y & 0xFFFFFFFF) << 32);
+}
+
 KX_ObstacleSimulation::KX_ObstacleSimulation(MT_Scalar levelHeight, bool enableVisualization)
-    : m_levelHeight(levelHeight), m_enableVisualization(enableVisualization)
+    : m_gridCellSize(1.0f),
+      m_gridDirty(true),
+      m_maxRadius(0.0f),
+      m_maxSpeed(0.0f),
+      m_levelHeight(levelHeight),
+      m_enableVisualization(enableVisualization)
 {
 }
 
@@ -213,6 +230,8 @@ KX_Obstacle *KX_ObstacleSimulation::CreateObstacle(KX_GameObject *gameobj)
   obstacle->hhead = 0;
 
   m_obstacles.push_back(obstacle);
+  m_objectObstacles.emplace(gameobj, obstacle);
+  m_gridDirty = true;
   return obstacle;
 }
 
@@ -227,24 +246,28 @@ void KX_ObstacleSimulation::AddObstacleForObj(KX_GameObject *gameobj)
 
 void KX_ObstacleSimulation::AddObstaclesForNavMesh(KX_NavMeshObject *navmeshobj)
 {
-  dtStatNavMesh *navmesh = navmeshobj->GetNavMesh();
+  dtTiledNavMesh *navmesh = navmeshobj->GetNavMesh();
   if (navmesh) {
-    int npoly = navmesh->getPolyCount();
-    for (int pi = 0; pi < npoly; pi++) {
-      const dtStatPoly *poly = navmesh->getPoly(pi);
+    for (int ti = 0; ti < DT_MAX_TILES; ti++) {
+      const dtTileHeader *header = navmesh->getTile(ti)->header;
+      if (!header)
+        continue;
+      for (int pi = 0; pi < header->npolys; pi++) {
+        const dtTilePoly *poly = &header->polys[pi];
 
-      for (int i = 0, j = (int)poly->nv - 1; i < (int)poly->nv; j = i++) {
-        if (poly->n[j])
-          continue;
-        const float *vj = navmesh->getVertex(poly->v[j]);
-        const float *vi = navmesh->getVertex(poly->v[i]);
-
-        KX_Obstacle *obstacle = CreateObstacle(navmeshobj);
-        obstacle->m_type = KX_OBSTACLE_NAV_MESH;
-        obstacle->m_shape = KX_OBSTACLE_SEGMENT;
-        obstacle->m_pos = MT_Vector3(vj[0], vj[2], vj[1]);
-        obstacle->m_pos2 = MT_Vector3(vi[0], vi[2], vi[1]);
-        obstacle->m_rad = 0;
+        for (int i = 0, j = (int)poly->nv - 1; i < (int)poly->nv; j = i++) {
+          if (!KX_NavMeshTileGrid::IsWallEdge(header, poly, j))
+            continue;
+          const float *vj = &header->verts[poly->v[j] * 3];
+          const float *vi = &header->verts[poly->v[i] * 3];
+
+          KX_Obstacle *obstacle = CreateObstacle(navmeshobj);
+          obstacle->m_type = KX_OBSTACLE_NAV_MESH;
+          obstacle->m_shape = KX_OBSTACLE_SEGMENT;
+          obstacle->m_pos = MT_Vector3(vj[0], vj[2], vj[1]);
+          obstacle->m_pos2 = MT_Vector3(vi[0], vi[2], vi[1]);
+          obstacle->m_rad = 0;
+        }
       }
     }
   }
@@ -252,6 +275,15 @@ void KX_ObstacleSimulation::AddObstaclesForNavMesh(KX_NavMeshObject *navmeshobj)
 
 void KX_ObstacleSimulation::DestroyObstacleForObj(KX_GameObject *gameobj)
 {
+  // Drop the queued velocity requests using the obstacles or the navigation mesh of the object.
+  m_velocityRequests.erase(std::remove_if(m_velocityRequests.begin(),
+                                          m_velocityRequests.end(),
+                                          [gameobj](const VelocityRequest &request) {
+                                            return (request.m_obstacle->m_gameObj == gameobj ||
+                                                    request.m_navmesh == gameobj);
+                                          }),
+                           m_velocityRequests.end());
+
   for (size_t i = 0; i < m_obstacles.size();) {
     if (m_obstacles[i]->m_gameObj == gameobj) {
       KX_Obstacle *obstacle = m_obstacles[i];
@@ -262,6 +294,9 @@ void KX_ObstacleSimulation::DestroyObstacleForObj(KX_GameObject *gameobj)
     else
       i++;
   }
+
+  m_objectObstacles.erase(gameobj);
+  m_gridDirty = true;
 }
 
 void KX_ObstacleSimulation::UpdateObstacles()
@@ -284,24 +319,162 @@ void KX_ObstacleSimulation::UpdateObstacles()
       add_v2_v2v2(obs->pvel, obs->pvel, &obs->hvel[j * 2]);
     mul_v2_fl(obs->pvel, 1.0f / VEL_HIST_SIZE);
   }
+
+  BuildGrid();
 }
 
-KX_Obstacle *KX_ObstacleSimulation::GetObstacle(KX_GameObject *gameobj)
+void KX_ObstacleSimulation::BuildGrid()
 {
-  for (size_t i = 0; i < m_obstacles.size(); i++) {
-    if (m_obstacles[i]->m_gameObj == gameobj)
-      return m_obstacles[i];
+  m_maxRadius = 0.0f;
+  m_maxSpeed = 0.0f;
+  for (KX_Obstacle *obs : m_obstacles) {
+    if (obs->m_shape == KX_OBSTACLE_SEGMENT) {
+      obs->m_worldPos = obs->m_pos;
+      obs->m_worldPos2 = obs->m_pos2;
+      // apply world transform
+      if (obs->m_type == KX_OBSTACLE_NAV_MESH) {
+        KX_NavMeshObject *navmeshobj = static_cast<KX_NavMeshObject *>(obs->m_gameObj);
+        obs->m_worldPos = navmeshobj->TransformToWorldCoords(obs->m_pos);
+        obs->m_worldPos2 = navmeshobj->TransformToWorldCoords(obs->m_pos2);
+      }
+    }
+    else {
+      obs->m_worldPos = obs->m_pos;
+      obs->m_worldPos2 = obs->m_pos;
+    }
+    m_maxRadius = std::max(m_maxRadius, (float)obs->m_rad);
+    m_maxSpeed = std::max(m_maxSpeed, len_v2(obs->vel));
   }
 
-  return nullptr;
+  // Cells large enough to contain most agents in a few cells.
+  m_gridCellSize = std::max(m_maxRadius * 4.0f, 1.0f);
+
+  m_grid.clear();
+  for (unsigned int i = 0, size = m_obstacles.size(); i < size; ++i) {
+    const KX_Obstacle *obs = m_obstacles[i];
+    const float rad = obs->m_rad;
+    const float minx = std::min(obs->m_worldPos.x(), obs->m_worldPos2.x()) - rad;
+    const float miny = std::min(obs->m_worldPos.y(), obs->m_worldPos2.y()) - rad;
+    const float maxx = std::max(obs->m_worldPos.x(), obs->m_worldPos2.x()) + rad;
+    const float maxy = std::max(obs->m_worldPos.y(), obs->m_worldPos2.y()) + rad;
+
+    for (int64_t x = std::floor(minx / m_gridCellSize), xend = std::floor(maxx / m_gridCellSize);
+         x <= xend;
+         ++x) {
+      for (int64_t y = std::floor(miny / m_gridCellSize),
+                   yend = std::floor(maxy / m_gridCellSize);
+           y <= yend;
+           ++y) {
+        m_grid[obstacle_cell_key(x, y)].push_back(i);
+      }
+    }
+  }
+
+  m_gridDirty = false;
 }
 
-void KX_ObstacleSimulation::AdjustObstacleVelocity(KX_Obstacle *activeObst,
-                                                   KX_NavMeshObject *activeNavMeshObj,
-                                                   MT_Vector3 &velocity,
-                                                   MT_Scalar maxDeltaSpeed,
-                                                   MT_Scalar maxDeltaAngle)
+void KX_ObstacleSimulation::QueryNeighbours(const KX_Obstacle *activeObst,
+                                            float radius,
+                                            KX_Obstacles &neighbours) const
 {
+  const MT_Vector2 pos = activeObst->m_pos.to2d();
+  std::vector<unsigned int> indices;
+
+  for (int64_t x = std::floor((pos.x() - radius) / m_gridCellSize),
+               xend = std::floor((pos.x() + radius) / m_gridCellSize);
+       x <= xend;
+       ++x) {
+    for (int64_t y = std::floor((pos.y() - radius) / m_gridCellSize),
+                 yend = std::floor((pos.y() + radius) / m_gridCellSize);
+         y <= yend;
+         ++y) {
+      const auto it = m_grid.find(obstacle_cell_key(x, y));
+      if (it != m_grid.end()) {
+        indices.insert(indices.end(), it->second.begin(), it->second.end());
+      }
+    }
+  }
+
+  // Obstacles covering several cells are found several times, keep the list order.
+  std::sort(indices.begin(), indices.end());
+  indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+
+  const float p[2] = {pos.x(), pos.y()};
+  for (unsigned int i : indices) {
+    KX_Obstacle *obs = m_obstacles[i];
+    if (obs == activeObst) {
+      continue;
+    }
+    const float a[2] = {obs->m_worldPos.x(), obs->m_worldPos.y()};
+    const float b[2] = {obs->m_worldPos2.x(), obs->m_worldPos2.y()};
+    if (dist_squared_to_line_segment_v2(p, a, b) <= sqr(radius)) {
+      neighbours.push_back(obs);
+    }
+  }
+}
+
+KX_Obstacle *KX_ObstacleSimulation::GetObstacle(KX_GameObject *gameobj)
+{
+  const auto it = m_objectObstacles.find(gameobj);
+  return (it != m_objectObstacles.end()) ? it->second : nullptr;
+}
+
+void KX_ObstacleSimulation::ComputeObstacleVelocity(KX_Obstacle *activeObst,
+                                                    KX_NavMeshObject *activeNavMeshObj,
+                                                    MT_Vector3 &velocity,
+                                                    MT_Scalar maxDeltaSpeed,
+                                                    MT_Scalar maxDeltaAngle)
+{
+}
+
+void KX_ObstacleSimulation::QueueObstacleVelocity(KX_Obstacle *activeObst,
+                                                  KX_NavMeshObject *activeNavMeshObj,
+                                                  const MT_Vector3 &velocity,
+                                                  MT_Scalar maxDeltaSpeed,
+                                                  MT_Scalar maxDeltaAngle,
+                                                  SCA_SteeringActuator *actuator)
+{
+  m_velocityRequests.push_back(
+      {activeObst, activeNavMeshObj, velocity, maxDeltaSpeed, maxDeltaAngle, actuator});
+}
+
+void KX_ObstacleSimulation::ComputeVelocityRequestFunc(
+    void *__restrict userdata, const int i, const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  KX_ObstacleSimulation *simulation = static_cast<KX_ObstacleSimulation *>(userdata);
+  VelocityRequest &request = simulation->m_velocityRequests[i];
+  simulation->ComputeObstacleVelocity(request.m_obstacle,
+                                      request.m_navmesh,
+                                      request.m_velocity,
+                                      request.m_maxDeltaSpeed,
+                                      request.m_maxDeltaAngle);
+}
+
+void KX_ObstacleSimulation::ProcessVelocityRequests()
+{
+  if (m_velocityRequests.empty())
+    return;
+
+  if (m_gridDirty)
+    BuildGrid();
+
+  // All the desired velocities are set first so the agents see each other in any order.
+  for (VelocityRequest &request : m_velocityRequests) {
+    vset(request.m_obstacle->dvel, request.m_velocity.x(), request.m_velocity.y());
+  }
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 8;
+  BLI_task_parallel_range(
+      0, m_velocityRequests.size(), this, ComputeVelocityRequestFunc, &settings);
+
+  // Give the velocities back in the order of the actuators update.
+  for (VelocityRequest &request : m_velocityRequests) {
+    request.m_actuator->ApplyObstacleVelocity(request.m_velocity);
+  }
+
+  m_velocityRequests.clear();
 }
 
 void KX_ObstacleSimulation::DrawObstacles()
@@ -384,22 +557,18 @@ KX_ObstacleSimulationTOI::KX_ObstacleSimulationTOI(MT_Scalar levelHeight, bool e
 {
 }
 
-void KX_ObstacleSimulationTOI::AdjustObstacleVelocity(KX_Obstacle *activeObst,
-                                                      KX_NavMeshObject *activeNavMeshObj,
-                                                      MT_Vector3 &velocity,
-                                                      MT_Scalar maxDeltaSpeed,
-                                                      MT_Scalar maxDeltaAngle)
+void KX_ObstacleSimulationTOI::ComputeObstacleVelocity(KX_Obstacle *activeObst,
+                                                       KX_NavMeshObject *activeNavMeshObj,
+                                                       MT_Vector3 &velocity,
+                                                       MT_Scalar maxDeltaSpeed,
+                                                       MT_Scalar maxDeltaAngle)
 {
-  int nobs = m_obstacles.size();
-  int obstidx = std::find(m_obstacles.begin(), m_obstacles.end(), activeObst) -
-                m_obstacles.begin();
-  if (obstidx == nobs)
-    return;
-
-  vset(activeObst->dvel, velocity.x(), velocity.y());
+  // Only the obstacles in reach during the max TOI can change the sampled velocity.
+  KX_Obstacles neighbours;
+  QueryNeighbours(activeObst, GetNeighbourRadius(activeObst), neighbours);
 
   // apply RVO
-  sampleRVO(activeObst, activeNavMeshObj, maxDeltaAngle);
+  sampleRVO(activeObst, activeNavMeshObj, neighbours, maxDeltaAngle);
 
   // Fake dynamic constraint.
   float dv[2];
@@ -439,8 +608,18 @@ KX_ObstacleSimulationTOI_rays::KX_ObstacleSimulationTOI_rays(MT_Scalar levelHeig
   m_collisionWeight = 100.0f;
 }
 
+float KX_ObstacleSimulationTOI_rays::GetNeighbourRadius(const KX_Obstacle *activeObst) const
+{
+  /* The samples have the speed of the desired velocity, the relative velocity of a moving
+   * obstacle is bounded by twice the sample speed plus both current speeds. */
+  const float vmax = len_v2(activeObst->dvel);
+  const float relSpeed = 2.0f * vmax + len_v2(activeObst->vel) + m_maxSpeed;
+  return activeObst->m_rad + m_maxRadius + m_maxToi * relSpeed;
+}
+
 void KX_ObstacleSimulationTOI_rays::sampleRVO(KX_Obstacle *activeObst,
                                               KX_NavMeshObject *activeNavMeshObj,
+                                              KX_Obstacles &neighbours,
                                               const float maxDeltaAngle)
 {
   MT_Vector2 vel(activeObst->dvel[0], activeObst->dvel[1]);
@@ -462,7 +641,6 @@ void KX_ObstacleSimulationTOI_rays::sampleRVO(KX_Obstacle *activeObst,
   const int iforw = m_maxSamples / 2;
   const float aoff = (float)iforw / (float)m_maxSamples;
 
-  size_t nobs = m_obstacles.size();
   for (int iter = 0; iter < m_maxSamples; ++iter) {
     // Calculate sample velocity
     const float ndir = ((float)iter / (float)m_maxSamples) - aoff;
@@ -474,8 +652,7 @@ void KX_ObstacleSimulationTOI_rays::sampleRVO(KX_Obstacle *activeObst,
     // Find min time of impact and exit amongst all obstacles.
     float tmin = m_maxToi;
     float tmine = 0.0f;
-    for (int i = 0; i < nobs; ++i) {
-      KX_Obstacle *ob = m_obstacles[i];
+    for (KX_Obstacle *ob : neighbours) {
       bool res = filterObstacle(activeObst, activeNavMeshObj, ob, m_levelHeight);
       if (!res)
         continue;
@@ -504,14 +681,8 @@ void KX_ObstacleSimulationTOI_rays::sampleRVO(KX_Obstacle *activeObst,
         }
       }
       else if (ob->m_shape == KX_OBSTACLE_SEGMENT) {
-        MT_Vector3 p1 = ob->m_pos;
-        MT_Vector3 p2 = ob->m_pos2;
-        // apply world transform
-        if (ob->m_type == KX_OBSTACLE_NAV_MESH) {
-          KX_NavMeshObject *navmeshobj = static_cast<KX_NavMeshObject *>(ob->m_gameObj);
-          p1 = navmeshobj->TransformToWorldCoords(p1);
-          p2 = navmeshobj->TransformToWorldCoords(p2);
-        }
+        const MT_Vector3 &p1 = ob->m_worldPos;
+        const MT_Vector3 &p2 = ob->m_worldPos2;
 
         if (!sweepCircleSegment(activeObst->m_pos.to2d(),
                                 activeObst->m_rad,
@@ -589,7 +760,7 @@ void KX_ObstacleSimulationTOI_rays::sampleRVO(KX_Obstacle *activeObst,
 
 static void processSamples(KX_Obstacle *activeObst,
                            KX_NavMeshObject *activeNavMeshObj,
-                           KX_Obstacles &obstacles,
+                           const KX_Obstacles &obstacles,
                            float levelHeight,
                            const float vmax,
                            const float *spos,
@@ -626,8 +797,7 @@ static void processSamples(KX_Obstacle *activeObst,
     float side = 0;
     int nside = 0;
 
-    for (int i = 0; i < obstacles.size(); ++i) {
-      KX_Obstacle *ob = obstacles[i];
+    for (KX_Obstacle *ob : obstacles) {
       bool found = filterObstacle(activeObst, activeNavMeshObj, ob, levelHeight);
       if (!found)
         continue;
@@ -684,14 +854,8 @@ static void processSamples(KX_Obstacle *activeObst,
         }
       }
       else if (ob->m_shape == KX_OBSTACLE_SEGMENT) {
-        MT_Vector3 p1 = ob->m_pos;
-        MT_Vector3 p2 = ob->m_pos2;
-        // apply world transform
-        if (ob->m_type == KX_OBSTACLE_NAV_MESH) {
-          KX_NavMeshObject *navmeshobj = static_cast<KX_NavMeshObject *>(ob->m_gameObj);
-          p1 = navmeshobj->TransformToWorldCoords(p1);
-          p2 = navmeshobj->TransformToWorldCoords(p2);
-        }
+        const MT_Vector3 &p1 = ob->m_worldPos;
+        const MT_Vector3 &p2 = ob->m_worldPos2;
         float p[2], q[2];
         vset(p, p1.x(), p1.y());
         vset(q, p2.x(), p2.y());
@@ -757,8 +921,19 @@ static void processSamples(KX_Obstacle *activeObst,
   }
 }
 
+float KX_ObstacleSimulationTOI_cells::GetNeighbourRadius(const KX_Obstacle *activeObst) const
+{
+  /* The samples speed is bounded by twice the desired speed, the relative velocity of an
+   * obstacle is bounded by twice the sample speed plus both current speeds. The side bias
+   * only uses the obstacles in this radius. */
+  const float vmax = len_v2(activeObst->dvel);
+  const float relSpeed = 4.0f * vmax + len_v2(activeObst->vel) + m_maxSpeed;
+  return activeObst->m_rad + m_maxRadius + 0.01f + m_maxToi * relSpeed;
+}
+
 void KX_ObstacleSimulationTOI_cells::sampleRVO(KX_Obstacle *activeObst,
                                                KX_NavMeshObject *activeNavMeshObj,
+                                               KX_Obstacles &neighbours,
                                                const float maxDeltaAngle)
 {
   vset(activeObst->nvel, 0.f, 0.f);
@@ -788,7 +963,7 @@ void KX_ObstacleSimulationTOI_cells::sampleRVO(KX_Obstacle *activeObst,
     }
     processSamples(activeObst,
                    activeNavMeshObj,
-                   m_obstacles,
+                   neighbours,
                    m_levelHeight,
                    vmax,
                    spos,
@@ -829,7 +1004,7 @@ void KX_ObstacleSimulationTOI_cells::sampleRVO(KX_Obstacle *activeObst,
 
       processSamples(activeObst,
                      activeNavMeshObj,
-                     m_obstacles,
+                     neighbours,
                      m_levelHeight,
                      vmax,
                      spos,
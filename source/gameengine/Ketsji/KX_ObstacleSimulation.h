@@ -25,6 +25,7 @@
 
 #pragma once
 
+#include <unordered_map>
 #include <vector>
 
 #include "MT_Vector2.h"
@@ -32,6 +33,8 @@
 
 class KX_GameObject;
 class KX_NavMeshObject;
+class SCA_SteeringActuator;
+struct TaskParallelTLS;
 
 enum KX_OBSTACLE_TYPE {
   KX_OBSTACLE_OBJ,
@@ -50,6 +53,9 @@ struct KX_Obstacle {
   MT_Vector3 m_pos;
   MT_Vector3 m_pos2;
   MT_Scalar m_rad;
+  /// Segment end points in world space, updated with the obstacle grid.
+  MT_Vector3 m_worldPos;
+  MT_Vector3 m_worldPos2;
 
   float vel[2];
   float pvel[2];
@@ -65,12 +71,54 @@ typedef std::vector<KX_Obstacle *> KX_Obstacles;
 class KX_ObstacleSimulation {
  protected:
   KX_Obstacles m_obstacles;
+  /// First obstacle created for each object.
+  std::unordered_map<KX_GameObject *, KX_Obstacle *> m_objectObstacles;
+
+  /// Uniform grid of the obstacles in the XY plane, cell key to obstacle indices.
+  std::unordered_map<uint64_t, std::vector<unsigned int>> m_grid;
+  float m_gridCellSize;
+  /// The obstacle list changed since the grid was built.
+  bool m_gridDirty;
+  /// Largest circle obstacle radius and speed, used to bound the neighbour queries.
+  float m_maxRadius;
+  float m_maxSpeed;
+
+  /// Velocity adjustment of an agent queued for the batched pass.
+  struct VelocityRequest {
+    KX_Obstacle *m_obstacle;
+    KX_NavMeshObject *m_navmesh;
+    MT_Vector3 m_velocity;
+    MT_Scalar m_maxDeltaSpeed;
+    MT_Scalar m_maxDeltaAngle;
+    SCA_SteeringActuator *m_actuator;
+  };
+  std::vector<VelocityRequest> m_velocityRequests;
+
+  static void ComputeVelocityRequestFunc(void *__restrict userdata,
+                                         const int i,
+                                         const TaskParallelTLS *__restrict tls);
 
   MT_Scalar m_levelHeight;
   bool m_enableVisualization;
 
   KX_Obstacle *CreateObstacle(KX_GameObject *gameobj);
 
+  /// Update the segments world space end points and index all the obstacles in the grid.
+  void BuildGrid();
+  /** Gather the obstacles at less than radius from pos in the XY plane, in obstacle list
+   * order, activeObst excepted.
+   */
+  void QueryNeighbours(const KX_Obstacle *activeObst,
+                       float radius,
+                       KX_Obstacles &neighbours) const;
+
+  /// Compute the adjusted velocity of an agent whose desired velocity is set.
+  virtual void ComputeObstacleVelocity(KX_Obstacle *activeObst,
+                                       KX_NavMeshObject *activeNavMeshObj,
+                                       MT_Vector3 &velocity,
+                                       MT_Scalar maxDeltaSpeed,
+                                       MT_Scalar maxDeltaAngle);
+
  public:
   KX_ObstacleSimulation(MT_Scalar levelHeight, bool enableVisualization);
   virtual ~KX_ObstacleSimulation();
@@ -83,11 +131,18 @@ class KX_ObstacleSimulation {
   void AddObstaclesForNavMesh(KX_NavMeshObject *navmesh);
   KX_Obstacle *GetObstacle(KX_GameObject *gameobj);
   void UpdateObstacles();
-  virtual void AdjustObstacleVelocity(KX_Obstacle *activeObst,
-                                      KX_NavMeshObject *activeNavMeshObj,
-                                      MT_Vector3 &velocity,
-                                      MT_Scalar maxDeltaSpeed,
-                                      MT_Scalar maxDeltaAngle);
+
+  /** Queue the velocity adjustment of a steering actuator agent. All the queued agents
+   * are adjusted in parallel by ProcessVelocityRequests which gives the velocities back
+   * to the actuators.
+   */
+  void QueueObstacleVelocity(KX_Obstacle *activeObst,
+                             KX_NavMeshObject *activeNavMeshObj,
+                             const MT_Vector3 &velocity,
+                             MT_Scalar maxDeltaSpeed,
+                             MT_Scalar maxDeltaAngle,
+                             SCA_SteeringActuator *actuator);
+  void ProcessVelocityRequests();
 };
 class KX_ObstacleSimulationTOI : public KX_ObstacleSimulation {
  protected:
@@ -101,22 +156,28 @@ class KX_ObstacleSimulationTOI : public KX_ObstacleSimulation {
 
   virtual void sampleRVO(KX_Obstacle *activeObst,
                          KX_NavMeshObject *activeNavMeshObj,
+                         KX_Obstacles &neighbours,
                          const float maxDeltaAngle) = 0;
+  /// Distance beyond which the obstacles can't change the sampled velocity.
+  virtual float GetNeighbourRadius(const KX_Obstacle *activeObst) const = 0;
+
+  virtual void ComputeObstacleVelocity(KX_Obstacle *activeObst,
+                                       KX_NavMeshObject *activeNavMeshObj,
+                                       MT_Vector3 &velocity,
+                                       MT_Scalar maxDeltaSpeed,
+                                       MT_Scalar maxDeltaAngle);
 
  public:
   KX_ObstacleSimulationTOI(MT_Scalar levelHeight, bool enableVisualization);
-  virtual void AdjustObstacleVelocity(KX_Obstacle *activeObst,
-                                      KX_NavMeshObject *activeNavMeshObj,
-                                      MT_Vector3 &velocity,
-                                      MT_Scalar maxDeltaSpeed,
-                                      MT_Scalar maxDeltaAngle);
 };
 
 class KX_ObstacleSimulationTOI_rays : public KX_ObstacleSimulationTOI {
  protected:
   virtual void sampleRVO(KX_Obstacle *activeObst,
                          KX_NavMeshObject *activeNavMeshObj,
+                         KX_Obstacles &neighbours,
                          const float maxDeltaAngle);
+  virtual float GetNeighbourRadius(const KX_Obstacle *activeObst) const;
 
  public:
   KX_ObstacleSimulationTOI_rays(MT_Scalar levelHeight, bool enableVisualization);
@@ -129,7 +190,9 @@ class KX_ObstacleSimulationTOI_cells : public KX_ObstacleSimulationTOI {
   int m_sampleRadius;
   virtual void sampleRVO(KX_Obstacle *activeObst,
                          KX_NavMeshObject *activeNavMeshObj,
+                         KX_Obstacles &neighbours,
                          const float maxDeltaAngle);
+  virtual float GetNeighbourRadius(const KX_Obstacle *activeObst) const;
 
  public:
   KX_ObstacleSimulationTOI_cells(MT_Scalar levelHeight, bool enableVisualization);
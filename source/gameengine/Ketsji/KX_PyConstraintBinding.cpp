@@ -126,6 +126,9 @@ PyDoc_STRVAR(gPyRemoveConstraint__doc__,
 PyDoc_STRVAR(gPyGetAppliedImpulse__doc__,
              "getAppliedImpulse(int constraintId)\n"
              "");
+PyDoc_STRVAR(gPySetShapeCacheDirectory__doc__,
+             "setShapeCacheDirectory(string path)\n"
+             "Set the directory where the triangle mesh BVH are cached, disabled if empty");
 
 static PyObject *gPySetGravity(PyObject *self, PyObject *args, PyObject *kwds)
 {
@@ -604,6 +607,18 @@ static PyObject *gPyExportBulletFile(PyObject *, PyObject *args)
   Py_RETURN_NONE;
 }
 
+static PyObject *gPySetShapeCacheDirectory(PyObject *, PyObject *args)
+{
+  char *path;
+  if (!PyArg_ParseTuple(args, "s:setShapeCacheDirectory", &path))
+    return nullptr;
+
+  if (PHY_GetActiveEnvironment()) {
+    PHY_GetActiveEnvironment()->SetShapeCacheDirectory(path);
+  }
+  Py_RETURN_NONE;
+}
+
 static struct PyMethodDef physicsconstraints_methods[] = {
     {"setGravity", (PyCFunction)gPySetGravity, METH_VARARGS, (const char *)gPySetGravity__doc__},
     {"setDebugMode",
@@ -697,6 +712,10 @@ static struct PyMethodDef physicsconstraints_methods[] = {
      (const char *)gPyGetAppliedImpulse__doc__},
 
     {"exportBulletFile", (PyCFunction)gPyExportBulletFile, METH_VARARGS, "export a .bullet file"},
+    {"setShapeCacheDirectory",
+     (PyCFunction)gPySetShapeCacheDirectory,
+     METH_VARARGS,
+     (const char *)gPySetShapeCacheDirectory__doc__},
 
     // sentinel
     {nullptr, (PyCFunction) nullptr, 0, nullptr}};
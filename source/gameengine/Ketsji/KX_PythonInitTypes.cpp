@@ -62,6 +62,7 @@
 #  include "KX_PolyProxy.h"
 #  include "KX_PythonComponent.h"
 #  include "KX_VehicleWrapper.h"
+#  include "KX_VertexBuffer.h"
 #  include "KX_VertexProxy.h"
 #  include "SCA_2DFilterActuator.h"
 #  include "SCA_ANDController.h"
@@ -261,6 +262,7 @@ PyMODINIT_FUNC initGameTypesPythonBinding(void)
     PyType_Ready_Attr(dict, SCA_CollisionSensor, init_getset);
     PyType_Ready_Attr(dict, SCA_TrackToActuator, init_getset);
     PyType_Ready_Attr(dict, KX_VehicleWrapper, init_getset);
+    PyType_Ready_Attr(dict, KX_VertexBuffer, init_getset);
     PyType_Ready_Attr(dict, KX_VertexProxy, init_getset);
     PyType_Ready_Attr(dict, SCA_VisibilityActuator, init_getset);
     PyType_Ready_Attr(dict, SCA_MouseActuator, init_getset);
@@ -36,12 +36,18 @@
 
 #include "KX_Scene.h"
 
+#include <fstream>
+#include <iterator>
+
 #include "BKE_lib_id.h"
 #include "BKE_lib_remap.h"
 #include "BKE_mball.h"
 #include "BKE_modifier.h"
 #include "BKE_object.h"
 #include "BKE_screen.h"
+#include "BLI_fileops.h"
+#include "BLI_path_util.h"
+#include "BLI_string.h"
 #include "BLI_task.h"
 #include "BLI_threads.h"
 #include "DEG_depsgraph_query.h"
@@ -58,25 +64,31 @@
 #include "WM_api.h"
 #include "wm_draw.h"
 
+#include "BL_ArmatureObject.h"
 #include "BL_BlenderConverter.h"
 #include "BL_BlenderDataConversion.h"
 #include "BL_BlenderSceneConverter.h"
 #include "CM_List.h"
+#include "CM_Profiler.h"
 #include "EXP_FloatValue.h"
 #include "KX_2DFilterManager.h"
 #include "KX_BlenderCanvas.h"
 #include "KX_Camera.h"
+#include "KX_ClientObjectInfo.h"
 #include "KX_CollisionEventManager.h"
 #include "KX_FontObject.h"
 #include "KX_Globals.h"
+#include "KX_LibLoadStatus.h"
 #include "KX_Light.h"
 #include "KX_LodManager.h"
 #include "KX_MotionState.h"
+#include "KX_NavMeshObject.h"
 #include "KX_NetworkMessageScene.h"
 #include "KX_NodeRelationships.h"
 #include "KX_ObstacleSimulation.h"
 #include "KX_PhysicsEngineEnums.h"
 #include "KX_PyMath.h"
+#include "KX_SceneSnapshot.h"
 #include "PHY_IPhysicsController.h"
 #include "PHY_IPhysicsEnvironment.h"
 #include "RAS_BucketManager.h"
@@ -93,6 +105,7 @@
 #ifdef WITH_PYTHON
 #  include "bpy_rna.h"
 #  include "EXP_PythonCallBack.h"
+#  include "python_utildefines.h"
 #endif
 
 static void *KX_SceneReplicationFunc(SG_Node *node, void *gameobj, void *scene)
@@ -143,6 +156,8 @@ KX_Scene::KX_Scene(SCA_IInputDevice *inputDevice,
       m_sceneConverter(nullptr),              // eevee
       m_isPythonMainLoop(false),              // eevee
       m_collectionRemap(false),               // eevee (to uncheck viewport restrictflag)
+      m_syncAllTransforms(true),              // eevee
+      m_baseFlagsUpdate(false),               // eevee
       m_keyboardmgr(nullptr),
       m_mousemgr(nullptr),
       m_physicsEnvironment(0),
@@ -159,6 +174,9 @@ KX_Scene::KX_Scene(SCA_IInputDevice *inputDevice,
   m_dbvt_culling = false;
   m_dbvt_occlusion_res = 0;
   m_activity_culling = false;
+  m_activity_box_radius = 0.5f;
+  m_activityCellSize = 0.0f;
+  m_animationLodFrame = 0;
   m_objectlist = new EXP_ListValue<KX_GameObject>();
   m_parentlist = new EXP_ListValue<KX_GameObject>();
   m_lightlist = new EXP_ListValue<KX_LightObject>();
@@ -166,6 +184,10 @@ KX_Scene::KX_Scene(SCA_IInputDevice *inputDevice,
   m_cameralist = new EXP_ListValue<KX_Camera>();
   m_fontlist = new EXP_ListValue<KX_FontObject>();
 
+  // Objects are often searched by name from python.
+  m_objectlist->SetNameIndexEnabled(true);
+  m_inactivelist->SetNameIndexEnabled(true);
+
   m_filterManager = new KX_2DFilterManager();
   m_logicmgr = new SCA_LogicManager();
 
@@ -208,6 +230,11 @@ KX_Scene::KX_Scene(SCA_IInputDevice *inputDevice,
   m_animationPool = BLI_task_pool_create(
       &m_animationPoolData, TASK_PRIORITY_LOW);
 
+  m_physicsPool = nullptr;
+  m_lastSnapshot = nullptr;
+  m_snapshotPool = nullptr;
+  m_physicsPending = false;
+
 #ifdef WITH_PYTHON
   m_attr_dict = nullptr;
   m_removeCallbacks = nullptr;
@@ -270,7 +297,15 @@ KX_Scene::KX_Scene(SCA_IInputDevice *inputDevice,
   CTX_wm_view3d(C)->shading.type = KX_GetActiveEngine()->ShadingTypeRuntime();
   ConfigureOverlays();
 
-  if (!KX_GetActiveEngine()->UseViewportRender()) {
+  const bool headless = KX_GetActiveEngine()->GetFlag(KX_KetsjiEngine::HEADLESS);
+  if (headless) {
+    scene->flag |= SCE_INTERACTIVE;
+
+    /* Without render the depsgraph is only evaluated once here for the conversion,
+     * the draw manager and its viewport are never created. */
+    BKE_scene_graph_update_tagged(CTX_data_depsgraph_pointer(C), bmain);
+  }
+  else if (!KX_GetActiveEngine()->UseViewportRender()) {
     /* We want to indicate that we are in bge runtime. The flag can be used in draw code but in
      * depsgraph code too later */
     scene->flag |= SCE_INTERACTIVE;
@@ -288,12 +323,16 @@ KX_Scene::KX_Scene(SCA_IInputDevice *inputDevice,
   }
 
   /* Fix black shading issue with addObject https://github.com/UPBGE/upbge/issues/1354 */
-  GPU_shader_force_unbind();
+  if (!headless) {
+    GPU_shader_force_unbind();
+  }
   /****************************************************/
 }
 
 KX_Scene::~KX_Scene()
 {
+  // The physics step can't run while the objects are freed.
+  WaitPhysics();
 
 #ifdef WITH_PYTHON
   RunOnRemoveCallbacks();
@@ -318,7 +357,11 @@ KX_Scene::~KX_Scene()
   }
   /*************************/
 
-  if (!KX_GetActiveEngine()->UseViewportRender()) {
+  const bool headless = KX_GetActiveEngine()->GetFlag(KX_KetsjiEngine::HEADLESS);
+  if (headless) {
+    // Nothing was allocated by the draw manager.
+  }
+  else if (!KX_GetActiveEngine()->UseViewportRender()) {
     DRW_game_gpu_viewport_set(nullptr);
     if (!m_isPythonMainLoop) {
       /* This will free m_gpuViewport and m_gpuOffScreen */
@@ -344,7 +387,9 @@ KX_Scene::~KX_Scene()
   }
 
   /* Fixes issue when switching .blend erm...*/
-  GPU_shader_force_unbind();
+  if (!headless) {
+    GPU_shader_force_unbind();
+  }
 
   for (Object *hiddenOb : m_hiddenObjectsDuringRuntime) {
     Base *base = BKE_view_layer_base_find(view_layer, hiddenOb);
@@ -364,6 +409,10 @@ KX_Scene::~KX_Scene()
   // reference might be hanging and causing late release of objects
   RemoveAllDebugProperties();
 
+  while (!m_objectPools.empty()) {
+    FreeObjectPool(m_objectPools.begin()->first);
+  }
+
   while (GetRootParentList()->GetCount() > 0) {
     KX_GameObject *parentobj = GetRootParentList()->GetValue(0);
     this->RemoveObject(parentobj);
@@ -376,6 +425,17 @@ KX_Scene::~KX_Scene()
     BLI_task_pool_free(m_animationPool);
   }
 
+  if (m_physicsPool) {
+    BLI_task_pool_free(m_physicsPool);
+  }
+
+  if (m_snapshotPool) {
+    // Don't lose the snapshots written at the end of the game.
+    BLI_task_pool_work_and_wait(m_snapshotPool);
+    BLI_task_pool_free(m_snapshotPool);
+  }
+  delete m_lastSnapshot;
+
   if (m_objectlist)
     m_objectlist->Release();
 
@@ -692,11 +752,15 @@ void KX_Scene::RenderAfterCameraSetup(KX_Camera *cam,
     m_collectionRemap = false;
   }
 
+  if (m_baseFlagsUpdate) {
+    BKE_layer_collection_sync(scene, BKE_view_layer_default_view(scene));
+    DEG_id_tag_update(&scene->id, ID_RECALC_BASE_FLAGS);
+    m_baseFlagsUpdate = false;
+  }
+
   /* Notify the depsgraph if object transform changed in the scene
    * for next drawing loop. */
-  for (KX_GameObject *gameobj : GetObjectList()) {
-    gameobj->TagForTransformUpdate(is_last_render_pass);
-  }
+  TagDirtyTransformsForUpdate(is_last_render_pass);
 
   /* Notify depsgraph for other changes */
   TagForExtraObjectsUpdate(bmain, cam);
@@ -710,12 +774,13 @@ void KX_Scene::RenderAfterCameraSetup(KX_Camera *cam,
   /* We need the changes to be flushed before each draw loop! */
   BKE_scene_graph_update_tagged(depsgraph, bmain);
 
-  UpdateParents(0.0);
+  // The nodes moved by a running physics step are updated at its end, in FinishPhysics.
+  if (!m_physicsPending) {
+    UpdateParents(0.0);
+  }
 
   /* Update evaluated object obmat according to SceneGraph. */
-  for (KX_GameObject *gameobj : GetObjectList()) {
-    gameobj->TagForTransformUpdateEvaluated();
-  }
+  TagDirtyTransformsEvaluated(is_last_render_pass);
 
   engine->EndCountDepsgraphTime();
 
@@ -934,81 +999,18 @@ void KX_Scene::convert_blender_objects_list_synchronous(std::vector<Object *> ob
   }
 }
 
-// Task data for convertBlenderCollection in a different thread.
-struct ConvertBlenderObjectsListTaskData {
-  std::vector<Object *> objectslist;
-  KX_KetsjiEngine *engine;
-  e_PhysicsEngine physics_engine;
-  KX_Scene *kxscene;
-  BL_BlenderSceneConverter *converter;
-  RAS_Rasterizer *rasty;
-  RAS_ICanvas *canvas;
-  Depsgraph *depsgraph;
-  Main *bmain;
-};
-
-static void convert_blender_objects_list_thread_func(TaskPool *__restrict UNUSED(pool),
-                                                     void *taskdata)
-{
-  ConvertBlenderObjectsListTaskData *task = static_cast<ConvertBlenderObjectsListTaskData *>(
-      taskdata);
-
-  for (Object *obj : task->objectslist) {
-    BL_ConvertBlenderObjects(task->bmain,
-                             task->depsgraph,
-                             task->kxscene,
-                             task->engine,
-                             task->physics_engine,
-                             task->rasty,
-                             task->canvas,
-                             task->converter,
-                             obj,
-                             false,
-                             false);
-  }
-}
-
-void KX_Scene::ConvertBlenderObjectsList(std::vector<Object *> objectslist, bool asynchronous)
+KX_LibLoadStatus *KX_Scene::ConvertBlenderObjectsList(std::vector<Object *> objectslist,
+                                                      bool asynchronous)
 {
   if (asynchronous) {
-    /* Convert the Blender Objects list in a different thread, so that the
-     * game engine can keep running at full speed. */
-    ConvertBlenderObjectsListTaskData task;
-    task.engine = KX_GetActiveEngine();
-    task.physics_engine = UseBullet;
-    task.kxscene = this;
-    task.converter = m_sceneConverter;
-    task.rasty = task.engine->GetRasterizer();
-    task.canvas = task.engine->GetCanvas();
-    bContext *C = task.engine->GetContext();
-    task.depsgraph = CTX_data_expect_evaluated_depsgraph(C);
-    task.bmain = CTX_data_main(C);
-    task.objectslist = objectslist;
-
-    TaskPool *taskpool = BLI_task_pool_create(&task, TASK_PRIORITY_LOW);
-
-    BLI_task_pool_push(
-        taskpool,
-        convert_blender_objects_list_thread_func,
-        &task,
-        false,  // We will clean the objectslist std::vector of pointers ourself later
-        NULL);
-    BLI_task_pool_work_and_wait(taskpool);
-
-    /* delete the objectslist ourself as it gives error if the work
-     * has to do it the BLI_task_pool_work_and_wait function */
-    while (!task.objectslist.size() != 0) {
-      Object *temp = task.objectslist.back();
-      task.objectslist.pop_back();
-      delete temp;
-    }
-
-    BLI_task_pool_free(taskpool);
-    taskpool = nullptr;
-  }
-  else {
-    convert_blender_objects_list_synchronous(objectslist);
+    /* Convert the objects over several frames, so that the game engine can keep
+     * running at full speed. */
+    BL_BlenderConverter *converter = KX_GetActiveEngine()->GetConverter();
+    return converter->ConvertObjectsAsync(this, nullptr, objectslist, "");
   }
+
+  convert_blender_objects_list_synchronous(objectslist);
+  return nullptr;
 }
 
 void KX_Scene::convert_blender_collection_synchronous(Collection *co)
@@ -1037,70 +1039,17 @@ void KX_Scene::convert_blender_collection_synchronous(Collection *co)
   FOREACH_COLLECTION_OBJECT_RECURSIVE_END;
 }
 
-// Task data for convertBlenderCollection in a different thread.
-struct ConvertBlenderCollectionTaskData {
-  Collection *co;
-  KX_KetsjiEngine *engine;
-  e_PhysicsEngine physics_engine;
-  KX_Scene *kxscene;
-  BL_BlenderSceneConverter *converter;
-  RAS_Rasterizer *rasty;
-  RAS_ICanvas *canvas;
-  Depsgraph *depsgraph;
-  Main *bmain;
-};
-
-static void convert_blender_collection_thread_func(TaskPool *__restrict UNUSED(pool),
-                                                   void *taskdata)
-{
-  ConvertBlenderCollectionTaskData *task = static_cast<ConvertBlenderCollectionTaskData *>(
-      taskdata);
-
-  FOREACH_COLLECTION_OBJECT_RECURSIVE_BEGIN (task->co, obj) {
-    BL_ConvertBlenderObjects(task->bmain,
-                             task->depsgraph,
-                             task->kxscene,
-                             task->engine,
-                             task->physics_engine,
-                             task->rasty,
-                             task->canvas,
-                             task->converter,
-                             obj,
-                             false,
-                             false);
-  }
-  FOREACH_COLLECTION_OBJECT_RECURSIVE_END;
-}
-
-void KX_Scene::ConvertBlenderCollection(Collection *co, bool asynchronous)
+KX_LibLoadStatus *KX_Scene::ConvertBlenderCollection(Collection *co, bool asynchronous)
 {
   if (asynchronous) {
-
-    /* Convert the Blender collection in a different thread, so that the
-     * game engine can keep running at full speed. */
-    ConvertBlenderCollectionTaskData task;
-
-    task.engine = KX_GetActiveEngine();
-    task.physics_engine = UseBullet;
-    task.co = co;
-    task.kxscene = this;
-    task.converter = m_sceneConverter;
-    task.rasty = task.engine->GetRasterizer();
-    task.canvas = task.engine->GetCanvas();
-    bContext *C = task.engine->GetContext();
-    task.depsgraph = CTX_data_ensure_evaluated_depsgraph(C);
-    task.bmain = CTX_data_main(C);
-
-    TaskPool *taskpool = BLI_task_pool_create(&task, TASK_PRIORITY_LOW);
-
-    BLI_task_pool_push(taskpool, convert_blender_collection_thread_func, &task, false, NULL);
-    BLI_task_pool_work_and_wait(taskpool);
-    BLI_task_pool_free(taskpool);
-    taskpool = nullptr;
-  }
-  else {
-    convert_blender_collection_synchronous(co);
+    /* Convert the collection objects over several frames, so that the game engine
+     * can keep running at full speed. */
+    BL_BlenderConverter *converter = KX_GetActiveEngine()->GetConverter();
+    return converter->ConvertObjectsAsync(this, co, {}, co->id.name + 2);
   }
+
+  convert_blender_collection_synchronous(co);
+  return nullptr;
 }
 
 void KX_Scene::ConvertBlenderAction(bAction *action)
@@ -1270,6 +1219,92 @@ void KX_Scene::TagForObmatRestore(std::vector<Object *> potentialChildren)
   }
 }
 
+void KX_Scene::AddDirtyTransformObject(KX_GameObject *gameobj)
+{
+  // A suspended object moved by a script may have left its activity grid cell.
+  if (gameobj->GetActivityCulled()) {
+    m_activityMovedObjects.push_back(gameobj);
+  }
+
+  if (!gameobj->GetInDirtyTransformList()) {
+    gameobj->SetInDirtyTransformList(true);
+    m_dirtyTransformObjects.push_back(gameobj);
+  }
+}
+
+void KX_Scene::ClearDirtyTransformObjects()
+{
+  for (KX_GameObject *gameobj : m_dirtyTransformObjects) {
+    gameobj->SetInDirtyTransformList(false);
+  }
+  m_dirtyTransformObjects.clear();
+}
+
+void KX_Scene::TagBaseFlagsUpdate()
+{
+  m_baseFlagsUpdate = true;
+}
+
+void KX_Scene::TagDirtyTransformsForUpdate(bool is_last_render_pass)
+{
+  if (m_syncAllTransforms) {
+    /* The list can contain inactive objects updated during the conversion,
+     * only the active objects are synchronized with the depsgraph. */
+    ClearDirtyTransformObjects();
+    for (KX_GameObject *gameobj : GetObjectList()) {
+      AddDirtyTransformObject(gameobj);
+    }
+    m_syncAllTransforms = false;
+  }
+
+  for (KX_GameObject *gameobj : m_dirtyTransformObjects) {
+    gameobj->TagForTransformUpdate(is_last_render_pass);
+  }
+}
+
+void KX_Scene::TagDirtyTransformsEvaluated(bool is_last_render_pass)
+{
+  /* The objects whose transform is overridden by the depsgraph write their scene graph node
+   * which is read by the motion states of a running physics step. */
+  if (m_physicsPending) {
+    for (KX_GameObject *gameobj : m_dirtyTransformObjects) {
+      Object *ob = gameobj->GetBlenderObject();
+      if (ob && (ob->transflag & OB_TRANSFLAG_OVERRIDE_GAME_PRIORITY)) {
+        WaitPhysics();
+        break;
+      }
+    }
+  }
+
+  for (KX_GameObject *gameobj : m_dirtyTransformObjects) {
+    gameobj->TagForTransformUpdateEvaluated();
+  }
+
+  /* The objects stay in the list until the last render pass as the previous obmat
+   * is only stored in this pass. */
+  if (!is_last_render_pass) {
+    return;
+  }
+
+  unsigned int size = 0;
+  for (KX_GameObject *gameobj : m_dirtyTransformObjects) {
+    Object *ob = gameobj->GetBlenderObject();
+    /* Keep the objects moved after the depsgraph notification (UpdateParents),
+     * the ones driven by the depsgraph and the ones the depsgraph can evaluate
+     * back to their original transform. */
+    const bool keep = gameobj->GetSGNode()->IsDirty(SG_Node::DIRTY_RENDER) ||
+                      (ob && ((ob->transflag & OB_TRANSFLAG_OVERRIDE_GAME_PRIORITY) ||
+                              !OrigObCanBeTransformedInRealtime(ob)));
+    if (keep) {
+      m_dirtyTransformObjects[size++] = gameobj;
+    }
+    else {
+      gameobj->SetInDirtyTransformList(false);
+    }
+  }
+  m_dirtyTransformObjects.resize(size);
+}
+
 bool KX_Scene::SomethingIsMoving()
 {
   for (KX_GameObject *gameobj : GetObjectList()) {
@@ -1448,6 +1483,31 @@ EXP_ListValue<KX_GameObject> *KX_Scene::GetRootParentList() const
   return m_parentlist;
 }
 
+void KX_Scene::AddRootObject(KX_GameObject *gameobj)
+{
+  m_parentlist->Add(CM_AddRef(gameobj));
+
+  if (gameobj->GetActivityCulled()) {
+    // A child of a suspended hierarchy was unparented, index it as a suspended root.
+    SetObjectActivityCulled(gameobj, true);
+  }
+  else {
+    m_activityRoots.push_back(gameobj);
+  }
+}
+
+bool KX_Scene::RemoveRootObject(KX_GameObject *gameobj)
+{
+  if (!m_parentlist->RemoveValue(gameobj)) {
+    return false;
+  }
+
+  if (!gameobj->GetActivityCulled()) {
+    CM_ListRemoveIfFound(m_activityRoots, gameobj);
+  }
+  return true;
+}
+
 EXP_ListValue<KX_GameObject> *KX_Scene::GetInactiveList() const
 {
   return m_inactivelist;
@@ -1507,6 +1567,13 @@ const RAS_FrameSettings &KX_Scene::GetFramingType() const
 void KX_Scene::SetActivityCulling(bool b)
 {
   m_activity_culling = b;
+
+  if (!m_activity_culling) {
+    while (!m_activityCulledObjects.empty()) {
+      SetObjectActivityCulled(m_activityCulledObjects.begin()->first, false);
+    }
+    m_activityMovedObjects.clear();
+  }
 }
 
 void KX_Scene::AddObjectDebugProperties(class KX_GameObject *gameobj)
@@ -1808,7 +1875,7 @@ void KX_Scene::DupliGroupRecurse(KX_GameObject *groupobj, int level)
     }
     KX_GameObject *replica = (KX_GameObject *)AddNodeReplicaObject(nullptr, gameobj);
     // add to 'rootparent' list (this is the list of top hierarchy objects, updated each frame)
-    m_parentlist->Add(CM_AddRef(replica));
+    AddRootObject(replica);
 
     // recurse replication into children nodes
     const NodeList children = gameobj->GetSGNode()->GetSGChildren();
@@ -1910,10 +1977,20 @@ KX_GameObject *KX_Scene::AddReplicaObject(KX_GameObject *originalobject,
   KX_GameObject *originalobj = (KX_GameObject *)originalobject;
   KX_GameObject *referenceobj = (KX_GameObject *)referenceobject;
 
+  std::map<KX_GameObject *, std::vector<KX_GameObject *>>::iterator poolit = m_objectPools.find(
+      originalobj);
+  if (poolit != m_objectPools.end() && !poolit->second.empty()) {
+    return SpawnPooledObject(originalobj, referenceobj, lifespan);
+  }
+
   m_ueberExecutionPriority++;
 
   // lets create a replica
   KX_GameObject *replica = (KX_GameObject *)AddNodeReplicaObject(nullptr, originalobj);
+  // the pool grows up to the peak number of living replicas
+  if (poolit != m_objectPools.end()) {
+    replica->SetPoolTemplate(originalobj);
+  }
 
   // add a timebomb to this object
   // lifespan of zero means 'this object lives forever'
@@ -1929,7 +2006,7 @@ KX_GameObject *KX_Scene::AddReplicaObject(KX_GameObject *originalobject,
   }
 
   // add to 'rootparent' list (this is the list of top hierarchy objects, updated each frame)
-  m_parentlist->Add(CM_AddRef(replica));
+  AddRootObject(replica);
 
   // recurse replication into children nodes
 
@@ -1999,6 +2076,253 @@ KX_GameObject *KX_Scene::AddReplicaObject(KX_GameObject *originalobject,
   return replica;
 }
 
+/// Return the object followed by all its children, in scene graph order.
+static std::vector<KX_GameObject *> object_hierarchy(KX_GameObject *gameobj)
+{
+  std::vector<KX_GameObject *> hierarchy = gameobj->GetChildrenRecursive();
+  hierarchy.insert(hierarchy.begin(), gameobj);
+  return hierarchy;
+}
+
+void KX_Scene::CreateObjectPool(KX_GameObject *gameobj, unsigned int size)
+{
+  // create the pool, then recycle its free replicas or create new ones
+  m_objectPools[gameobj];
+
+  std::vector<KX_GameObject *> replicas(size);
+  for (KX_GameObject *&replica : replicas) {
+    replica = AddReplicaObject(gameobj, nullptr, 0.0f);
+  }
+
+  for (KX_GameObject *replica : replicas) {
+    ReleaseToObjectPool(replica);
+    // release here because AddReplicaObject AddRef's
+    replica->Release();
+  }
+}
+
+KX_GameObject *KX_Scene::SpawnPooledObject(KX_GameObject *gameobj,
+                                           KX_GameObject *referenceobj,
+                                           float lifespan)
+{
+  std::vector<KX_GameObject *> &pool = m_objectPools[gameobj];
+  KX_GameObject *replica = pool.back();
+  pool.pop_back();
+
+  /* The pooled hierarchy matches the original one, see ReleaseToObjectPool,
+   * use it to reset the replicas to the state of their original object. */
+  const std::vector<KX_GameObject *> hierarchy = object_hierarchy(replica);
+  const std::vector<KX_GameObject *> orighierarchy = object_hierarchy(gameobj);
+
+  for (unsigned int i = 0, size = hierarchy.size(); i < size; ++i) {
+    KX_GameObject *obj = hierarchy[i];
+    KX_GameObject *origobj = orighierarchy[i];
+
+    // the object list reference is given back by the pool
+    m_objectlist->Add(obj);
+    switch (obj->GetGameObjectType()) {
+      case SCA_IObject::OBJ_LIGHT: {
+        m_lightlist->Add(CM_AddRef(static_cast<KX_LightObject *>(obj)));
+        break;
+      }
+      case SCA_IObject::OBJ_TEXT: {
+        m_fontlist->Add(CM_AddRef(static_cast<KX_FontObject *>(obj)));
+        break;
+      }
+      case SCA_IObject::OBJ_CAMERA: {
+        m_cameralist->Add(CM_AddRef(static_cast<KX_Camera *>(obj)));
+        break;
+      }
+      case SCA_IObject::OBJ_ARMATURE: {
+        AddAnimatedObject(obj);
+        break;
+      }
+      default: {
+        break;
+      }
+    }
+
+    Object *blenderobj = origobj->GetBlenderObject();
+    if (m_obstacleSimulation && blenderobj && blenderobj->gameflag & OB_HASOBSTACLE) {
+      m_obstacleSimulation->AddObstacleForObj(obj);
+    }
+    if (obj->GetComponents()) {
+      m_componentManager.RegisterObject(obj);
+    }
+
+    // replace the properties by the ones of the original object
+    for (const std::string &name : obj->GetPropertyNames()) {
+      EXP_Value *prop = obj->GetProperty(name);
+      if (prop->GetProperty("timer")) {
+        m_timemgr->RemoveTimeProperty(prop);
+      }
+      obj->RemoveProperty(name);
+    }
+    for (const std::string &name : origobj->GetPropertyNames()) {
+      EXP_Value *prop = origobj->GetProperty(name)->GetReplica();
+      obj->SetProperty(name, prop);
+      if (prop->GetProperty("timer")) {
+        m_timemgr->AddTimeProperty(prop);
+      }
+      prop->Release();
+    }
+
+    if (KX_GetActiveEngine()->GetFlag(KX_KetsjiEngine::AUTO_ADD_DEBUG_PROPERTIES)) {
+      AddObjectDebugProperties(obj);
+    }
+
+    obj->ResetState();
+    obj->SetVisible(origobj->GetVisible(), false, false);
+    if (referenceobj) {
+      obj->SetLayer(referenceobj->GetLayer());
+    }
+    else {
+      obj->SetLayer(m_blenderScene->lay);
+    }
+  }
+  TagBaseFlagsUpdate();
+
+  if (lifespan > 0.0f) {
+    m_tempObjectList.push_back(replica);
+    // see AddReplicaObject for the conversion from frames to seconds
+    EXP_Value *fval = new EXP_FloatValue(lifespan * 0.02f);
+    replica->SetProperty("::timebomb", fval);
+    fval->Release();
+  }
+
+  AddRootObject(replica);
+
+  SG_Node *orgnode = gameobj->GetSGNode();
+  replica->NodeSetLocalScale(orgnode->GetLocalScale());
+  replica->NodeSetLocalPosition(orgnode->GetLocalPosition());
+  replica->NodeSetLocalOrientation(orgnode->GetLocalOrientation());
+
+  if (referenceobj) {
+    replica->NodeSetLocalPosition(referenceobj->NodeGetWorldPosition());
+    replica->NodeSetLocalOrientation(referenceobj->NodeGetWorldOrientation());
+    replica->NodeSetRelativeScale(referenceobj->GetSGNode()->GetRootSGParent()->GetLocalScale());
+  }
+
+  replica->GetSGNode()->UpdateWorldData(0);
+
+  replica->RestoreLogic(true);
+  replica->RestorePhysics(true);
+  for (KX_GameObject *obj : hierarchy) {
+    PHY_IPhysicsController *ctrl = obj->GetPhysicsController();
+    if (ctrl) {
+      // dynamic objects are not synchronized with the scene graph, do it explicitly
+      ctrl->SetTransform();
+      ctrl->SetLinearVelocity(MT_Vector3(0.0f, 0.0f, 0.0f), false);
+      ctrl->SetAngularVelocity(MT_Vector3(0.0f, 0.0f, 0.0f), false);
+    }
+  }
+
+  // AddReplicaObject AddRef's the returned object
+  return CM_AddRef(replica);
+}
+
+void KX_Scene::ReleaseToObjectPool(KX_GameObject *gameobj)
+{
+  // the replica is suspended by the pool, not by the activity culling
+  if (gameobj->GetActivityCulled()) {
+    SetObjectActivityCulled(gameobj, false);
+  }
+
+  const std::vector<KX_GameObject *> hierarchy = object_hierarchy(gameobj);
+
+#ifdef WITH_PYTHON
+  for (KX_GameObject *obj : hierarchy) {
+    obj->RunOnRemoveCallbacks();
+  }
+#endif
+
+  gameobj->SuspendLogic(true);
+  // keep the constraints for the next use of the replica
+  gameobj->SuspendPhysics(false, true);
+  gameobj->SetVisible(false, true, false);
+  TagBaseFlagsUpdate();
+
+  gameobj->RemoveProperty("::timebomb");
+
+  for (KX_GameObject *obj : hierarchy) {
+    RemoveObjectDebugProperties(obj);
+    // the replica is removed for python, it will get a new proxy when recycled
+    obj->InvalidateProxy();
+    obj->StopAllActions();
+
+    for (SCA_IActuator *actuator : obj->GetActuators()) {
+      actuator->Deactivate();
+    }
+
+    if (m_obstacleSimulation) {
+      m_obstacleSimulation->DestroyObstacleForObj(obj);
+    }
+    m_componentManager.UnregisterObject(obj);
+
+    if (obj->GetInDirtyTransformList()) {
+      obj->SetInDirtyTransformList(false);
+      CM_ListRemoveIfFound(m_dirtyTransformObjects, obj);
+    }
+
+    // the pool takes over the object list reference
+    m_objectlist->RemoveValue(obj);
+    if (m_lightlist->RemoveValue(obj)) {
+      obj->Release();
+    }
+    if (m_fontlist->RemoveValue(obj)) {
+      obj->Release();
+    }
+    if (m_cameralist->RemoveValue(obj)) {
+      obj->Release();
+    }
+
+    CM_ListRemoveIfFound(m_animatedlist, obj);
+    CM_ListRemoveIfFound(m_navMeshRebuilds, obj);
+    CM_ListRemoveIfFound(m_euthanasyobjects, obj);
+    CM_ListRemoveIfFound(m_tempObjectList, obj);
+
+    if (obj == m_active_camera) {
+      m_active_camera = nullptr;
+    }
+    if (obj == m_overrideCullingCamera) {
+      m_overrideCullingCamera = nullptr;
+    }
+  }
+
+  if (RemoveRootObject(gameobj)) {
+    gameobj->Release();
+  }
+
+  m_objectPools[gameobj->GetPoolTemplate()].push_back(gameobj);
+}
+
+void KX_Scene::FreeObjectPool(KX_GameObject *gameobj)
+{
+  std::map<KX_GameObject *, std::vector<KX_GameObject *>>::iterator it = m_objectPools.find(
+      gameobj);
+  if (it == m_objectPools.end()) {
+    return;
+  }
+
+  const std::vector<KX_GameObject *> pool = it->second;
+  m_objectPools.erase(it);
+
+  for (KX_GameObject *replica : pool) {
+    // give back the object list references to remove the hierarchy as any other object
+    for (KX_GameObject *obj : object_hierarchy(replica)) {
+      m_objectlist->Add(obj);
+    }
+    RemoveObject(replica);
+  }
+
+  // the living replicas are now regular replicas
+  for (KX_GameObject *obj : m_objectlist) {
+    if (obj->GetPoolTemplate() == gameobj) {
+      obj->SetPoolTemplate(nullptr);
+    }
+  }
+}
+
 void KX_Scene::RemoveObject(KX_GameObject *gameobj)
 {
   // disconnect child from parent
@@ -2030,6 +2354,14 @@ void KX_Scene::DelayedRemoveObject(KX_GameObject *gameobj)
 
 bool KX_Scene::NewRemoveObject(KX_GameObject *gameobj)
 {
+  // the pooled replicas can't outlive their original object
+  FreeObjectPool(gameobj);
+
+  if (gameobj->GetActivityCulled()) {
+    RemoveActivityCulledObject(gameobj);
+    CM_ListRemoveIfFound(m_activityMovedObjects, gameobj);
+  }
+
   /* remove property from debug list */
   RemoveObjectDebugProperties(gameobj);
 
@@ -2099,6 +2431,11 @@ bool KX_Scene::NewRemoveObject(KX_GameObject *gameobj)
 
   gameobj->RemoveMeshes();
 
+  if (gameobj->GetInDirtyTransformList()) {
+    gameobj->SetInDirtyTransformList(false);
+    CM_ListRemoveIfFound(m_dirtyTransformObjects, gameobj);
+  }
+
   bool ret = true;
   if (m_lightlist->RemoveValue(gameobj)) {
     ret = (gameobj->Release() != nullptr);
@@ -2106,7 +2443,7 @@ bool KX_Scene::NewRemoveObject(KX_GameObject *gameobj)
   if (m_objectlist->RemoveValue(gameobj)) {
     ret = (gameobj->Release() != nullptr);
   }
-  if (m_parentlist->RemoveValue(gameobj)) {
+  if (RemoveRootObject(gameobj)) {
     ret = (gameobj->Release() != nullptr);
   }
   if (m_inactivelist->RemoveValue(gameobj)) {
@@ -2121,6 +2458,7 @@ bool KX_Scene::NewRemoveObject(KX_GameObject *gameobj)
 
   // WARNING: 'gameobj' maybe be freed now, only compare, don't access.
   CM_ListRemoveIfFound(m_animatedlist, gameobj);
+  CM_ListRemoveIfFound(m_navMeshRebuilds, gameobj);
   CM_ListRemoveIfFound(m_euthanasyobjects, gameobj);
   CM_ListRemoveIfFound(m_tempObjectList, gameobj);
 
@@ -2270,6 +2608,18 @@ void KX_Scene::RenderDebugProperties(RAS_DebugDraw &debugDraw,
 // logic stuff
 void KX_Scene::LogicBeginFrame(double curtime, double framestep)
 {
+  /* Swap the navigation meshes rebuilt in background at the frame boundary, the logic
+   * never sees a navigation mesh changing during a frame. */
+  for (std::vector<KX_NavMeshObject *>::iterator it = m_navMeshRebuilds.begin();
+       it != m_navMeshRebuilds.end();) {
+    if ((*it)->UpdateRebuild()) {
+      ++it;
+    }
+    else {
+      it = m_navMeshRebuilds.erase(it);
+    }
+  }
+
   // have a look at temp objects ...
   for (KX_GameObject *gameobj : m_tempObjectList) {
     EXP_FloatValue *propval = (EXP_FloatValue *)gameobj->GetProperty("::timebomb");
@@ -2298,10 +2648,19 @@ void KX_Scene::AddAnimatedObject(KX_GameObject *gameobj)
   CM_ListAddIfNotFound(m_animatedlist, gameobj);
 }
 
-static void update_anim_thread_func(TaskPool *pool, void *taskdata, int UNUSED(threadid))
+void KX_Scene::AddNavMeshRebuild(KX_NavMeshObject *navmesh)
+{
+  CM_ListAddIfNotFound(m_navMeshRebuilds, navmesh);
+}
+
+static void update_anim_thread_func(TaskPool *__restrict pool, void *taskdata)
 {
-  KX_GameObject *gameobj, *parent;
+  CM_PROFILE_ZONE("AnimationTask");
+
+  KX_GameObject *gameobj;
+  BL_ArmatureObject *armature = nullptr;
   bool needs_update;
+  bool delayed = false;
   KX_Scene::AnimationPoolData *data = (KX_Scene::AnimationPoolData *)BLI_task_pool_user_data(pool);
   double curtime = data->curtime;
 
@@ -2315,60 +2674,311 @@ static void update_anim_thread_func(TaskPool *pool, void *taskdata, int UNUSED(t
     // to see if we need to bother with a more expensive pose update
     const std::vector<KX_GameObject *> children = gameobj->GetChildren();
 
-    bool has_mesh = false, has_non_mesh = false;
+    bool has_mesh = false;
 
     // Check for meshes that haven't been culled
     for (KX_GameObject *child : children) {
-      // if (!child->GetCulled()) { // eevee disable armature animation culling
-      needs_update = true;
-      break;
-      //}
+      if (!child->GetCulled()) {
+        needs_update = true;
+        break;
+      }
 
-      if (child->GetMeshCount() == 0)
-        has_non_mesh = true;
-      else
+      if (child->GetMeshCount() != 0) {
         has_mesh = true;
+      }
     }
 
     // If we didn't find a non-culled mesh, check to see
     // if we even have any meshes, and update if this
-    // armature has only non-mesh children.
-    if (!needs_update && !has_mesh && has_non_mesh)
+    // armature has no mesh children.
+    if (!needs_update && !has_mesh) {
       needs_update = true;
+    }
+
+    // Far armatures evaluate their pose only every few frames and interpolate it meanwhile.
+    armature = static_cast<BL_ArmatureObject *>(gameobj);
+    if (needs_update && armature->IsPoseUpdateDelayed()) {
+      needs_update = false;
+      delayed = true;
+    }
   }
 
   // If the object is a culled armature, then we manage only the animation time and end of its
   // animations.
-  gameobj->UpdateActionManager(curtime, needs_update);
+  gameobj->UpdateActionManagerPoses(curtime, needs_update);
 
-  if (needs_update) {
-    const std::vector<KX_GameObject *> children = gameobj->GetChildren();
-    parent = gameobj->GetParent();
+  if (armature) {
+    armature->UpdateLodPose(!needs_update && !delayed);
   }
 }
 
-void KX_Scene::UpdateAnimations(double curtime)
+void KX_Scene::UpdateAnimationsCulling()
 {
-  // m_animationPoolData.curtime = curtime;
+  KX_Camera *cam = m_overrideCullingCamera ? m_overrideCullingCamera : m_active_camera;
+
+  const GameData &gm = m_blenderScene->gm;
+  const bool useLod = cam && (gm.flag & GAME_USE_ANIMATION_LOD) && gm.animLodMaxInterval > 1;
+  const MT_Vector3 camPos = cam ? cam->NodeGetWorldPosition() : MT_Vector3(0.0f, 0.0f, 0.0f);
+  const float lodFactor = cam ? cam->GetLodDistanceFactor() : 1.0f;
+  ++m_animationLodFrame;
 
+  unsigned int index = 0;
   for (KX_GameObject *gameobj : m_animatedlist) {
-    // BLI_task_pool_push(m_animationPool, update_anim_thread_func, gameobj, false,
-    // TASK_PRIORITY_LOW);
-    gameobj->UpdateActionManager(curtime, true);
-  }
+    if (gameobj->GetGameObjectType() != SCA_IObject::OBJ_ARMATURE) {
+      continue;
+    }
 
-  // BLI_task_pool_work_and_wait(m_animationPool);
-}
+    // Most detailed level of the visible meshes using a lod manager, -1 if none.
+    short lodLevel = -1;
+    for (KX_GameObject *child : gameobj->GetChildren()) {
+      Object *ob = child->GetBlenderObject();
+      // Non-mesh children never request a pose update.
+      if (child->GetMeshCount() == 0 || !ob) {
+        child->SetCulled(true);
+        continue;
+      }
 
-void KX_Scene::LogicUpdateFrame(double curtime)
-{
-  m_componentManager.UpdateComponents();
+      if (child->GetLodManager() && (lodLevel == -1 || child->GetCurrentLodLevel() < lodLevel)) {
+        lodLevel = child->GetCurrentLodLevel();
+      }
 
-  m_logicmgr->UpdateFrame(curtime);
-}
+      BoundBox *bb = cam ? BKE_object_boundbox_get(ob) : nullptr;
+      if (!bb) {
+        child->SetCulled(false);
+        continue;
+      }
 
-void KX_Scene::LogicEndFrame()
-{
+      float center[3], size[3];
+      BKE_boundbox_calc_center_aabb(bb, center);
+      BKE_boundbox_calc_size_aabb(bb, size);
+
+      const MT_Vector3 &scale = child->NodeGetWorldScaling();
+      const MT_Vector3 scaledCenter = MT_Vector3(center) * scale;
+      const MT_Vector3 scaledSize = MT_Vector3(size) * scale.absolute();
+      const MT_Vector3 worldCenter = child->NodeGetWorldPosition() +
+                                     child->NodeGetWorldOrientation() * scaledCenter;
+
+      const bool culled = (cam->GetFrustum().SphereInsideFrustum(
+                               worldCenter, scaledSize.length()) == SG_Frustum::OUTSIDE);
+      child->SetCulled(culled);
+    }
+
+    /* Number of frames between two pose updates, from the lod level of the meshes or else from
+     * the camera distance. */
+    unsigned int interval = 1;
+    if (useLod) {
+      if (lodLevel != -1) {
+        interval += lodLevel;
+      }
+      else if (gm.animLodDistance > 0.0f) {
+        const float distance = (gameobj->NodeGetWorldPosition() - camPos).length() * lodFactor;
+        interval += (unsigned int)(distance / gm.animLodDistance);
+      }
+      interval = std::min(interval, (unsigned int)gm.animLodMaxInterval);
+    }
+
+    // Spread the updates of the armatures sharing the same interval over the frames.
+    BL_ArmatureObject *armature = static_cast<BL_ArmatureObject *>(gameobj);
+    armature->SetPoseUpdateLod(interval, (m_animationLodFrame + index++) % interval);
+  }
+}
+
+void KX_Scene::UpdateAnimations(double curtime)
+{
+  // Compute the culling state of the armatures' meshes, it is read by the pose update tasks.
+  UpdateAnimationsCulling();
+
+  /* Evaluate the actions frame and armature poses in parallel, these tasks only write into the
+   * data owned by their object. */
+  m_animationPoolData.curtime = curtime;
+
+  for (KX_GameObject *gameobj : m_animatedlist) {
+    BLI_task_pool_push(m_animationPool, update_anim_thread_func, gameobj, false, nullptr);
+  }
+
+  BLI_task_pool_work_and_wait(m_animationPool);
+
+  /* Apply the actions to the scene graph and request the depsgraph updates serially,
+   * in the animated objects order to keep the result deterministic. */
+  for (KX_GameObject *gameobj : m_animatedlist) {
+    gameobj->ApplyActionManager(curtime);
+
+    // The interpolated poses of the delayed armatures are not applied by their actions.
+    if (gameobj->GetGameObjectType() == SCA_IObject::OBJ_ARMATURE &&
+        static_cast<BL_ArmatureObject *>(gameobj)->IsPoseInterpolated()) {
+      Object *ob = gameobj->GetBlenderObject();
+      if (ob->gameflag & OB_OVERLAY_COLLECTION) {
+        AppendToExtraObjectsToUpdateInOverlayPass(ob, ID_RECALC_TRANSFORM);
+      }
+      else {
+        AppendToExtraObjectsToUpdateInAllRenderPasses(ob, ID_RECALC_TRANSFORM);
+      }
+    }
+  }
+}
+
+static void physics_step_task_func(TaskPool *__restrict pool, void *taskdata)
+{
+  CM_PROFILE_ZONE("PhysicsTask");
+
+  PHY_IPhysicsEnvironment *physEnv = (PHY_IPhysicsEnvironment *)taskdata;
+  const KX_Scene::PhysicsPoolData *data = (KX_Scene::PhysicsPoolData *)BLI_task_pool_user_data(
+      pool);
+
+  physEnv->ProceedDeltaTime(data->curtime, data->timestep, data->framestep);
+}
+
+void KX_Scene::ProceedPhysicsAsync(double curtime, double timestep, double framestep)
+{
+  FinishPhysics();
+
+  if (!m_physicsPool) {
+    m_physicsPool = BLI_task_pool_create_background(&m_physicsPoolData, TASK_PRIORITY_HIGH);
+  }
+
+  m_physicsPoolData.curtime = curtime;
+  m_physicsPoolData.timestep = timestep;
+  m_physicsPoolData.framestep = framestep;
+  m_physicsPending = true;
+
+  BLI_task_pool_push(m_physicsPool, physics_step_task_func, m_physicsEnvironment, false, nullptr);
+}
+
+void KX_Scene::WaitPhysics()
+{
+  if (m_physicsPending) {
+    CM_PROFILE_ZONE("PhysicsWait");
+    BLI_task_pool_work_and_wait(m_physicsPool);
+  }
+}
+
+void KX_Scene::FinishPhysics()
+{
+  if (!m_physicsPending) {
+    return;
+  }
+
+  WaitPhysics();
+  m_physicsPending = false;
+
+  m_physicsEnvironment->UpdateSoftBodies();
+  // The motion states only modified the local transforms.
+  UpdateParents(m_physicsPoolData.curtime);
+}
+
+/// File path and content of a snapshot written in background.
+struct SnapshotWriteData {
+  std::string path;
+  std::vector<char> data;
+  /// The written snapshot, it replaces the delta base once the file is written.
+  KX_SceneSnapshot *snapshot;
+  KX_SceneSnapshot **base;
+};
+
+static void write_snapshot_task_func(TaskPool *__restrict pool, void *taskdata)
+{
+  CM_PROFILE_ZONE("SnapshotWrite");
+
+  SnapshotWriteData *writeData = (SnapshotWriteData *)taskdata;
+  /* Write in a temporary file first to never leave a partial snapshot, the pool is serial so
+   * the writes to a same path never overlap and are renamed in order. */
+  const std::string tmpPath = writeData->path + ".tmp";
+
+  std::ofstream file(tmpPath, std::ios::binary);
+  file.write(writeData->data.data(), writeData->data.size());
+  file.close();
+
+  if (!file || BLI_rename(tmpPath.c_str(), writeData->path.c_str()) != 0) {
+    CM_Error("failed to write game state snapshot: " << writeData->path);
+    return;
+  }
+
+  // The base is only read by the scene once the pending writes are finished.
+  delete *writeData->base;
+  *writeData->base = writeData->snapshot;
+  writeData->snapshot = nullptr;
+}
+
+static void free_snapshot_task_data(TaskPool *__restrict pool, void *taskdata)
+{
+  SnapshotWriteData *writeData = (SnapshotWriteData *)taskdata;
+  delete writeData->snapshot;
+  delete writeData;
+}
+
+void KX_Scene::SaveSnapshot(const std::string &path, bool delta)
+{
+  CM_PROFILE_ZONE("SnapshotCapture");
+
+  // A delta is relative to the last written snapshot, the pending writes must be finished.
+  if (delta && m_snapshotPool) {
+    BLI_task_pool_work_and_wait(m_snapshotPool);
+  }
+
+  // The physics step must not modify the velocities while they are read.
+  WaitPhysics();
+
+  KX_SceneSnapshot *snapshot = new KX_SceneSnapshot();
+  snapshot->Capture(this);
+
+  SnapshotWriteData *writeData = new SnapshotWriteData();
+  writeData->path = path;
+  writeData->snapshot = snapshot;
+  writeData->base = &m_lastSnapshot;
+  snapshot->Write(writeData->data, delta ? m_lastSnapshot : nullptr);
+
+  if (!m_snapshotPool) {
+    m_snapshotPool = BLI_task_pool_create_background_serial(nullptr, TASK_PRIORITY_LOW);
+  }
+  BLI_task_pool_push(
+      m_snapshotPool, write_snapshot_task_func, writeData, true, free_snapshot_task_data);
+}
+
+bool KX_Scene::LoadSnapshot(const std::string &path)
+{
+  if (m_snapshotPool) {
+    BLI_task_pool_work_and_wait(m_snapshotPool);
+  }
+
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    CM_Error("failed to open game state snapshot: " << path);
+    return false;
+  }
+  const std::vector<char> data((std::istreambuf_iterator<char>(file)),
+                               std::istreambuf_iterator<char>());
+
+  KX_SceneSnapshot snapshot;
+  if (!snapshot.Read(data)) {
+    CM_Error("failed to read game state snapshot: " << path);
+    return false;
+  }
+
+  WaitPhysics();
+  snapshot.Apply(this);
+
+  // Following deltas are relative to the restored state.
+  delete m_lastSnapshot;
+  m_lastSnapshot = new KX_SceneSnapshot();
+  m_lastSnapshot->Capture(this);
+
+  return true;
+}
+
+void KX_Scene::LogicUpdateFrame(double curtime)
+{
+  m_componentManager.UpdateComponents();
+
+  m_logicmgr->UpdateFrame(curtime);
+
+  // Adjust the velocities of the steering actuators agents in one pass.
+  if (m_obstacleSimulation) {
+    m_obstacleSimulation->ProcessVelocityRequests();
+  }
+}
+
+void KX_Scene::LogicEndFrame()
+{
   m_logicmgr->EndFrame();
 
   /* Don't remove the objects from the euthanasy list here as the child objects of a deleted
@@ -2378,7 +2988,24 @@ void KX_Scene::LogicEndFrame()
    * explicitly. NewRemoveObject is the place to do it.
    */
   while (!m_euthanasyobjects.empty()) {
-    RemoveObject(m_euthanasyobjects.front());
+    KX_GameObject *gameobj = m_euthanasyobjects.front();
+    SG_Node *node = gameobj->GetSGNode();
+    KX_GameObject *poolTemplate = gameobj->GetPoolTemplate();
+    /* Recycle the replica only when it's still a root object with the hierarchy of
+     * its original object, which can be changed by parenting. */
+    if (node && poolTemplate && !node->GetSGParent() &&
+        gameobj->GetChildrenRecursive().size() == poolTemplate->GetChildrenRecursive().size()) {
+      ReleaseToObjectPool(gameobj);
+    }
+    else {
+      // the hierarchy of a pooled replica is altered, it can't be recycled anymore
+      KX_GameObject *root = node ? (KX_GameObject *)node->GetRootSGParent()->GetSGClientObject() :
+                                   nullptr;
+      if (root && root != gameobj) {
+        root->SetPoolTemplate(nullptr);
+      }
+      RemoveObject(gameobj);
+    }
   }
 
   // prepare obstacle simulation for new frame
@@ -2390,6 +3017,154 @@ void KX_Scene::LogicEndFrame()
   }
 }
 
+/// Minimum number of nodes to update to use the parallel scene graph update.
+static const unsigned int sgParallelMinNodes = 256;
+
+/** Number of nodes in a subtree, return 0 if the subtree can't be updated in a task:
+ * bone parents update their armature pose on demand and slow or bone parents reschedule
+ * their node during the update, which must be done in the serial order.
+ */
+static unsigned int sg_subtree_size(SG_Node *node)
+{
+  SG_ParentRelation *relation = node->GetParentRelation();
+  if (relation && (relation->IsBoneRelation() || relation->IsSlowRelation())) {
+    return 0;
+  }
+
+  unsigned int size = 1;
+  for (SG_Node *child : node->GetSGChildren()) {
+    const unsigned int childSize = sg_subtree_size(child);
+    if (childSize == 0) {
+      return 0;
+    }
+    size += childSize;
+  }
+  return size;
+}
+
+struct SceneGraphUpdateData {
+  double time;
+  std::vector<KX_Scene::SceneGraphUpdateItem> *items;
+  std::vector<std::vector<SG_Node *>> *updatedNodes;
+};
+
+static void scene_graph_update_func(void *__restrict userdata,
+                                    const int i,
+                                    const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  SceneGraphUpdateData *data = static_cast<SceneGraphUpdateData *>(userdata);
+  const KX_Scene::SceneGraphUpdateItem &item = (*data->items)[i];
+  if (item.subtree) {
+    item.node->UpdateWorldDataTask(data->time, (*data->updatedNodes)[i], item.parentUpdated);
+  }
+}
+
+bool KX_Scene::UpdateParentsParallel(double curtime)
+{
+  m_sgUpdateItems.clear();
+  m_sgScheduledIndices.clear();
+
+  /* The serial update goes through the scheduled nodes in list order and each node updates
+   * its whole subtree, a scheduled node whose scheduled ancestor comes first in the list
+   * is updated with it. Keep the nodes without scheduled ancestor, their subtrees are
+   * disjoint and can be updated in any order. */
+  SG_DList::iterator<SG_Node> it(m_sghead);
+  unsigned int index = 0;
+  for (it.begin(); !it.end(); ++it, ++index) {
+    m_sgScheduledIndices[*it] = index;
+  }
+
+  unsigned int numNodes = 0;
+  index = 0;
+  for (it.begin(); !it.end(); ++it, ++index) {
+    SG_Node *node = *it;
+    bool covered = false;
+    for (SG_Node *parent = node->GetSGParent(); parent; parent = parent->GetSGParent()) {
+      const auto pit = m_sgScheduledIndices.find(parent);
+      if (pit != m_sgScheduledIndices.end()) {
+        /* The ancestor comes after the node, the serial update would update the node
+         * twice, keep its exact behavior. */
+        if (pit->second > index) {
+          return false;
+        }
+        covered = true;
+        break;
+      }
+    }
+
+    if (!covered) {
+      m_sgUpdateItems.push_back({node, false, true, false});
+      const unsigned int size = sg_subtree_size(node);
+      if (size == 0) {
+        return false;
+      }
+      numNodes += size;
+    }
+  }
+
+  if (numNodes < sgParallelMinNodes) {
+    return false;
+  }
+
+  /* Split the subtrees while there are too few of them to use all threads (e.g a vehicle
+   * with many parented parts), a split node is updated alone first and its children
+   * become subtrees. The item order stays the depth first order of the serial update. */
+  const unsigned int numItems = BLI_task_scheduler_num_threads() * 4;
+  while (m_sgUpdateItems.size() < numItems) {
+    m_sgSplitItems.clear();
+    bool split = false;
+    for (const SceneGraphUpdateItem &item : m_sgUpdateItems) {
+      const NodeList &children = item.node->GetSGChildren();
+      if (!item.subtree || children.empty()) {
+        m_sgSplitItems.push_back(item);
+        continue;
+      }
+
+      m_sgUpdatedNodes.resize(1);
+      m_sgUpdatedNodes[0].clear();
+      const bool parentUpdated = item.node->UpdateNodeWorldDataTask(
+          curtime, m_sgUpdatedNodes[0], item.parentUpdated);
+      const bool updated = !m_sgUpdatedNodes[0].empty();
+      m_sgSplitItems.push_back({item.node, item.parentUpdated, false, updated});
+      for (SG_Node *child : children) {
+        m_sgSplitItems.push_back({child, parentUpdated, true, false});
+      }
+      split = true;
+    }
+
+    m_sgUpdateItems.swap(m_sgSplitItems);
+    if (!split) {
+      break;
+    }
+  }
+
+  m_sgUpdatedNodes.resize(m_sgUpdateItems.size());
+  for (std::vector<SG_Node *> &updatedNodes : m_sgUpdatedNodes) {
+    updatedNodes.clear();
+  }
+
+  SceneGraphUpdateData data = {curtime, &m_sgUpdateItems, &m_sgUpdatedNodes};
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  BLI_task_parallel_range(0, m_sgUpdateItems.size(), &data, scene_graph_update_func, &settings);
+
+  // Call the transform callbacks in the serial update order as they fill the scene lists.
+  for (unsigned int i = 0, size = m_sgUpdateItems.size(); i < size; ++i) {
+    const SceneGraphUpdateItem &item = m_sgUpdateItems[i];
+    if (item.subtree) {
+      for (SG_Node *node : m_sgUpdatedNodes[i]) {
+        node->ActivateUpdateTransformCallback();
+      }
+    }
+    else if (item.updated) {
+      item.node->ActivateUpdateTransformCallback();
+    }
+  }
+
+  return true;
+}
+
 /**
  * UpdateParents: SceneGraph transformation update.
  */
@@ -2398,8 +3173,10 @@ void KX_Scene::UpdateParents(double curtime)
   // we use the SG dynamic list
   SG_Node *node;
 
-  while ((node = SG_Node::GetNextScheduled(m_sghead)) != nullptr) {
-    node->UpdateWorldData(curtime);
+  if (!UpdateParentsParallel(curtime)) {
+    while ((node = SG_Node::GetNextScheduled(m_sghead)) != nullptr) {
+      node->UpdateWorldData(curtime);
+    }
   }
 
   // the list must be empty here
@@ -2445,8 +3222,191 @@ int KX_Scene::GetLodHysteresisValue(void)
   return m_lodHysteresisValue;
 }
 
+/// Margin of the activity box radius to suspend objects, avoid toggling the objects on the border.
+static const float ACTIVITY_CULLING_HYSTERESIS = 0.1f;
+
+/// Pack the 21 lower bits of each cell coordinate.
+static uint64_t activity_cell_key(int64_t x, int64_t y, int64_t z)
+{
+  return ((uint64_t)x & 0x1FFFFF) | (((uint64_t)y & 0x1FFFFF) << 21) |
+         (((uint64_t)z & 0x1FFFFF) << 42);
+}
+
+uint64_t KX_Scene::GetActivityCell(const MT_Vector3 &pos) const
+{
+  return activity_cell_key((int64_t)std::floor(pos.x() / m_activityCellSize),
+                           (int64_t)std::floor(pos.y() / m_activityCellSize),
+                           (int64_t)std::floor(pos.z() / m_activityCellSize));
+}
+
+void KX_Scene::RemoveActivityCulledObject(KX_GameObject *gameobj)
+{
+  std::unordered_map<KX_GameObject *, uint64_t>::iterator it = m_activityCulledObjects.find(
+      gameobj);
+  if (it != m_activityCulledObjects.end()) {
+    std::vector<KX_GameObject *> &objects = m_activityGrid[it->second];
+    CM_ListRemoveIfFound(objects, gameobj);
+    if (objects.empty()) {
+      m_activityGrid.erase(it->second);
+    }
+    m_activityCulledObjects.erase(it);
+  }
+}
+
+void KX_Scene::SetObjectActivityCulled(KX_GameObject *gameobj, bool culled)
+{
+  if (culled) {
+    const uint64_t cell = GetActivityCell(gameobj->NodeGetWorldPosition());
+    m_activityCulledObjects[gameobj] = cell;
+    m_activityGrid[cell].push_back(gameobj);
+  }
+  else {
+    RemoveActivityCulledObject(gameobj);
+    // The suspended roots are removed from m_activityRoots by UpdateObjectActivity.
+    if (!gameobj->GetSGNode()->GetSGParent()) {
+      m_activityRoots.push_back(gameobj);
+    }
+  }
+
+  for (KX_GameObject *obj : object_hierarchy(gameobj)) {
+    if (obj->GetActivityCulled() == culled) {
+      continue;
+    }
+    obj->SetActivityCulled(culled);
+
+    // Suspended components are not updated at all.
+    if (obj->GetComponents()) {
+      if (culled) {
+        m_componentManager.UnregisterObject(obj);
+      }
+      else {
+        m_componentManager.RegisterObject(obj);
+      }
+    }
+  }
+}
+
+static bool activity_box_contains(const std::vector<MT_Vector3> &positions,
+                                  const MT_Vector3 &pos,
+                                  float radius)
+{
+  for (const MT_Vector3 &campos : positions) {
+    if (std::fabs(campos.x() - pos.x()) <= radius && std::fabs(campos.y() - pos.y()) <= radius &&
+        std::fabs(campos.z() - pos.z()) <= radius) {
+      return true;
+    }
+  }
+  return false;
+}
+
 void KX_Scene::UpdateObjectActivity(void)
 {
+  if (!m_activity_culling) {
+    return;
+  }
+
+  const float radius = m_activity_box_radius;
+
+  // Put the culled objects in the cells of the new radius.
+  if (m_activityCellSize != radius) {
+    m_activityCellSize = radius;
+    m_activityGrid.clear();
+    for (std::pair<KX_GameObject *const, uint64_t> &item : m_activityCulledObjects) {
+      item.second = GetActivityCell(item.first->NodeGetWorldPosition());
+      m_activityGrid[item.second].push_back(item.first);
+    }
+  }
+
+  // Update the cell of the culled objects moved since the last update.
+  for (KX_GameObject *gameobj : m_activityMovedObjects) {
+    std::unordered_map<KX_GameObject *, uint64_t>::iterator it = m_activityCulledObjects.find(
+        gameobj);
+    if (it == m_activityCulledObjects.end()) {
+      continue;
+    }
+
+    // The object was parented, it's not a root object anymore.
+    if (gameobj->GetSGNode()->GetSGParent()) {
+      SetObjectActivityCulled(gameobj, false);
+      continue;
+    }
+
+    const uint64_t cell = GetActivityCell(gameobj->NodeGetWorldPosition());
+    if (cell != it->second) {
+      std::vector<KX_GameObject *> &objects = m_activityGrid[it->second];
+      CM_ListRemoveIfFound(objects, gameobj);
+      if (objects.empty()) {
+        m_activityGrid.erase(it->second);
+      }
+      it->second = cell;
+      m_activityGrid[cell].push_back(gameobj);
+    }
+  }
+  m_activityMovedObjects.clear();
+
+  // The activity is centered on all the cameras rendering the scene.
+  std::vector<MT_Vector3> positions;
+  std::vector<KX_GameObject *> camroots;
+  for (KX_Camera *cam : m_cameralist) {
+    if (cam == m_active_camera || cam->GetViewport()) {
+      positions.push_back(cam->NodeGetWorldPosition());
+      camroots.push_back(
+          static_cast<KX_GameObject *>(cam->GetSGNode()->GetRootSGParent()->GetSGClientObject()));
+    }
+  }
+
+  if (positions.empty()) {
+    return;
+  }
+
+  // Resume the culled objects back in the activity box, only the cells around the cameras are
+  // visited.
+  for (const MT_Vector3 &campos : positions) {
+    const MT_Vector3 mincell = (campos - MT_Vector3(radius, radius, radius)) / m_activityCellSize;
+    const MT_Vector3 maxcell = (campos + MT_Vector3(radius, radius, radius)) / m_activityCellSize;
+
+    for (int64_t x = std::floor(mincell.x()), xend = std::floor(maxcell.x()); x <= xend; ++x) {
+      for (int64_t y = std::floor(mincell.y()), yend = std::floor(maxcell.y()); y <= yend; ++y) {
+        for (int64_t z = std::floor(mincell.z()), zend = std::floor(maxcell.z()); z <= zend;
+             ++z) {
+          std::unordered_map<uint64_t, std::vector<KX_GameObject *>>::iterator it =
+              m_activityGrid.find(activity_cell_key(x, y, z));
+          if (it == m_activityGrid.end()) {
+            continue;
+          }
+
+          // Copy as resuming the objects modifies the cell.
+          const std::vector<KX_GameObject *> objects = it->second;
+          for (KX_GameObject *gameobj : objects) {
+            if (activity_box_contains(positions, gameobj->NodeGetWorldPosition(), radius)) {
+              SetObjectActivityCulled(gameobj, false);
+            }
+          }
+        }
+      }
+    }
+  }
+
+  /* Suspend the root objects outside the activity box of all the cameras, the box is a bit
+   * larger than to resume to not toggle the objects on its border. Only the active roots are
+   * tested, the suspended roots are reached through the activity grid. */
+  const float suspendRadius = radius * (1.0f + ACTIVITY_CULLING_HYSTERESIS);
+  unsigned int count = 0;
+  for (KX_GameObject *gameobj : m_activityRoots) {
+    Object *blenderobject = gameobj->GetBlenderObject();
+    const bool nevercull = (blenderobject &&
+                            (blenderobject->gameflag2 & OB_NEVER_DO_ACTIVITY_CULLING));
+
+    // Never suspend the hierarchy of a camera.
+    if (!nevercull && std::find(camroots.begin(), camroots.end(), gameobj) == camroots.end() &&
+        !activity_box_contains(positions, gameobj->NodeGetWorldPosition(), suspendRadius)) {
+      SetObjectActivityCulled(gameobj, true);
+    }
+    else {
+      m_activityRoots[count++] = gameobj;
+    }
+  }
+  m_activityRoots.resize(count);
 }
 
 void KX_Scene::SetActivityCullingRadius(float f)
@@ -2625,6 +3585,11 @@ bool KX_Scene::MergeScene(KX_Scene *other)
   GetInactiveList()->MergeList(other->GetInactiveList());
   other->GetInactiveList()->ReleaseAndRemoveAll();
 
+  for (KX_GameObject *gameobj : other->GetRootParentList()) {
+    if (!gameobj->GetActivityCulled()) {
+      m_activityRoots.push_back(gameobj);
+    }
+  }
   GetRootParentList()->MergeList(other->GetRootParentList());
   other->GetRootParentList()->ReleaseAndRemoveAll();
 
@@ -2637,6 +3602,10 @@ bool KX_Scene::MergeScene(KX_Scene *other)
   GetFontList()->MergeList(other->GetFontList());
   other->GetFontList()->ReleaseAndRemoveAll();
 
+  // Synchronize the merged objects with the depsgraph at the next render pass.
+  other->ClearDirtyTransformObjects();
+  m_syncAllTransforms = true;
+
   /* move materials across, assume they both use the same scene-converters
    * Do this after lights are merged so materials can use the lights in shaders
    */
@@ -2697,6 +3666,9 @@ void KX_Scene::RunDrawingCallbacks(DrawingCallbackType callbackType, KX_Camera *
     return;
   }
 
+  // The callbacks can access the physics, it must not run in the same time.
+  WaitPhysics();
+
   if (camera) {
     PyObject *args[1] = {camera->GetProxy()};
     EXP_RunPythonCallBackList(list, args, 0, 1);
@@ -2760,6 +3732,10 @@ PyTypeObject KX_Scene::Type = {PyVarObject_HEAD_INIT(nullptr, 0) "KX_Scene",
 
 PyMethodDef KX_Scene::Methods[] = {
     EXP_PYMETHODTABLE(KX_Scene, addObject),
+    EXP_PYMETHODTABLE(KX_Scene, createObjectPool),
+    EXP_PYMETHODTABLE_KEYWORDS(KX_Scene, rayCastBatch),
+    EXP_PYMETHODTABLE_KEYWORDS(KX_Scene, saveSnapshot),
+    EXP_PYMETHODTABLE(KX_Scene, loadSnapshot),
     EXP_PYMETHODTABLE(KX_Scene, end),
     EXP_PYMETHODTABLE(KX_Scene, restart),
     EXP_PYMETHODTABLE(KX_Scene, replace),
@@ -3090,6 +4066,31 @@ int KX_Scene::pyattr_set_gravity(EXP_PyObjectPlus *self_v,
   return PY_SET_ATTR_SUCCESS;
 }
 
+PyObject *KX_Scene::pyattr_get_activity_culling(EXP_PyObjectPlus *self_v,
+                                                const EXP_PYATTRIBUTE_DEF *attrdef)
+{
+  KX_Scene *self = static_cast<KX_Scene *>(self_v);
+
+  return PyBool_FromLong(self->m_activity_culling);
+}
+
+int KX_Scene::pyattr_set_activity_culling(EXP_PyObjectPlus *self_v,
+                                          const EXP_PYATTRIBUTE_DEF *attrdef,
+                                          PyObject *value)
+{
+  KX_Scene *self = static_cast<KX_Scene *>(self_v);
+
+  const int param = PyObject_IsTrue(value);
+  if (param == -1) {
+    PyErr_SetString(PyExc_AttributeError,
+                    "scene.activity_culling = bool: KX_Scene, expected True or False");
+    return PY_SET_ATTR_FAIL;
+  }
+
+  self->SetActivityCulling(param);
+  return PY_SET_ATTR_SUCCESS;
+}
+
 PyAttributeDef KX_Scene::Attributes[] = {
     EXP_PYATTRIBUTE_RO_FUNCTION("name", KX_Scene, pyattr_get_name),
     EXP_PYATTRIBUTE_RO_FUNCTION("objects", KX_Scene, pyattr_get_objects),
@@ -3113,7 +4114,10 @@ PyAttributeDef KX_Scene::Attributes[] = {
     EXP_PYATTRIBUTE_RW_FUNCTION(
         "pre_draw_setup", KX_Scene, pyattr_get_drawing_callback, pyattr_set_drawing_callback),
     EXP_PYATTRIBUTE_RW_FUNCTION("gravity", KX_Scene, pyattr_get_gravity, pyattr_set_gravity),
-    EXP_PYATTRIBUTE_BOOL_RO("activity_culling", KX_Scene, m_activity_culling),
+    EXP_PYATTRIBUTE_RW_FUNCTION("activity_culling",
+                                KX_Scene,
+                                pyattr_get_activity_culling,
+                                pyattr_set_activity_culling),
     EXP_PYATTRIBUTE_FLOAT_RW(
         "activity_culling_radius", 0.5f, FLT_MAX, KX_Scene, m_activity_box_radius),
     EXP_PYATTRIBUTE_BOOL_RO("dbvt_culling", KX_Scene, m_dbvt_culling),
@@ -3167,6 +4171,290 @@ EXP_PYMETHODDEF_DOC(KX_Scene,
   return replica->GetProxy();
 }
 
+EXP_PYMETHODDEF_DOC(KX_Scene,
+                    createObjectPool,
+                    "createObjectPool(object, size)\n"
+                    "Preallocates replicas of an inactive object recycled by addObject.\n")
+{
+  PyObject *pyob;
+  KX_GameObject *ob;
+  int size;
+
+  if (!PyArg_ParseTuple(args, "Oi:createObjectPool", &pyob, &size))
+    return nullptr;
+
+  if (!ConvertPythonToGameObject(
+          m_logicmgr, pyob, &ob, false, "scene.createObjectPool(object, size): KX_Scene")) {
+    return nullptr;
+  }
+
+  if (!m_inactivelist->SearchValue(ob)) {
+    PyErr_SetString(PyExc_ValueError,
+                    "scene.createObjectPool(object, size): KX_Scene: object must be in an "
+                    "inactive layer");
+    return nullptr;
+  }
+
+  if (size < 0) {
+    PyErr_SetString(PyExc_ValueError,
+                    "scene.createObjectPool(object, size): KX_Scene: size must be positive");
+    return nullptr;
+  }
+
+  // the instances of a collection are separate objects which can't be recycled with the replica
+  for (KX_GameObject *gameobj : object_hierarchy(ob)) {
+    if (gameobj->IsDupliGroup()) {
+      PyErr_SetString(PyExc_ValueError,
+                      "scene.createObjectPool(object, size): KX_Scene: object hierarchy must not "
+                      "instance a collection");
+      return nullptr;
+    }
+    // objects created at runtime have no blender object to reset the replicas from
+    if (!gameobj->GetBlenderObject()) {
+      PyErr_SetString(PyExc_ValueError,
+                      "scene.createObjectPool(object, size): KX_Scene: object hierarchy must not "
+                      "contain objects without a blender object");
+      return nullptr;
+    }
+  }
+
+  CreateObjectPool(ob, size);
+
+  Py_RETURN_NONE;
+}
+
+/** Ray filter of the batched ray casts, only reads the collision group of the objects to be
+ * thread safe. */
+class KX_RayCastBatchFilter : public PHY_IRayCastFilterCallback {
+ private:
+  unsigned short m_mask;
+
+ public:
+  KX_RayCastBatchFilter(unsigned short mask) : PHY_IRayCastFilterCallback(nullptr), m_mask(mask)
+  {
+  }
+
+  virtual bool needBroadphaseRayCast(PHY_IPhysicsController *controller)
+  {
+    KX_ClientObjectInfo *info = static_cast<KX_ClientObjectInfo *>(controller->GetNewClientInfo());
+    // Sensor objects are never hit by rays.
+    if (!info || info->m_type > KX_ClientObjectInfo::ACTOR) {
+      return false;
+    }
+    return (info->m_gameobject->GetUserCollisionGroup() & m_mask);
+  }
+
+  virtual void reportHit(PHY_RayCastResult *result)
+  {
+  }
+};
+
+/// Read the points of a (N, 3) float or double buffer, or of a sequence of vectors.
+static bool ray_batch_points(PyObject *value,
+                             std::vector<MT_Vector3> &points,
+                             const char *error_prefix)
+{
+  if (PyObject_CheckBuffer(value)) {
+    Py_buffer buffer;
+    if (PyObject_GetBuffer(value, &buffer, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) == -1) {
+      return false;
+    }
+
+    const char type = buffer.format ? buffer.format[strlen(buffer.format) - 1] : 'B';
+    if (buffer.ndim != 2 || buffer.shape[1] != 3 || !ELEM(type, 'f', 'd')) {
+      PyErr_Format(PyExc_ValueError, "%s, expected a (N, 3) float or double buffer", error_prefix);
+      PyBuffer_Release(&buffer);
+      return false;
+    }
+
+    points.resize(buffer.shape[0]);
+    for (unsigned int i = 0, size = points.size(); i < size; ++i) {
+      if (type == 'f') {
+        points[i] = MT_Vector3(((const float *)buffer.buf) + i * 3);
+      }
+      else {
+        points[i] = MT_Vector3(((const double *)buffer.buf) + i * 3);
+      }
+    }
+
+    PyBuffer_Release(&buffer);
+    return true;
+  }
+
+  PyObject *fast = PySequence_Fast(value, error_prefix);
+  if (!fast) {
+    return false;
+  }
+
+  const Py_ssize_t size = PySequence_Fast_GET_SIZE(fast);
+  points.resize(size);
+  for (Py_ssize_t i = 0; i < size; ++i) {
+    if (!PyVecTo(PySequence_Fast_GET_ITEM(fast, i), points[i])) {
+      Py_DECREF(fast);
+      return false;
+    }
+  }
+
+  Py_DECREF(fast);
+  return true;
+}
+
+/// Return a new (size, 3) float memoryview, usable by numpy without copy, 1-D if empty.
+static PyObject *ray_batch_float_view(unsigned int size, const std::vector<float> &data)
+{
+  PyObject *bytes = PyByteArray_FromStringAndSize((const char *)data.data(),
+                                                  data.size() * sizeof(float));
+  if (!bytes) {
+    return nullptr;
+  }
+
+  PyObject *view = PyMemoryView_FromObject(bytes);
+  Py_DECREF(bytes);
+  if (!view) {
+    return nullptr;
+  }
+
+  // A memoryview shape can't contain zero, no ray gives an empty 1-D view.
+  PyObject *shaped = (size == 0) ? PyObject_CallMethod(view, "cast", "s", "f") :
+                                   PyObject_CallMethod(view, "cast", "s(ii)", "f", size, 3);
+  Py_DECREF(view);
+  return shaped;
+}
+
+EXP_PYMETHODDEF_DOC(KX_Scene,
+                    rayCastBatch,
+                    "rayCastBatch(origins, targets, radius=0.0, mask=0xffff)\n"
+                    "Casts many rays at once, returns the list of hit objects and the (N, 3)\n"
+                    "float buffers of the hit points and normals.\n")
+{
+  PyObject *pyorigins;
+  PyObject *pytargets;
+  float radius = 0.0f;
+  int mask = (1 << OB_MAX_COL_MASKS) - 1;
+
+  static const char *kwlist[] = {"origins", "targets", "radius", "mask", nullptr};
+  if (!PyArg_ParseTupleAndKeywords(args,
+                                   kwds,
+                                   "OO|fi:rayCastBatch",
+                                   const_cast<char **>(kwlist),
+                                   &pyorigins,
+                                   &pytargets,
+                                   &radius,
+                                   &mask)) {
+    return nullptr;
+  }
+
+  if (mask == 0 || mask & ~((1 << OB_MAX_COL_MASKS) - 1)) {
+    PyErr_Format(PyExc_ValueError,
+                 "scene.rayCastBatch(origins, targets, radius, mask): KX_Scene, mask argument "
+                 "must be a int bitfield, 0 < mask < %i",
+                 (1 << OB_MAX_COL_MASKS));
+    return nullptr;
+  }
+
+  std::vector<MT_Vector3> fromPoints;
+  std::vector<MT_Vector3> toPoints;
+  if (!ray_batch_points(pyorigins,
+                        fromPoints,
+                        "scene.rayCastBatch(origins, targets, radius, mask): KX_Scene, origins") ||
+      !ray_batch_points(pytargets,
+                        toPoints,
+                        "scene.rayCastBatch(origins, targets, radius, mask): KX_Scene, targets")) {
+    return nullptr;
+  }
+
+  if (fromPoints.size() != toPoints.size()) {
+    PyErr_SetString(PyExc_ValueError,
+                    "scene.rayCastBatch(origins, targets, radius, mask): KX_Scene, origins and "
+                    "targets must have the same length");
+    return nullptr;
+  }
+
+  const unsigned int numRays = fromPoints.size();
+  std::vector<PHY_RayCastBatchResult> results(numRays);
+
+  KX_RayCastBatchFilter filter(mask);
+  m_physicsEnvironment->RayTestBatch(
+      filter, fromPoints.data(), toPoints.data(), numRays, radius, results.data());
+
+  PyObject *objects = PyList_New(numRays);
+  std::vector<float> points(numRays * 3, 0.0f);
+  std::vector<float> normals(numRays * 3, 0.0f);
+
+  for (unsigned int i = 0; i < numRays; ++i) {
+    const PHY_RayCastBatchResult &result = results[i];
+    if (!result.m_controller) {
+      PyList_SET_ITEM(objects, i, Py_INCREF_RET(Py_None));
+      continue;
+    }
+
+    KX_ClientObjectInfo *info = static_cast<KX_ClientObjectInfo *>(
+        result.m_controller->GetNewClientInfo());
+    if (!info) {
+      PyList_SET_ITEM(objects, i, Py_INCREF_RET(Py_None));
+      continue;
+    }
+
+    PyList_SET_ITEM(objects, i, info->m_gameobject->GetProxy());
+    result.m_hitPoint.getValue(&points[i * 3]);
+    result.m_hitNormal.getValue(&normals[i * 3]);
+  }
+
+  PyObject *pypoints = ray_batch_float_view(numRays, points);
+  PyObject *pynormals = pypoints ? ray_batch_float_view(numRays, normals) : nullptr;
+  if (!pynormals) {
+    Py_DECREF(objects);
+    Py_XDECREF(pypoints);
+    return nullptr;
+  }
+
+  PyObject *ret = PyTuple_New(3);
+  PyTuple_SET_ITEMS(ret, objects, pypoints, pynormals);
+  return ret;
+}
+
+EXP_PYMETHODDEF_DOC(KX_Scene,
+                    saveSnapshot,
+                    "saveSnapshot(path, delta=False)\n"
+                    "Saves the state of the objects to a binary file written in background.\n")
+{
+  const char *path;
+  int delta = 0;
+
+  static const char *kwlist[] = {"path", "delta", nullptr};
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwds, "s|i:saveSnapshot", const_cast<char **>(kwlist), &path, &delta)) {
+    return nullptr;
+  }
+
+  char expanded[FILE_MAX];
+  BLI_strncpy(expanded, path, FILE_MAX);
+  BLI_path_abs(expanded, KX_GetMainPath().c_str());
+
+  SaveSnapshot(expanded, delta != 0);
+
+  Py_RETURN_NONE;
+}
+
+EXP_PYMETHODDEF_DOC(KX_Scene,
+                    loadSnapshot,
+                    "loadSnapshot(path)\n"
+                    "Restores the state of the objects from a binary file.\n"
+                    "Return True if the snapshot was loaded, False otherwise.\n")
+{
+  const char *path;
+
+  if (!PyArg_ParseTuple(args, "s:loadSnapshot", &path)) {
+    return nullptr;
+  }
+
+  char expanded[FILE_MAX];
+  BLI_strncpy(expanded, path, FILE_MAX);
+  BLI_path_abs(expanded, KX_GetMainPath().c_str());
+
+  return PyBool_FromLong(LoadSnapshot(expanded));
+}
+
 EXP_PYMETHODDEF_DOC(KX_Scene,
                     end,
                     "end()\n"
@@ -3287,7 +4575,10 @@ EXP_PYMETHODDEF_DOC(KX_Scene,
     objectslist.push_back(ob);
   }
 
-  ConvertBlenderObjectsList(objectslist, asynchronous);
+  KX_LibLoadStatus *status = ConvertBlenderObjectsList(objectslist, asynchronous);
+  if (status) {
+    return status->GetProxy();
+  }
   Py_RETURN_NONE;
 }
 
@@ -3311,7 +4602,10 @@ EXP_PYMETHODDEF_DOC(KX_Scene,
   }
 
   Collection *co = (Collection *)id;
-  ConvertBlenderCollection(co, asynchronous);
+  KX_LibLoadStatus *status = ConvertBlenderCollection(co, asynchronous);
+  if (status) {
+    return status->GetProxy();
+  }
   Py_RETURN_NONE;
 }
 
@@ -32,7 +32,9 @@
 #pragma once
 
 #include <list>
+#include <map>
 #include <set>
+#include <unordered_map>
 #include <vector>
 
 #include "DNA_ID.h" // For IDRecalcFlag
@@ -58,6 +60,7 @@ struct Scene;
 template<class T> class EXP_ListValue;
 
 class EXP_Value;
+class KX_SceneSnapshot;
 class SCA_LogicManager;
 class SCA_KeyboardManager;
 class SCA_TimeEventManager;
@@ -72,6 +75,7 @@ class KX_Camera;
 class KX_FontObject;
 class KX_GameObject;
 class KX_LightObject;
+class KX_NavMeshObject;
 class RAS_MeshObject;
 class RAS_BucketManager;
 class RAS_MaterialBucket;
@@ -82,6 +86,7 @@ class RAS_FrameBuffer;
 class RAS_2DFilter;
 class RAS_2DFilterManager;
 class KX_2DFilterManager;
+class KX_LibLoadStatus;
 class SCA_JoystickManager;
 class btCollisionShape;
 class BL_BlenderSceneConverter;
@@ -116,6 +121,25 @@ class KX_Scene : public EXP_Value, public SCA_IScene {
     double curtime;
   };
 
+  /// Time arguments of the physics step running in the physics pool.
+  struct PhysicsPoolData {
+    double curtime;
+    double timestep;
+    double framestep;
+  };
+
+  /// Independent subtree or node updated by the parallel scene graph update.
+  struct SceneGraphUpdateItem {
+    SG_Node *node;
+    /// parentUpdated value of the node update.
+    bool parentUpdated;
+    /// True if the node and its children are updated in a task, false if the node is
+    /// already updated alone.
+    bool subtree;
+    /// Node transform changed by the update alone.
+    bool updated;
+  };
+
  private:
   Py_Header
 
@@ -157,12 +181,27 @@ class KX_Scene : public EXP_Value, public SCA_IScene {
   std::vector<std::pair<Mesh *, IDRecalcFlag>> m_meshesToUpdateInAllRenderPasses;
   std::vector<std::pair<Object *, IDRecalcFlag>> m_extraObjectsToUpdateInOverlayPass;
   std::vector<bNodeTree *> m_nodeTreesToUpdateInAllRenderPasses;
+
+  /* Objects whose transform changed since the last depsgraph synchronization,
+   * fed by the scene graph nodes tagged DIRTY_RENDER. */
+  std::vector<KX_GameObject *> m_dirtyTransformObjects;
+  /// Synchronize all the objects at the next render pass (scene start or merge).
+  bool m_syncAllTransforms;
+  /// Bases visibility changed without view layer synchronization, see TagBaseFlagsUpdate.
+  bool m_baseFlagsUpdate;
   /*************************************************/
 
   RAS_BucketManager *m_bucketmanager;
 
   std::vector<KX_GameObject *> m_tempObjectList;
 
+  /**
+   * Object pools used by AddReplicaObject, map an inactive object to its
+   * free replicas. Each pooled replica hierarchy is suspended and hidden,
+   * the pool owns the object list references of the hierarchy.
+   */
+  std::map<KX_GameObject *, std::vector<KX_GameObject *>> m_objectPools;
+
   /**
    * The list of objects which have been removed during the
    * course of one frame. They are actually destroyed in
@@ -176,6 +215,8 @@ class KX_Scene : public EXP_Value, public SCA_IScene {
   EXP_ListValue<KX_GameObject> *m_inactivelist;  // all objects that are not in the active layer
   /// All animated objects, no need of EXP_ListValue because the list isn't exposed in python.
   std::vector<KX_GameObject *> m_animatedlist;
+  /// Navigation meshes rebuilt in background, swapped at the beginning of the logic frame.
+  std::vector<KX_NavMeshObject *> m_navMeshRebuilds;
 
   /// The set of cameras for this scene
   EXP_ListValue<KX_Camera> *m_cameralist;
@@ -187,6 +228,14 @@ class KX_Scene : public EXP_Value, public SCA_IScene {
                       // the Qlist is for objects that needs to be rescheduled
                       // for updates after udpate is over (slow parent, bone parent)
 
+  /// Items of the parallel scene graph update, see UpdateParentsParallel.
+  std::vector<SceneGraphUpdateItem> m_sgUpdateItems;
+  std::vector<SceneGraphUpdateItem> m_sgSplitItems;
+  /// Nodes with a changed transform of each subtree item, in update order.
+  std::vector<std::vector<SG_Node *>> m_sgUpdatedNodes;
+  /// Position of the scheduled nodes in m_sghead.
+  std::unordered_map<SG_Node *, unsigned int> m_sgScheduledIndices;
+
   /**
    * Various SCA managers used by the scene
    */
@@ -279,6 +328,20 @@ class KX_Scene : public EXP_Value, public SCA_IScene {
    */
   bool m_activity_culling;
 
+  /**
+   * Spatial hash of the activity culled root objects, the cells are as large as the
+   * activity box radius so only the cells around the cameras are visited to resume objects.
+   */
+  std::unordered_map<uint64_t, std::vector<KX_GameObject *>> m_activityGrid;
+  /// Cell in m_activityGrid of each activity culled root object.
+  std::unordered_map<KX_GameObject *, uint64_t> m_activityCulledObjects;
+  /// Activity culled objects whose transform changed and must be put in their new cell.
+  std::vector<KX_GameObject *> m_activityMovedObjects;
+  /// Root objects not activity culled, the only objects tested to be suspended.
+  std::vector<KX_GameObject *> m_activityRoots;
+  /// Size of the cells of m_activityGrid.
+  float m_activityCellSize;
+
   /**
    * Toggle to enable or disable culling via DBVT broadphase of Bullet.
    */
@@ -315,6 +378,25 @@ class KX_Scene : public EXP_Value, public SCA_IScene {
   AnimationPoolData m_animationPoolData;
   TaskPool *m_animationPool;
 
+  PhysicsPoolData m_physicsPoolData;
+  /// Background pool running the physics step while the previous frame is rendered.
+  TaskPool *m_physicsPool;
+  /// True while a physics step is running or not yet followed by its scene graph update.
+  bool m_physicsPending;
+
+  /// State of the last written or loaded snapshot, base of the delta snapshots.
+  KX_SceneSnapshot *m_lastSnapshot;
+  /// Background serial pool writing the snapshot files in order.
+  TaskPool *m_snapshotPool;
+
+  /// Frame counter used to spread the delayed pose updates of the animation level of detail.
+  unsigned int m_animationLodFrame;
+
+  /** Update the culling state of the animated armatures' children from the culling camera
+   * and delay the pose update of the far armatures when the animation level of detail is used.
+   */
+  void UpdateAnimationsCulling();
+
   /**
    * LOD Hysteresis settings
    */
@@ -336,8 +418,10 @@ class KX_Scene : public EXP_Value, public SCA_IScene {
 
   /******************EEVEE INTEGRATION************************/
   void ConvertBlenderObject(struct Object *ob);
-  void ConvertBlenderObjectsList(std::vector<Object *> objectslist, bool asynchronous);
-  void ConvertBlenderCollection(struct Collection *co, bool asynchronous);
+  /// Return the conversion status when asynchronous, else nullptr.
+  KX_LibLoadStatus *ConvertBlenderObjectsList(std::vector<Object *> objectslist,
+                                              bool asynchronous);
+  KX_LibLoadStatus *ConvertBlenderCollection(struct Collection *co, bool asynchronous);
   void ConvertBlenderAction(struct bAction *act);
 
   bool m_isRuntime;  // Too lazy to put that in protected
@@ -386,6 +470,15 @@ class KX_Scene : public EXP_Value, public SCA_IScene {
   void AppendToNodeTreesToUpdateInAllRenderPasses(bNodeTree *ntree);
   void AppendToExtraObjectsToUpdateInOverlayPass(Object *ob, IDRecalcFlag flag);
   void TagForExtraObjectsUpdate(Main *bmain, KX_Camera *cam);
+  /// Register an object to synchronize with the depsgraph at the next render pass.
+  void AddDirtyTransformObject(KX_GameObject *gameobj);
+  void ClearDirtyTransformObjects();
+  /// Synchronize the view layer bases at the next render pass.
+  void TagBaseFlagsUpdate();
+  /// Notify the depsgraph of the transform changes of the dirty objects.
+  void TagDirtyTransformsForUpdate(bool is_last_render_pass);
+  /// Copy the transform of the dirty objects to the evaluated objects.
+  void TagDirtyTransformsEvaluated(bool is_last_render_pass);
   KX_GameObject *AddDuplicaObject(KX_GameObject *gameobj, KX_GameObject *reference, float lifespan);
   /***************End of EEVEE INTEGRATION**********************/
 
@@ -398,6 +491,11 @@ class KX_Scene : public EXP_Value, public SCA_IScene {
   static bool KX_ScenegraphUpdateFunc(SG_Node *node, void *gameobj, void *scene);
   static bool KX_ScenegraphRescheduleFunc(SG_Node *node, void *gameobj, void *scene);
   void UpdateParents(double curtime);
+  /** Update the scheduled nodes by independent subtrees in parallel, the transform
+   * callbacks are called afterward in the order of the serial update.
+   * \return False if the serial update must be used instead.
+   */
+  bool UpdateParentsParallel(double curtime);
   void DupliGroupRecurse(KX_GameObject *groupobj, int level);
   bool IsObjectInGroup(KX_GameObject *gameobj)
   {
@@ -409,6 +507,21 @@ class KX_Scene : public EXP_Value, public SCA_IScene {
                                   KX_GameObject *locationobj,
                                   float lifespan = 0.0f);
   KX_GameObject *AddNodeReplicaObject(SG_Node *node, KX_GameObject *gameobj);
+  /**
+   * Create or grow the pool of an inactive object, the replicas added from this object
+   * are then recycled instead of being duplicated and freed.
+   * \param gameobj The inactive object to pool.
+   * \param size The number of replicas to preallocate.
+   */
+  void CreateObjectPool(KX_GameObject *gameobj, unsigned int size);
+  /// Recycle a free replica of a pooled object.
+  KX_GameObject *SpawnPooledObject(KX_GameObject *gameobj,
+                                   KX_GameObject *referenceobj,
+                                   float lifespan);
+  /// Suspend and hide a removed pooled replica and give it back to its pool.
+  void ReleaseToObjectPool(KX_GameObject *gameobj);
+  /// Remove all the free replicas of a pooled object.
+  void FreeObjectPool(KX_GameObject *gameobj);
   void RemoveNodeDestructObject(SG_Node *node, KX_GameObject *gameobj);
   void RemoveObject(KX_GameObject *gameobj);
   void RemoveDupliGroup(KX_GameObject *gameobj);
@@ -418,6 +531,7 @@ class KX_Scene : public EXP_Value, public SCA_IScene {
   void ReplaceMesh(KX_GameObject *gameobj, RAS_MeshObject *mesh, bool use_gfx, bool use_phys);
 
   void AddAnimatedObject(KX_GameObject *gameobj);
+  void AddNavMeshRebuild(KX_NavMeshObject *navmesh);
 
   /**
    * \section Logic stuff
@@ -427,11 +541,35 @@ class KX_Scene : public EXP_Value, public SCA_IScene {
   void LogicUpdateFrame(double curtime);
   void UpdateAnimations(double curtime);
 
+  /** Start the physics step in a background task, the world transforms of the scene graph
+   * are only modified by FinishPhysics and can be read meanwhile by the render.
+   */
+  void ProceedPhysicsAsync(double curtime, double timestep, double framestep);
+  /// Wait for the end of the running physics step without updating the scene graph.
+  void WaitPhysics();
+  /// Wait for the physics step and apply its result to the scene graph.
+  void FinishPhysics();
+
+  /** Capture the state of the objects and write it to a file in a background task.
+   * \param delta Write only the objects changed since the last written or loaded snapshot,
+   * the pending snapshot writes are finished before.
+   */
+  void SaveSnapshot(const std::string &path, bool delta);
+  /** Restore the state of the objects from a snapshot file, the pending snapshot writes are
+   * finished before.
+   * \return False if the file can't be read or is not a valid snapshot.
+   */
+  bool LoadSnapshot(const std::string &path);
+
   void LogicEndFrame();
 
   EXP_ListValue<KX_GameObject> *GetObjectList() const;
   EXP_ListValue<KX_GameObject> *GetInactiveList() const;
   EXP_ListValue<KX_GameObject> *GetRootParentList() const;
+  /// Add an object to the root parent list, the list takes a reference.
+  void AddRootObject(KX_GameObject *gameobj);
+  /// Remove an object from the root parent list, return true if it was found.
+  bool RemoveRootObject(KX_GameObject *gameobj);
   EXP_ListValue<KX_LightObject> *GetLightList() const;
 
   SCA_LogicManager *GetLogicManager() const;
@@ -510,6 +648,12 @@ class KX_Scene : public EXP_Value, public SCA_IScene {
 
   // Update the activity box settings for objects in this scene, if needed.
   void UpdateObjectActivity(void);
+  /// Suspend or resume a root object hierarchy and index it for activity culling.
+  void SetObjectActivityCulled(KX_GameObject *gameobj, bool culled);
+  /// Return the activity grid cell containing a position.
+  uint64_t GetActivityCell(const MT_Vector3 &pos) const;
+  /// Remove an object from the activity culling index without resuming it.
+  void RemoveActivityCulledObject(KX_GameObject *gameobj);
 
   // Enable/disable activity culling.
   void SetActivityCulling(bool b);
@@ -575,6 +719,10 @@ class KX_Scene : public EXP_Value, public SCA_IScene {
   /* --------------------------------------------------------------------- */
 
   EXP_PYMETHOD_DOC(KX_Scene, addObject);
+  EXP_PYMETHOD_DOC(KX_Scene, createObjectPool);
+  EXP_PYMETHOD_DOC(KX_Scene, rayCastBatch);
+  EXP_PYMETHOD_DOC(KX_Scene, saveSnapshot);
+  EXP_PYMETHOD_DOC(KX_Scene, loadSnapshot);
   EXP_PYMETHOD_DOC(KX_Scene, end);
   EXP_PYMETHOD_DOC(KX_Scene, restart);
   EXP_PYMETHOD_DOC(KX_Scene, replace);
@@ -626,6 +774,11 @@ class KX_Scene : public EXP_Value, public SCA_IScene {
   static int pyattr_set_gravity(EXP_PyObjectPlus *self_v,
                                 const EXP_PYATTRIBUTE_DEF *attrdef,
                                 PyObject *value);
+  static PyObject *pyattr_get_activity_culling(EXP_PyObjectPlus *self_v,
+                                              const EXP_PYATTRIBUTE_DEF *attrdef);
+  static int pyattr_set_activity_culling(EXP_PyObjectPlus *self_v,
+                                         const EXP_PYATTRIBUTE_DEF *attrdef,
+                                         PyObject *value);
 
   /* getitem/setitem */
   static PyMappingMethods Mapping;
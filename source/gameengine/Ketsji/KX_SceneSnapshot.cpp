@@ -0,0 +1,430 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Ketsji/KX_SceneSnapshot.cpp
+ *  \ingroup ketsji
+ */
+
+#include "KX_SceneSnapshot.h"
+
+#include <cstring>
+#include <stdint.h>
+
+#include "CM_Message.h"
+#include "EXP_BoolValue.h"
+#include "EXP_FloatValue.h"
+#include "EXP_IntValue.h"
+#include "EXP_StringValue.h"
+#include "KX_GameObject.h"
+#include "KX_Scene.h"
+#include "PHY_IPhysicsController.h"
+
+/* The data is written in the native byte order:
+ * - header: magic (8 bytes), version (uint32), flags (uint32), number of records (uint32).
+ * - records: key (string), data (string), a string is its size (uint32) followed by its bytes.
+ * - record data: local position (3 floats), orientation (9 floats), scale (3 floats),
+ *   dynamic (uint8) followed by the linear and angular velocities (6 floats) if not 0,
+ *   number of properties (uint32) and for each its name (string), type (uint8) and value,
+ *   number of actions (uint32) and for each its layer state.
+ */
+
+static const char snapshotMagic[8] = {'B', 'G', 'E', 'S', 'N', 'A', 'P', '\0'};
+
+enum {
+  SNAPSHOT_DELTA = (1 << 0),
+};
+
+enum {
+  SNAPSHOT_PROP_INT = 0,
+  SNAPSHOT_PROP_FLOAT,
+  SNAPSHOT_PROP_BOOL,
+  SNAPSHOT_PROP_STRING,
+};
+
+template<class Value> static void write_value(std::string &data, const Value &value)
+{
+  data.append((const char *)&value, sizeof(Value));
+}
+
+static void write_string(std::string &data, const std::string &str)
+{
+  write_value(data, (uint32_t)str.size());
+  data.append(str);
+}
+
+static void write_floats(std::string &data, const float *values, unsigned int size)
+{
+  data.append((const char *)values, sizeof(float) * size);
+}
+
+/// Bounds checked reading of serialized values.
+class SnapshotReader {
+ private:
+  const char *m_data;
+  size_t m_size;
+  size_t m_pos;
+  bool m_valid;
+
+ public:
+  SnapshotReader(const char *data, size_t size)
+      : m_data(data), m_size(size), m_pos(0), m_valid(true)
+  {
+  }
+
+  bool IsValid() const
+  {
+    return m_valid;
+  }
+
+  void Invalidate()
+  {
+    m_valid = false;
+  }
+
+  bool ReadBytes(void *dst, size_t size)
+  {
+    if (!m_valid || size > m_size - m_pos) {
+      m_valid = false;
+      return false;
+    }
+    memcpy(dst, m_data + m_pos, size);
+    m_pos += size;
+    return true;
+  }
+
+  template<class Value> Value Read()
+  {
+    Value value = Value();
+    ReadBytes(&value, sizeof(Value));
+    return value;
+  }
+
+  std::string ReadString()
+  {
+    const uint32_t size = Read<uint32_t>();
+    if (!m_valid || size > m_size - m_pos) {
+      m_valid = false;
+      return "";
+    }
+    const std::string str(m_data + m_pos, size);
+    m_pos += size;
+    return str;
+  }
+
+  void ReadFloats(float *values, unsigned int size)
+  {
+    ReadBytes(values, sizeof(float) * size);
+  }
+};
+
+/// Serialize the state of an object.
+static void write_object_record(KX_GameObject *gameobj, std::string &record)
+{
+  float position[3], orientation[9], scale[3];
+  gameobj->NodeGetLocalPosition().getValue(position);
+  gameobj->NodeGetLocalOrientation().getValue3x3(orientation);
+  gameobj->NodeGetLocalScaling().getValue(scale);
+  write_floats(record, position, 3);
+  write_floats(record, orientation, 9);
+  write_floats(record, scale, 3);
+
+  PHY_IPhysicsController *controller = gameobj->GetPhysicsController();
+  const bool dynamic = controller && controller->IsDynamic();
+  write_value(record, (uint8_t)dynamic);
+  if (dynamic) {
+    float linearVelocity[3], angularVelocity[3];
+    gameobj->GetLinearVelocity(false).getValue(linearVelocity);
+    gameobj->GetAngularVelocity(false).getValue(angularVelocity);
+    write_floats(record, linearVelocity, 3);
+    write_floats(record, angularVelocity, 3);
+  }
+
+  // Only the property types of the logic bricks are saved.
+  std::string properties;
+  uint32_t numProperties = 0;
+  for (const std::string &name : gameobj->GetPropertyNames()) {
+    EXP_Value *prop = gameobj->GetProperty(name);
+    switch (prop->GetValueType()) {
+      case VALUE_INT_TYPE: {
+        write_string(properties, name);
+        write_value(properties, (uint8_t)SNAPSHOT_PROP_INT);
+        write_value(properties, (int64_t) static_cast<EXP_IntValue *>(prop)->GetInt());
+        break;
+      }
+      case VALUE_FLOAT_TYPE: {
+        write_string(properties, name);
+        write_value(properties, (uint8_t)SNAPSHOT_PROP_FLOAT);
+        write_value(properties, (double)prop->GetNumber());
+        break;
+      }
+      case VALUE_BOOL_TYPE: {
+        write_string(properties, name);
+        write_value(properties, (uint8_t)SNAPSHOT_PROP_BOOL);
+        write_value(properties, (uint8_t) static_cast<EXP_BoolValue *>(prop)->GetBool());
+        break;
+      }
+      case VALUE_STRING_TYPE: {
+        write_string(properties, name);
+        write_value(properties, (uint8_t)SNAPSHOT_PROP_STRING);
+        write_string(properties, prop->GetText());
+        break;
+      }
+      default: {
+        continue;
+      }
+    }
+    ++numProperties;
+  }
+  write_value(record, numProperties);
+  record.append(properties);
+
+  const std::vector<BL_ActionManager::LayerState> states = gameobj->GetActionLayerStates();
+  write_value(record, (uint32_t)states.size());
+  for (const BL_ActionManager::LayerState &state : states) {
+    write_value(record, state.layer);
+    write_string(record, state.name);
+    write_value(record, state.start);
+    write_value(record, state.end);
+    write_value(record, state.frame);
+    write_value(record, state.layerWeight);
+    write_value(record, state.speed);
+    write_value(record, state.priority);
+    write_value(record, state.playMode);
+    write_value(record, state.ipoFlags);
+    write_value(record, state.blendMode);
+  }
+}
+
+/// Restore the state of an object, return false if the record is invalid.
+static bool read_object_record(KX_GameObject *gameobj, const std::string &record)
+{
+  SnapshotReader reader(record.data(), record.size());
+
+  float position[3], orientation[9], scale[3];
+  reader.ReadFloats(position, 3);
+  reader.ReadFloats(orientation, 9);
+  reader.ReadFloats(scale, 3);
+
+  const bool dynamic = reader.Read<uint8_t>();
+  float linearVelocity[3], angularVelocity[3];
+  if (dynamic) {
+    reader.ReadFloats(linearVelocity, 3);
+    reader.ReadFloats(angularVelocity, 3);
+  }
+
+  // Read all the record before modifying the object to not apply a part of an invalid record.
+  std::vector<std::pair<std::string, EXP_Value *>> properties;
+  const uint32_t numProperties = reader.Read<uint32_t>();
+  for (uint32_t i = 0; i < numProperties && reader.IsValid(); ++i) {
+    const std::string name = reader.ReadString();
+    EXP_Value *value = nullptr;
+    switch (reader.Read<uint8_t>()) {
+      case SNAPSHOT_PROP_INT: {
+        value = new EXP_IntValue((cInt)reader.Read<int64_t>());
+        break;
+      }
+      case SNAPSHOT_PROP_FLOAT: {
+        value = new EXP_FloatValue((float)reader.Read<double>());
+        break;
+      }
+      case SNAPSHOT_PROP_BOOL: {
+        value = new EXP_BoolValue(reader.Read<uint8_t>() != 0);
+        break;
+      }
+      case SNAPSHOT_PROP_STRING: {
+        value = new EXP_StringValue(reader.ReadString(), "");
+        break;
+      }
+    }
+    if (!value) {
+      reader.Invalidate();
+      break;
+    }
+    properties.emplace_back(name, value);
+  }
+
+  std::vector<BL_ActionManager::LayerState> states;
+  const uint32_t numStates = reader.Read<uint32_t>();
+  for (uint32_t i = 0; i < numStates && reader.IsValid(); ++i) {
+    BL_ActionManager::LayerState state;
+    state.layer = reader.Read<short>();
+    state.name = reader.ReadString();
+    state.start = reader.Read<float>();
+    state.end = reader.Read<float>();
+    state.frame = reader.Read<float>();
+    state.layerWeight = reader.Read<float>();
+    state.speed = reader.Read<float>();
+    state.priority = reader.Read<short>();
+    state.playMode = reader.Read<short>();
+    state.ipoFlags = reader.Read<short>();
+    state.blendMode = reader.Read<short>();
+    states.push_back(state);
+  }
+
+  const bool valid = reader.IsValid();
+  if (valid) {
+    gameobj->NodeSetLocalPosition(MT_Vector3(position));
+    MT_Matrix3x3 rot;
+    rot.setValue3x3(orientation);
+    gameobj->NodeSetLocalOrientation(rot);
+    gameobj->NodeSetLocalScale(MT_Vector3(scale));
+
+    if (dynamic && gameobj->GetPhysicsController()) {
+      gameobj->setLinearVelocity(MT_Vector3(linearVelocity), false);
+      gameobj->setAngularVelocity(MT_Vector3(angularVelocity), false);
+    }
+  }
+
+  for (const std::pair<std::string, EXP_Value *> &pair : properties) {
+    if (valid) {
+      EXP_Value *oldprop = gameobj->GetProperty(pair.first);
+      if (oldprop && oldprop->GetValueType() == pair.second->GetValueType()) {
+        oldprop->SetValue(pair.second);
+      }
+      else {
+        gameobj->SetProperty(pair.first, pair.second);
+      }
+    }
+    pair.second->Release();
+  }
+
+  if (valid) {
+    gameobj->SetActionLayerStates(states);
+  }
+
+  return valid;
+}
+
+/// Key of an object record, the objects of the same name are distinguished by their order.
+static std::string get_object_key(KX_GameObject *gameobj,
+                                  std::map<std::string, unsigned int> &occurrences)
+{
+  const std::string name = gameobj->GetName();
+  return name + "#" + std::to_string(occurrences[name]++);
+}
+
+KX_SceneSnapshot::KX_SceneSnapshot() : m_delta(false)
+{
+}
+
+KX_SceneSnapshot::~KX_SceneSnapshot()
+{
+}
+
+bool KX_SceneSnapshot::IsDelta() const
+{
+  return m_delta;
+}
+
+void KX_SceneSnapshot::Capture(KX_Scene *scene)
+{
+  m_records.clear();
+  m_delta = false;
+
+  std::map<std::string, unsigned int> occurrences;
+  for (KX_GameObject *gameobj : *scene->GetObjectList()) {
+    write_object_record(gameobj, m_records[get_object_key(gameobj, occurrences)]);
+  }
+}
+
+void KX_SceneSnapshot::Write(std::vector<char> &data, const KX_SceneSnapshot *base) const
+{
+  std::string records;
+  uint32_t numRecords = 0;
+  for (const auto &pair : m_records) {
+    if (base) {
+      const std::map<std::string, std::string>::const_iterator it = base->m_records.find(
+          pair.first);
+      if (it != base->m_records.end() && it->second == pair.second) {
+        continue;
+      }
+    }
+
+    write_string(records, pair.first);
+    write_string(records, pair.second);
+    ++numRecords;
+  }
+
+  std::string out(snapshotMagic, sizeof(snapshotMagic));
+  write_value(out, (uint32_t)SNAPSHOT_VERSION);
+  write_value(out, (uint32_t)(base ? SNAPSHOT_DELTA : 0));
+  write_value(out, numRecords);
+  out.append(records);
+
+  data.assign(out.begin(), out.end());
+}
+
+bool KX_SceneSnapshot::Read(const std::vector<char> &data)
+{
+  m_records.clear();
+  m_delta = false;
+
+  SnapshotReader reader(data.data(), data.size());
+  char magic[sizeof(snapshotMagic)];
+  if (!reader.ReadBytes(magic, sizeof(magic)) || memcmp(magic, snapshotMagic, sizeof(magic))) {
+    CM_Error("not a game state snapshot");
+    return false;
+  }
+
+  const uint32_t version = reader.Read<uint32_t>();
+  if (version != SNAPSHOT_VERSION) {
+    CM_Error("unsupported game state snapshot version " << version << ", expected "
+                                                        << SNAPSHOT_VERSION);
+    return false;
+  }
+
+  m_delta = (reader.Read<uint32_t>() & SNAPSHOT_DELTA);
+  const uint32_t numRecords = reader.Read<uint32_t>();
+  for (uint32_t i = 0; i < numRecords && reader.IsValid(); ++i) {
+    const std::string key = reader.ReadString();
+    m_records[key] = reader.ReadString();
+  }
+
+  if (!reader.IsValid()) {
+    CM_Error("truncated game state snapshot");
+    m_records.clear();
+    return false;
+  }
+
+  return true;
+}
+
+void KX_SceneSnapshot::Apply(KX_Scene *scene) const
+{
+  std::map<std::string, unsigned int> occurrences;
+  for (KX_GameObject *gameobj : *scene->GetObjectList()) {
+    const std::map<std::string, std::string>::const_iterator it = m_records.find(
+        get_object_key(gameobj, occurrences));
+    if (it == m_records.end()) {
+      continue;
+    }
+
+    if (!read_object_record(gameobj, it->second)) {
+      CM_Error("invalid game state snapshot record for object \"" << gameobj->GetName() << "\"");
+    }
+  }
+
+  // Update the world transforms from the restored local transforms.
+  for (KX_GameObject *gameobj : *scene->GetRootParentList()) {
+    gameobj->NodeUpdateGS(0.0);
+  }
+}
@@ -0,0 +1,74 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file KX_SceneSnapshot.h
+ *  \ingroup ketsji
+ */
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+class KX_Scene;
+
+/** Binary snapshot of the state of the objects of a scene: local transforms, physics
+ * velocities, game properties and playing actions.
+ * The snapshot is made of one record per object, identified by the object name and its
+ * occurrence among the objects of the same name. A delta snapshot only contains the records
+ * which changed since a base snapshot, applying a full snapshot then its deltas in order
+ * restores the last state. Objects are never added or removed by a snapshot.
+ */
+class KX_SceneSnapshot {
+ public:
+  enum {
+    /// Version of the binary format, increased for every incompatible change.
+    SNAPSHOT_VERSION = 1
+  };
+
+ private:
+  /// Serialized state by object key.
+  std::map<std::string, std::string> m_records;
+  /// True if the snapshot was read from a delta.
+  bool m_delta;
+
+ public:
+  KX_SceneSnapshot();
+  ~KX_SceneSnapshot();
+
+  bool IsDelta() const;
+
+  /// Capture the state of all the active objects of the scene.
+  void Capture(KX_Scene *scene);
+  /** Serialize the snapshot in data.
+   * \param base The snapshot used to write a delta, only the records different from base are
+   * written. nullptr to write all the records.
+   */
+  void Write(std::vector<char> &data, const KX_SceneSnapshot *base) const;
+  /** Read a snapshot serialized by Write.
+   * \return False if the data is not a snapshot or of an unsupported version.
+   */
+  bool Read(const std::vector<char> &data);
+  /// Restore the state of the objects of the scene which have a record.
+  void Apply(KX_Scene *scene) const;
+};
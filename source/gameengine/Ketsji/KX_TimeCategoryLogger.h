@@ -113,6 +113,11 @@ class KX_TimeCategoryLogger {
    */
   double GetAverage();
 
+  /**
+   * Returns the last complete measurement of a category.
+   */
+  double GetLast(TimeCategory tc);
+
  protected:
   const CM_Clock &m_clock;
   /// Storage for the loggers.
@@ -0,0 +1,299 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Ketsji/KX_VertexBuffer.cpp
+ *  \ingroup ketsji
+ */
+
+#ifdef WITH_PYTHON
+
+#  include "KX_VertexBuffer.h"
+
+#  include <cstring>
+
+#  include "RAS_IDisplayArray.h"
+
+/// Stream names, number of components and component format.
+static const struct {
+  const char *name;
+  unsigned int numComponents;
+  const char *format;
+} streamInfos[KX_VertexBuffer::STREAM_MAX] = {
+    {"position", 3, "f"},
+    {"normal", 3, "f"},
+    {"tangent", 4, "f"},
+    {"uv", 2, "f"},
+    {"color", 4, "B"},
+};
+
+KX_VertexBuffer::KX_VertexBuffer(RAS_IDisplayArray *array,
+                                 StreamType stream,
+                                 unsigned short layer)
+    : m_array(array->AddRef()), m_stream(stream), m_layer(layer)
+{
+  m_shape[0] = m_array->GetVertexCount();
+  m_shape[1] = streamInfos[m_stream].numComponents;
+  m_strides[0] = m_array->GetVertexMemorySize();
+  m_strides[1] = GetItemSize();
+}
+
+KX_VertexBuffer::~KX_VertexBuffer()
+{
+  m_array->Release();
+}
+
+std::string KX_VertexBuffer::GetName()
+{
+  return "KX_VertexBuffer";
+}
+
+KX_VertexBuffer::StreamType KX_VertexBuffer::GetStreamType(const std::string &name)
+{
+  for (unsigned short i = 0; i < STREAM_MAX; ++i) {
+    if (name == streamInfos[i].name) {
+      return (StreamType)i;
+    }
+  }
+  return STREAM_MAX;
+}
+
+bool KX_VertexBuffer::IsValidLayer(RAS_IDisplayArray *array,
+                                   StreamType stream,
+                                   unsigned short layer)
+{
+  switch (stream) {
+    case STREAM_UV: {
+      return (layer < array->GetVertexUvSize());
+    }
+    case STREAM_COLOR: {
+      return (layer < array->GetVertexColorSize());
+    }
+    default: {
+      return (layer == 0);
+    }
+  }
+}
+
+unsigned short KX_VertexBuffer::GetModifiedFlag() const
+{
+  switch (m_stream) {
+    case STREAM_POSITION: {
+      return RAS_IDisplayArray::POSITION_MODIFIED;
+    }
+    case STREAM_NORMAL: {
+      return RAS_IDisplayArray::NORMAL_MODIFIED;
+    }
+    case STREAM_TANGENT: {
+      return RAS_IDisplayArray::TANGENT_MODIFIED;
+    }
+    case STREAM_UV: {
+      return RAS_IDisplayArray::UVS_MODIFIED;
+    }
+    case STREAM_COLOR: {
+      return RAS_IDisplayArray::COLORS_MODIFIED;
+    }
+    default: {
+      return RAS_IDisplayArray::NONE_MODIFIED;
+    }
+  }
+}
+
+unsigned int KX_VertexBuffer::GetItemSize() const
+{
+  return (m_stream == STREAM_COLOR) ? sizeof(unsigned char) : sizeof(float);
+}
+
+char *KX_VertexBuffer::GetData() const
+{
+  char *data = (char *)m_array->GetVertexPointer();
+  switch (m_stream) {
+    case STREAM_POSITION: {
+      return data + m_array->GetVertexXYZOffset();
+    }
+    case STREAM_NORMAL: {
+      return data + m_array->GetVertexNormalOffset();
+    }
+    case STREAM_TANGENT: {
+      return data + m_array->GetVertexTangentOffset();
+    }
+    case STREAM_UV: {
+      return data + m_array->GetVertexUVOffset() + sizeof(float[2]) * m_layer;
+    }
+    case STREAM_COLOR: {
+      return data + m_array->GetVertexColorOffset() + sizeof(unsigned int) * m_layer;
+    }
+    default: {
+      return nullptr;
+    }
+  }
+}
+
+int KX_VertexBuffer::GetBuffer(PyObject *self, Py_buffer *view, int flags)
+{
+  KX_VertexBuffer *buffer = static_cast<KX_VertexBuffer *>(EXP_PROXY_REF(self));
+  if (!buffer) {
+    PyErr_SetString(PyExc_BufferError, "KX_VertexBuffer, " EXP_PROXY_ERROR_MSG);
+    return -1;
+  }
+
+  // The vertices are interleaved, the buffer can only be exported with its strides.
+  if ((flags & PyBUF_STRIDES) != PyBUF_STRIDES) {
+    PyErr_SetString(PyExc_BufferError,
+                    "KX_VertexBuffer, the vertex data is not contiguous, strides are required");
+    return -1;
+  }
+
+  view->buf = buffer->GetData();
+  view->obj = self;
+  Py_INCREF(self);
+  view->len = buffer->m_shape[0] * buffer->m_shape[1] * buffer->m_strides[1];
+  view->readonly = 0;
+  view->itemsize = buffer->m_strides[1];
+  view->format = (flags & PyBUF_FORMAT) ? (char *)streamInfos[buffer->m_stream].format : nullptr;
+  view->ndim = 2;
+  view->shape = buffer->m_shape;
+  view->strides = buffer->m_strides;
+  view->suboffsets = nullptr;
+  view->internal = nullptr;
+
+  return 0;
+}
+
+PyBufferProcs KX_VertexBuffer::BufferProcs = {KX_VertexBuffer::GetBuffer, nullptr};
+
+PyTypeObject KX_VertexBuffer::Type = {PyVarObject_HEAD_INIT(nullptr, 0) "KX_VertexBuffer",
+                                      sizeof(EXP_PyObjectPlus_Proxy),
+                                      0,
+                                      py_base_dealloc,
+                                      0,
+                                      0,
+                                      0,
+                                      0,
+                                      py_base_repr,
+                                      0,
+                                      0,
+                                      0,
+                                      0,
+                                      0,
+                                      0,
+                                      0,
+                                      0,
+                                      &BufferProcs,
+                                      Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,
+                                      0,
+                                      0,
+                                      0,
+                                      0,
+                                      0,
+                                      0,
+                                      0,
+                                      Methods,
+                                      0,
+                                      0,
+                                      &EXP_Value::Type,
+                                      0,
+                                      0,
+                                      0,
+                                      0,
+                                      0,
+                                      0,
+                                      py_base_new};
+
+PyMethodDef KX_VertexBuffer::Methods[] = {
+    EXP_PYMETHODTABLE_NOARGS(KX_VertexBuffer, update),
+    EXP_PYMETHODTABLE_O(KX_VertexBuffer, write),
+    {nullptr, nullptr}  // Sentinel
+};
+
+PyAttributeDef KX_VertexBuffer::Attributes[] = {
+    EXP_PYATTRIBUTE_RO_FUNCTION("numVertices", KX_VertexBuffer, pyattr_get_num_vertices),
+    EXP_PYATTRIBUTE_NULL  // Sentinel
+};
+
+EXP_PYMETHODDEF_DOC_NOARGS(KX_VertexBuffer,
+                           update,
+                           "update()\n"
+                           "Notify the data was modified in place through the buffer.\n")
+{
+  m_array->AppendModifiedFlag(GetModifiedFlag());
+  Py_RETURN_NONE;
+}
+
+EXP_PYMETHODDEF_DOC_O(KX_VertexBuffer,
+                      write,
+                      "write(data)\n"
+                      "Copy a contiguous buffer of one row per vertex in the stream.\n")
+{
+  Py_buffer source;
+  if (PyObject_GetBuffer(value, &source, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) == -1) {
+    return nullptr;
+  }
+
+  const unsigned int itemSize = m_strides[1];
+  const unsigned int rowSize = m_shape[1] * itemSize;
+  const char *format = streamInfos[m_stream].format;
+  // Accept the native format with or without the native byte order prefix.
+  const char *sourceFormat = source.format ? source.format : "B";
+  if (sourceFormat[0] == '@' || sourceFormat[0] == '=') {
+    ++sourceFormat;
+  }
+
+  if (source.itemsize != itemSize || strcmp(sourceFormat, format) != 0) {
+    PyErr_Format(PyExc_TypeError,
+                 "buffer.write(data): KX_VertexBuffer, expected a buffer of format '%s'",
+                 format);
+    PyBuffer_Release(&source);
+    return nullptr;
+  }
+  if (source.len != m_shape[0] * rowSize) {
+    PyErr_Format(PyExc_ValueError,
+                 "buffer.write(data): KX_VertexBuffer, expected %i items, got %i",
+                 (int)(m_shape[0] * m_shape[1]),
+                 (int)(source.len / itemSize));
+    PyBuffer_Release(&source);
+    return nullptr;
+  }
+
+  const char *src = (const char *)source.buf;
+  char *dst = GetData();
+  for (unsigned int i = 0, size = m_shape[0]; i < size; ++i) {
+    memcpy(dst, src, rowSize);
+    src += rowSize;
+    dst += m_strides[0];
+  }
+
+  PyBuffer_Release(&source);
+
+  // Mark the display array modified once for all the vertices.
+  m_array->AppendModifiedFlag(GetModifiedFlag());
+
+  Py_RETURN_NONE;
+}
+
+PyObject *KX_VertexBuffer::pyattr_get_num_vertices(EXP_PyObjectPlus *self_v,
+                                                   const EXP_PYATTRIBUTE_DEF *attrdef)
+{
+  KX_VertexBuffer *self = static_cast<KX_VertexBuffer *>(self_v);
+  return PyLong_FromLong(self->m_shape[0]);
+}
+
+#endif  // WITH_PYTHON
@@ -0,0 +1,89 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file KX_VertexBuffer.h
+ *  \ingroup ketsji
+ */
+
+#pragma once
+
+#ifdef WITH_PYTHON
+
+#  include "EXP_Value.h"
+
+class RAS_IDisplayArray;
+
+/** Python view on one vertex attribute (position, normal...) of a display array.
+ * The data is exposed without copy through the buffer protocol as a 2D strided
+ * array of one row per vertex. The display array is referenced so the exported
+ * views stay valid after the mesh is freed.
+ */
+class KX_VertexBuffer : public EXP_Value {
+  Py_Header
+
+      public : enum StreamType {
+        STREAM_POSITION = 0,
+        STREAM_NORMAL,
+        STREAM_TANGENT,
+        STREAM_UV,
+        STREAM_COLOR,
+        STREAM_MAX
+      };
+
+ protected:
+  RAS_IDisplayArray *m_array;
+  StreamType m_stream;
+  /// UV or color layer.
+  unsigned short m_layer;
+
+  /// Shape and strides of the exported buffer, referenced by the Py_buffer.
+  Py_ssize_t m_shape[2];
+  Py_ssize_t m_strides[2];
+
+  /// Display array modified flag corresponding to the stream.
+  unsigned short GetModifiedFlag() const;
+  /// Size of one stream component in bytes.
+  unsigned int GetItemSize() const;
+  char *GetData() const;
+
+  static int GetBuffer(PyObject *self, Py_buffer *view, int flags);
+  static PyBufferProcs BufferProcs;
+
+ public:
+  KX_VertexBuffer(RAS_IDisplayArray *array, StreamType stream, unsigned short layer);
+  virtual ~KX_VertexBuffer();
+
+  virtual std::string GetName();
+
+  /// Convert a stream name to a stream type, return STREAM_MAX for an unknown name.
+  static StreamType GetStreamType(const std::string &name);
+  /// Return true if the display array has the layer for the stream.
+  static bool IsValidLayer(RAS_IDisplayArray *array, StreamType stream, unsigned short layer);
+
+  EXP_PYMETHOD_DOC_NOARGS(KX_VertexBuffer, update);
+  EXP_PYMETHOD_DOC_O(KX_VertexBuffer, write);
+
+  static PyObject *pyattr_get_num_vertices(EXP_PyObjectPlus *self_v,
+                                           const EXP_PYATTRIBUTE_DEF *attrdef);
+};
+
+#endif  // WITH_PYTHON
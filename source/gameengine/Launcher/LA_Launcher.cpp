@@ -141,6 +141,17 @@ void LA_Launcher::InitEngine()
   bool frameRate = (SYS_GetCommandLineInt(syshandle, "show_framerate", 0) != 0);
   bool nodepwarnings = (SYS_GetCommandLineInt(syshandle, "ignore_deprecation_warnings", 1) != 0);
   bool restrictAnimFPS = (gm.flag & GAME_RESTRICT_ANIM_UPDATES) != 0;
+  bool framePacing = (SYS_GetCommandLineInt(syshandle, "frame_pacing", 1) != 0);
+  bool adaptiveLogicFrames = (SYS_GetCommandLineInt(syshandle, "adaptive_logic_frames", 0) != 0);
+  const int maxDroppedRenders = SYS_GetCommandLineInt(syshandle, "max_dropped_renders", 0);
+  bool renderPipelining = (SYS_GetCommandLineInt(syshandle, "render_pipelining", 0) != 0);
+  m_inputRecordFile = SYS_GetCommandLineString(syshandle, "record_input", "");
+  const std::string replayInputFile = SYS_GetCommandLineString(syshandle, "replay_input", "");
+  // A replayed input is only reproducible if the logic frames don't depend on the clock.
+  bool fixedTimestep = (SYS_GetCommandLineInt(syshandle, "fixed_timestep", 0) != 0) ||
+                       !replayInputFile.empty();
+  const int frameLimit = SYS_GetCommandLineInt(syshandle, "frame_limit", 0);
+  const std::string frameTimingsFile = SYS_GetCommandLineString(syshandle, "frame_timings", "");
 
   // Setup python console keys used as shortcut.
   for (unsigned short i = 0; i < 4; ++i) {
@@ -155,7 +166,12 @@ void LA_Launcher::InitEngine()
       (frameRate ? KX_KetsjiEngine::SHOW_FRAMERATE : 0) |
       (restrictAnimFPS ? KX_KetsjiEngine::RESTRICT_ANIMATION : 0) |
       (properties ? KX_KetsjiEngine::SHOW_DEBUG_PROPERTIES : 0) |
-      (profile ? KX_KetsjiEngine::SHOW_PROFILE : 0));
+      (profile ? KX_KetsjiEngine::SHOW_PROFILE : 0) |
+      (framePacing ? KX_KetsjiEngine::FRAME_PACING : 0) |
+      (adaptiveLogicFrames ? KX_KetsjiEngine::ADAPTIVE_LOGIC_FRAMES : 0) |
+      (renderPipelining ? KX_KetsjiEngine::RENDER_PIPELINING : 0) |
+      (GetHeadless() ? KX_KetsjiEngine::HEADLESS : 0) |
+      (fixedTimestep ? KX_KetsjiEngine::FIXED_TIMESTEP : 0));
 
   m_rasterizer = new RAS_Rasterizer();
 
@@ -194,8 +210,16 @@ void LA_Launcher::InitEngine()
 
   // Create the inputdevices.
   m_inputDevice = new DEV_InputDevice();
-  m_eventConsumer = new DEV_EventConsumer(m_system, m_inputDevice, m_canvas);
-  m_system->addEventConsumer(m_eventConsumer);
+  if (!replayInputFile.empty()) {
+    m_inputDevice->StartReplay(replayInputFile);
+  }
+  else if (!m_inputRecordFile.empty()) {
+    m_inputDevice->StartRecord();
+  }
+  if (m_system) {
+    m_eventConsumer = new DEV_EventConsumer(m_system, m_inputDevice, m_canvas);
+    m_system->addEventConsumer(m_eventConsumer);
+  }
 
   // Create a ketsjisystem (only needed for timing and stuff).
   m_kxsystem = new LA_System();
@@ -228,12 +252,17 @@ void LA_Launcher::InitEngine()
   m_ketsjiEngine->SetTicRate(gm.ticrate);
   m_ketsjiEngine->SetMaxLogicFrame(gm.maxlogicstep);
   m_ketsjiEngine->SetMaxPhysicsFrame(gm.maxphystep);
+  m_ketsjiEngine->SetMaxDroppedRenders(maxDroppedRenders);
   m_ketsjiEngine->SetTimeScale(gm.timeScale);
+  m_ketsjiEngine->SetFrameLimit((frameLimit > 0) ? frameLimit : 0);
+  m_ketsjiEngine->SetFrameTimingsFile(frameTimingsFile);
 
   // Set the global settings (carried over if restart/load new files).
   m_ketsjiEngine->SetGlobalSettings(m_globalSettings);
 
-  m_rasterizer->Init(m_canvas);
+  if (!GetHeadless()) {
+    m_rasterizer->Init(m_canvas);
+  }
   InitCamera();
 
 #ifdef WITH_PYTHON
@@ -335,6 +364,9 @@ void LA_Launcher::ExitEngine()
     m_kxsystem = nullptr;
   }
   if (m_inputDevice) {
+    if (m_inputDevice->GetRecordMode() == DEV_InputDevice::RECORD_WRITE) {
+      m_inputDevice->WriteRecord(m_inputRecordFile);
+    }
     delete m_inputDevice;
     m_inputDevice = nullptr;
   }
@@ -389,12 +421,16 @@ void LA_Launcher::HandlePythonConsole()
 #    endif
 
   // Pop the console window for windows.
-  m_system->toggleConsole(1);
+  if (m_system) {
+    m_system->toggleConsole(1);
+  }
 
   createPythonConsole();
 
   // Hide the console window for windows.
-  m_system->toggleConsole(0);
+  if (m_system) {
+    m_system->toggleConsole(0);
+  }
 
   /* As we show the console, the release events of the shortcut keys can be not handled by the
    * engine. We simulate they them.
@@ -429,6 +465,11 @@ void LA_Launcher::RenderEngine()
   m_ketsjiEngine->Render();
 }
 
+bool LA_Launcher::GetHeadless()
+{
+  return false;
+}
+
 #ifdef WITH_PYTHON
 
 bool LA_Launcher::GetPythonMainLoopCode(std::string &pythonCode, std::string &pythonFileName)
@@ -473,8 +514,10 @@ bool LA_Launcher::EngineNextFrame()
     }
   }
 
-  m_system->processEvents(false);
-  m_system->dispatchEvents();
+  if (m_system) {
+    m_system->processEvents(false);
+    m_system->dispatchEvents();
+  }
 
   if (m_inputDevice->GetInput((SCA_IInputDevice::SCA_EnumInputs)m_ketsjiEngine->GetExitKey())
           .Find(SCA_InputEvent::ACTIVE) &&
@@ -503,6 +546,8 @@ void LA_Launcher::EngineMainLoop()
     KX_SetActiveScene(m_kxStartScene);
     PHY_SetActiveEnvironment(m_kxStartScene->GetPhysicsEnvironment());
     m_kxStartScene->SetIsPythonMainLoop(true);
+    // The script can access the physics between the frames.
+    m_ketsjiEngine->SetFlag(KX_KetsjiEngine::RENDER_PIPELINING, false);
 
     pynextframestate.state = this;
     pynextframestate.func = &PythonEngineNextFrame;
@@ -70,6 +70,8 @@ class LA_Launcher {
   /// The game engine's input device abstraction.
   DEV_InputDevice *m_inputDevice;
   DEV_EventConsumer *m_eventConsumer;
+  /// File the user input is recorded to, empty when not recording.
+  std::string m_inputRecordFile;
   /// The game engine's canvas abstraction.
   RAS_ICanvas *m_canvas;
   /// The rasterizer.
@@ -115,6 +117,8 @@ class LA_Launcher {
 
   /// Execute engine render, overrided to render background.
   virtual void RenderEngine();
+  /// Return true if the engine runs without window and GPU context.
+  virtual bool GetHeadless();
 
 #ifdef WITH_PYTHON
   /** Return true if the user use a valid python script for main loop and copy the python code
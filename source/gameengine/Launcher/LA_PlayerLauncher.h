@@ -53,6 +53,7 @@ class LA_PlayerLauncher : public LA_Launcher {
 
   virtual RAS_ICanvas *CreateCanvas();
   virtual bool GetUseAlwaysExpandFraming();
+  virtual bool GetHeadless();
   virtual void InitCamera();
   virtual void InitPython();
   virtual void ExitPython();
@@ -31,6 +31,9 @@
 #include "BKE_mesh_runtime.h"
 #include "BKE_object.h"
 #include "BKE_scene.h"
+#include "BLI_fileops.h"
+#include "BLI_path_util.h"
+#include "BLI_string.h"
 #include "DEG_depsgraph_query.h"
 #include "DNA_mesh_types.h"
 
@@ -40,6 +43,8 @@
 #include "BulletSoftBody/btSoftRigidDynamicsWorld.h"
 #include "LinearMath/btConvexHull.h"
 
+#include "CM_Message.h"
+#include "CM_Thread.h"
 #include "CcdPhysicsEnvironment.h"
 #include "KX_GameObject.h"
 #include "RAS_DisplayArray.h"
@@ -195,6 +200,8 @@ CcdPhysicsController::CcdPhysicsController(const CcdConstructionInfo &ci) : m_cc
   m_softbodyMappingDone = false;
   m_newClientInfo = 0;
   m_registerCount = 0;
+  m_registryIndex = -1;
+  m_activeListed = false;
   m_softBodyTransformInitialized = false;
   m_parentRoot = nullptr;
   // copy pointers locally to allow smart release
@@ -312,8 +319,14 @@ bool CcdPhysicsController::CreateSoftbody()
     return false;
   }
 
+  btSoftRigidDynamicsWorld *softWorld = m_cci.m_physicsEnv->GetSoftDynamicsWorld();
+  // Soft bodies are not supported by the multithreaded world.
+  if (!softWorld) {
+    return false;
+  }
+
   btSoftBody *psb = nullptr;
-  btSoftBodyWorldInfo &worldInfo = m_cci.m_physicsEnv->GetDynamicsWorld()->getWorldInfo();
+  btSoftBodyWorldInfo &worldInfo = softWorld->getWorldInfo();
 
   if (m_cci.m_collisionShape->getShapeType() ==
       CONVEX_HULL_SHAPE_PROXYTYPE) {  // Disabled in upbge 0.3
@@ -661,8 +674,17 @@ static void DeleteBulletShape(btCollisionShape *shape, bool free)
      * free the child of the unscaled shape (btTriangleMeshShape) here.
      */
     btTriangleMeshShape *meshShape = ((btScaledBvhTriangleMeshShape *)shape)->getChildShape();
-    if (meshShape)
-      delete meshShape;
+    if (meshShape) {
+      // The unscaled shape is shared with other meshes of same content.
+      CcdSharedMeshShape *sharedShape = static_cast<CcdSharedMeshShape *>(
+          meshShape->getUserPointer());
+      if (sharedShape) {
+        sharedShape->Release();
+      }
+      else {
+        delete meshShape;
+      }
+    }
   }
   if (free) {
     delete shape;
@@ -690,6 +712,39 @@ bool CcdPhysicsController::DeleteControllerShape()
   return false;
 }
 
+void CcdPhysicsController::SetMargin(float margin)
+{
+  if (!m_collisionShape) {
+    return;
+  }
+
+  if (m_collisionShape->getShapeType() == SCALED_TRIANGLE_MESH_SHAPE_PROXYTYPE) {
+    btScaledBvhTriangleMeshShape *scaledShape = (btScaledBvhTriangleMeshShape *)m_collisionShape;
+    btBvhTriangleMeshShape *childShape = scaledShape->getChildShape();
+    CcdSharedMeshShape *sharedShape = static_cast<CcdSharedMeshShape *>(
+        childShape->getUserPointer());
+    /* The unscaled shape is shared with the other meshes of same margin, use the shared
+     * shape of the new margin instead of modifying it. */
+    if (sharedShape) {
+      if (sharedShape->GetMargin() != margin) {
+        btScaledBvhTriangleMeshShape *newShape = new btScaledBvhTriangleMeshShape(
+            sharedShape->GetWithMargin(margin)->GetShape(), scaledShape->getLocalScaling());
+        newShape->setMargin(margin);
+        ReplaceControllerShape(newShape);
+        // refresh to remove the collision pairs using the previous shape
+        GetPhysicsEnvironment()->RefreshCcdPhysicsController(this);
+      }
+      else {
+        m_collisionShape->setMargin(margin);
+      }
+      return;
+    }
+    // if the shape use a unscaled shape we have also to set the correct margin in it
+    childShape->setMargin(margin);
+  }
+  m_collisionShape->setMargin(margin);
+}
+
 bool CcdPhysicsController::ReplaceControllerShape(btCollisionShape *newShape)
 {
   if (m_collisionShape)
@@ -705,7 +760,7 @@ bool CcdPhysicsController::ReplaceControllerShape(btCollisionShape *newShape)
 
   btSoftBody *softBody = GetSoftBody();
   if (softBody) {
-    btSoftRigidDynamicsWorld *world = GetPhysicsEnvironment()->GetDynamicsWorld();
+    btSoftRigidDynamicsWorld *world = GetPhysicsEnvironment()->GetSoftDynamicsWorld();
     // remove the old softBody
     world->removeSoftBody(softBody);
 
@@ -961,6 +1016,8 @@ void CcdPhysicsController::PostProcessReplica(class PHY_IMotionState *motionstat
   m_softBodyTransformInitialized = false;
   m_MotionState = motionstate;
   m_registerCount = 0;
+  m_registryIndex = -1;
+  m_activeListed = false;
   m_collisionShape = nullptr;
 
   // Clear all old constraints.
@@ -1173,7 +1230,7 @@ void CcdPhysicsController::RefreshCollisions()
   if (IsPhysicsSuspended())
     return;
 
-  btSoftRigidDynamicsWorld *dw = GetPhysicsEnvironment()->GetDynamicsWorld();
+  btDiscreteDynamicsWorld *dw = GetPhysicsEnvironment()->GetDynamicsWorld();
   btBroadphaseProxy *proxy = m_object->getBroadphaseHandle();
   btDispatcher *dispatcher = dw->getDispatcher();
   btOverlappingPairCache *pairCache = dw->getPairCache();
@@ -1278,6 +1335,14 @@ void CcdPhysicsController::SetTransform()
   const MT_Matrix3x3 rot = m_MotionState->GetWorldOrientation();
   ForceWorldTransform(ToBullet(rot), ToBullet(pos));
 
+  /* Static and sleeping objects are skipped by the motion state synchronization of the
+   * environment, apply here the scale inherited from the parents. */
+  const btVector3 scale = ToBullet(m_MotionState->GetWorldScaling());
+  btCollisionShape *shape = GetCollisionShape();
+  if (shape->getLocalScaling() != scale) {
+    shape->setLocalScaling(scale);
+  }
+
   if (!IsDynamic() && !GetConstructionInfo().m_bSensor && !GetCharacterController()) {
     btCollisionObject *object = GetRigidBody();
     object->setActivationState(ACTIVE_TAG);
@@ -1971,6 +2036,283 @@ void DefaultMotionState::CalculateWorldTransformations()
 {
 }
 
+std::map<uint64_t, CcdSharedMeshShape *> CcdSharedMeshShape::m_sharedShapeMap;
+std::string CcdSharedMeshShape::m_cacheDirectory;
+static CM_ThreadMutex sharedShapeMutex;
+
+/// Header of the BVH cache files, the file is rejected if anything differs.
+struct BvhCacheHeader {
+  char magic[4];
+  uint32_t version;
+  /// Bullet version and layout of the serialized BVH.
+  uint32_t bulletVersion;
+  uint32_t scalarSize;
+  uint32_t endianness;
+  uint32_t numVertices;
+  uint32_t numTriangles;
+  uint32_t bvhSize;
+  uint64_t contentHash;
+};
+
+static const char bvhCacheMagic[4] = {'B', 'G', 'E', 'B'};
+static const uint32_t bvhCacheVersion = 1;
+static const uint32_t bvhCacheEndianness = 0x01020304;
+
+/// FNV-1a hash of a memory block.
+static uint64_t hash_data(uint64_t hash, const void *data, size_t size)
+{
+  const unsigned char *bytes = (const unsigned char *)data;
+  for (size_t i = 0; i < size; ++i) {
+    hash = (hash ^ bytes[i]) * 1099511628211ULL;
+  }
+  return hash;
+}
+
+CcdSharedMeshShape::CcdSharedMeshShape(uint64_t hash,
+                                       uint64_t contentHash,
+                                       const btAlignedObjectArray<btScalar> &vertexArray,
+                                       const std::vector<int> &triFaceArray,
+                                       btScalar margin)
+    : m_refCount(1),
+      m_hash(hash),
+      m_contentHash(contentHash),
+      m_vertexArray(vertexArray),
+      m_triFaceArray(triFaceArray),
+      m_shape(nullptr),
+      m_bvhBuffer(nullptr)
+{
+  m_meshInterface = new btTriangleIndexVertexArray(m_triFaceArray.size() / 3,
+                                                   m_triFaceArray.data(),
+                                                   3 * sizeof(int),
+                                                   m_vertexArray.size() / 3,
+                                                   &m_vertexArray[0],
+                                                   3 * sizeof(btScalar));
+
+  if (!LoadBvh()) {
+    m_shape = new btBvhTriangleMeshShape(m_meshInterface, true, true);
+    SaveBvh();
+  }
+  m_shape->setMargin(margin);
+  // Tag the shape as shared to not delete it with the scaled shapes using it.
+  m_shape->setUserPointer(this);
+}
+
+CcdSharedMeshShape::~CcdSharedMeshShape()
+{
+  // The shape doesn't own a BVH loaded from the cache, it is freed with its buffer.
+  delete m_shape;
+  if (m_bvhBuffer) {
+    btAlignedFree(m_bvhBuffer);
+  }
+  delete m_meshInterface;
+}
+
+CcdSharedMeshShape *CcdSharedMeshShape::AddRef()
+{
+  sharedShapeMutex.Lock();
+  BLI_assert(m_refCount > 0);
+  ++m_refCount;
+  sharedShapeMutex.Unlock();
+
+  return this;
+}
+
+CcdSharedMeshShape *CcdSharedMeshShape::Release()
+{
+  sharedShapeMutex.Lock();
+  BLI_assert(m_refCount > 0);
+  const bool unused = (--m_refCount == 0);
+  // Remove the shape from the map before an other thread can find it.
+  if (unused) {
+    std::map<uint64_t, CcdSharedMeshShape *>::iterator mit = m_sharedShapeMap.find(m_hash);
+    if (mit != m_sharedShapeMap.end() && mit->second == this) {
+      m_sharedShapeMap.erase(mit);
+    }
+  }
+  sharedShapeMutex.Unlock();
+
+  if (unused) {
+    delete this;
+    return nullptr;
+  }
+  return this;
+}
+
+bool CcdSharedMeshShape::Matches(const btAlignedObjectArray<btScalar> &vertexArray,
+                                 const std::vector<int> &triFaceArray,
+                                 btScalar margin) const
+{
+  return (GetMargin() == margin && m_triFaceArray == triFaceArray &&
+          m_vertexArray.size() == vertexArray.size() &&
+          memcmp(&m_vertexArray[0], &vertexArray[0], vertexArray.size() * sizeof(btScalar)) ==
+              0);
+}
+
+CcdSharedMeshShape *CcdSharedMeshShape::Get(const btAlignedObjectArray<btScalar> &vertexArray,
+                                            const std::vector<int> &triFaceArray,
+                                            btScalar margin)
+{
+  const size_t vertexSize = vertexArray.size() * sizeof(btScalar);
+  const size_t indexSize = triFaceArray.size() * sizeof(int);
+
+  uint64_t contentHash = 14695981039346656037ULL;
+  contentHash = hash_data(contentHash, &vertexSize, sizeof(vertexSize));
+  contentHash = hash_data(contentHash, &indexSize, sizeof(indexSize));
+  contentHash = hash_data(contentHash, &vertexArray[0], vertexSize);
+  contentHash = hash_data(contentHash, triFaceArray.data(), indexSize);
+  // The unscaled shape margin is part of the AABB of all the shapes using it.
+  const uint64_t hash = hash_data(contentHash, &margin, sizeof(margin));
+
+  sharedShapeMutex.Lock();
+  std::map<uint64_t, CcdSharedMeshShape *>::const_iterator mit = m_sharedShapeMap.find(hash);
+  // Compare the content in case of hash collision.
+  if (mit != m_sharedShapeMap.end() && mit->second->Matches(vertexArray, triFaceArray, margin)) {
+    CcdSharedMeshShape *sharedShape = mit->second;
+    ++sharedShape->m_refCount;
+    sharedShapeMutex.Unlock();
+    return sharedShape;
+  }
+  sharedShapeMutex.Unlock();
+
+  // The BVH is built without the lock, an other thread can add the same shape meanwhile.
+  CcdSharedMeshShape *newShape = new CcdSharedMeshShape(
+      hash, contentHash, vertexArray, triFaceArray, margin);
+
+  sharedShapeMutex.Lock();
+  mit = m_sharedShapeMap.find(hash);
+  if (mit == m_sharedShapeMap.end()) {
+    m_sharedShapeMap[hash] = newShape;
+  }
+  else if (mit->second->Matches(vertexArray, triFaceArray, margin)) {
+    CcdSharedMeshShape *sharedShape = mit->second;
+    ++sharedShape->m_refCount;
+    sharedShapeMutex.Unlock();
+    delete newShape;
+    return sharedShape;
+  }
+  // Else unlikely collision, the shape is not shared.
+  sharedShapeMutex.Unlock();
+
+  return newShape;
+}
+
+CcdSharedMeshShape *CcdSharedMeshShape::GetWithMargin(btScalar margin) const
+{
+  return Get(m_vertexArray, m_triFaceArray, margin);
+}
+
+void CcdSharedMeshShape::SetCacheDirectory(const std::string &path)
+{
+  m_cacheDirectory = path;
+}
+
+btBvhTriangleMeshShape *CcdSharedMeshShape::GetShape() const
+{
+  return m_shape;
+}
+
+btScalar CcdSharedMeshShape::GetMargin() const
+{
+  return m_shape->getMargin();
+}
+
+std::string CcdSharedMeshShape::GetCacheFilePath() const
+{
+  char filename[32];
+  BLI_snprintf(filename, sizeof(filename), "%016llx.bvh", (unsigned long long)m_contentHash);
+
+  char filepath[FILE_MAX];
+  BLI_join_dirfile(filepath, sizeof(filepath), m_cacheDirectory.c_str(), filename);
+  return filepath;
+}
+
+bool CcdSharedMeshShape::LoadBvh()
+{
+  if (m_cacheDirectory.empty()) {
+    return false;
+  }
+
+  const std::string filepath = GetCacheFilePath();
+  FILE *file = BLI_fopen(filepath.c_str(), "rb");
+  if (!file) {
+    return false;
+  }
+
+  fseek(file, 0, SEEK_END);
+  const long size = ftell(file);
+  fseek(file, 0, SEEK_SET);
+
+  BvhCacheHeader header;
+  btOptimizedBvh *bvh = nullptr;
+  // The serialized BVH is only valid for the same Bullet build and the same triangles.
+  if (fread(&header, sizeof(header), 1, file) == 1 &&
+      memcmp(header.magic, bvhCacheMagic, sizeof(bvhCacheMagic)) == 0 &&
+      header.version == bvhCacheVersion && header.bulletVersion == (uint32_t)btGetVersion() &&
+      header.scalarSize == sizeof(btScalar) && header.endianness == bvhCacheEndianness &&
+      header.numVertices == (uint32_t)(m_vertexArray.size() / 3) &&
+      header.numTriangles == (uint32_t)(m_triFaceArray.size() / 3) &&
+      header.contentHash == m_contentHash && header.bvhSize > 0 &&
+      (long)(sizeof(header) + header.bvhSize) == size) {
+    // The BVH is deserialized in place and needs an aligned buffer.
+    m_bvhBuffer = btAlignedAlloc(header.bvhSize, 16);
+    if (fread(m_bvhBuffer, 1, header.bvhSize, file) == header.bvhSize) {
+      // Fails if the buffer size doesn't match the BVH header.
+      bvh = btOptimizedBvh::deSerializeInPlace(m_bvhBuffer, header.bvhSize, false);
+    }
+  }
+  fclose(file);
+
+  if (!bvh) {
+    CM_Warning("invalid BVH cache file \"" << filepath << "\", rebuilding it");
+    if (m_bvhBuffer) {
+      btAlignedFree(m_bvhBuffer);
+      m_bvhBuffer = nullptr;
+    }
+    return false;
+  }
+
+  m_shape = new btBvhTriangleMeshShape(m_meshInterface, true, false);
+  m_shape->setOptimizedBvh(bvh);
+
+  return true;
+}
+
+void CcdSharedMeshShape::SaveBvh() const
+{
+  const btOptimizedBvh *bvh = m_shape->getOptimizedBvh();
+  if (m_cacheDirectory.empty() || !bvh) {
+    return;
+  }
+
+  const unsigned int size = bvh->calculateSerializeBufferSize();
+  void *buffer = btAlignedAlloc(size, 16);
+  if (bvh->serializeInPlace(buffer, size, false)) {
+    BvhCacheHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, bvhCacheMagic, sizeof(bvhCacheMagic));
+    header.version = bvhCacheVersion;
+    header.bulletVersion = btGetVersion();
+    header.scalarSize = sizeof(btScalar);
+    header.endianness = bvhCacheEndianness;
+    header.numVertices = m_vertexArray.size() / 3;
+    header.numTriangles = m_triFaceArray.size() / 3;
+    header.bvhSize = size;
+    header.contentHash = m_contentHash;
+
+    const std::string filepath = GetCacheFilePath();
+    BLI_dir_create_recursive(m_cacheDirectory.c_str());
+    FILE *file = BLI_fopen(filepath.c_str(), "wb");
+    if (!file || fwrite(&header, sizeof(header), 1, file) != 1 ||
+        fwrite(buffer, 1, size, file) != size) {
+      CM_Warning("failed to write BVH cache file \"" << filepath << "\"");
+    }
+    if (file) {
+      fclose(file);
+    }
+  }
+  btAlignedFree(buffer);
+}
+
 // Shape constructor
 std::map<RAS_MeshObject *, CcdShapeConstructionInfo *> CcdShapeConstructionInfo::m_meshShapeMap;
 
@@ -2003,6 +2345,7 @@ void CcdShapeConstructionInfo::ProcessReplica()
   m_triangleIndexVertexArray = nullptr;
   m_forceReInstance = false;
   m_shapeProxy = nullptr;
+  m_sharedShape = nullptr;
   m_vertexArray.clear();
   m_polygonIndexArray.clear();
   m_triFaceArray.clear();
@@ -2754,6 +3097,12 @@ btCollisionShape *CcdShapeConstructionInfo::CreateBulletShape(btScalar margin,
       }
       else {
         if (!m_triangleIndexVertexArray || m_forceReInstance) {
+          // The mesh content changed, a new shared shape must be found.
+          if (m_sharedShape) {
+            m_sharedShape->Release();
+            m_sharedShape = nullptr;
+          }
+
           /// enable welding, only for the objects that need it (such as soft bodies)
           if (0.0f != m_weldingThreshold1) {
             btTriangleMesh *collisionMeshData = new btTriangleMesh(true, false);
@@ -2786,9 +3135,23 @@ btCollisionShape *CcdShapeConstructionInfo::CreateBulletShape(btScalar margin,
           m_forceReInstance = false;
         }
 
-        btBvhTriangleMeshShape *unscaledShape = new btBvhTriangleMeshShape(
-            m_triangleIndexVertexArray, true, useBvh);
-        unscaledShape->setMargin(margin);
+        btBvhTriangleMeshShape *unscaledShape;
+        /* The unscaled shape and its BVH are shared by all the meshes of same content,
+         * the welded meshes and the meshes without BVH are never shared. */
+        if (useBvh && m_weldingThreshold1 == 0.0f) {
+          if (!m_sharedShape) {
+            m_sharedShape = CcdSharedMeshShape::Get(m_vertexArray, m_triFaceArray, margin);
+          }
+          // Reference owned by the scaled shape.
+          CcdSharedMeshShape *sharedShape = (m_sharedShape->GetMargin() == margin) ?
+                                                m_sharedShape->AddRef() :
+                                                m_sharedShape->GetWithMargin(margin);
+          unscaledShape = sharedShape->GetShape();
+        }
+        else {
+          unscaledShape = new btBvhTriangleMeshShape(m_triangleIndexVertexArray, true, useBvh);
+          unscaledShape->setMargin(margin);
+        }
         collisionShape = new btScaledBvhTriangleMeshShape(unscaledShape,
                                                           btVector3(1.0f, 1.0f, 1.0f));
         collisionShape->setMargin(margin);
@@ -2835,6 +3198,9 @@ CcdShapeConstructionInfo::~CcdShapeConstructionInfo()
 
   if (m_triangleIndexVertexArray)
     delete m_triangleIndexVertexArray;
+  if (m_sharedShape) {
+    m_sharedShape->Release();
+  }
   m_vertexArray.clear();
   if (m_shapeType == PHY_SHAPE_MESH && m_meshObject != nullptr) {
     std::map<RAS_MeshObject *, CcdShapeConstructionInfo *>::iterator mit = m_meshShapeMap.find(
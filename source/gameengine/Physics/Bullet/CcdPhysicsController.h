@@ -23,6 +23,8 @@
 #pragma once
 
 #include <map>
+#include <stdint.h>
+#include <string>
 #include <vector>
 
 ///	PHY_IPhysicsController is the abstract simplified Interface to a physical object.
@@ -59,6 +61,68 @@ class btCollisionShape;
 #define CCD_BSB_COL_CL_SS 8  /* Cluster based soft vs soft */
 #define CCD_BSB_COL_VF_SS 16 /* Vertex/Face based soft vs soft */
 
+/** Triangle mesh and BVH shared by all the triangle mesh shapes of identical content and
+ * margin, whatever the scene, library or replica they come from. The entries are found by a
+ * hash of the vertices, triangles and margin and the baked BVH can be stored in a cache
+ * directory to skip its construction the next time the same content is loaded.
+ */
+/** Shapes are created by the asynchronous libraries conversion too, the shared shapes map and
+ * the reference counts are protected by a mutex.
+ */
+class CcdSharedMeshShape {
+ private:
+  static std::map<uint64_t, CcdSharedMeshShape *> m_sharedShapeMap;
+  static std::string m_cacheDirectory;
+
+  int m_refCount;
+  uint64_t m_hash;
+  /// Hash of the vertices and triangles only, names the BVH cache file.
+  uint64_t m_contentHash;
+  /// Own copy of the triangles referenced by the mesh interface.
+  btAlignedObjectArray<btScalar> m_vertexArray;
+  std::vector<int> m_triFaceArray;
+  btTriangleIndexVertexArray *m_meshInterface;
+  btBvhTriangleMeshShape *m_shape;
+  /// Buffer of a BVH loaded from the cache directory, the BVH lives in it.
+  void *m_bvhBuffer;
+
+  CcdSharedMeshShape(uint64_t hash,
+                     uint64_t contentHash,
+                     const btAlignedObjectArray<btScalar> &vertexArray,
+                     const std::vector<int> &triFaceArray,
+                     btScalar margin);
+
+  ~CcdSharedMeshShape();
+
+  /// Return true if the shape has the same triangles and margin, called with the mutex locked.
+  bool Matches(const btAlignedObjectArray<btScalar> &vertexArray,
+               const std::vector<int> &triFaceArray,
+               btScalar margin) const;
+
+  std::string GetCacheFilePath() const;
+  bool LoadBvh();
+  void SaveBvh() const;
+
+ public:
+  CcdSharedMeshShape *AddRef();
+  /// Decrease the reference count and free the shape at zero, return nullptr if freed.
+  CcdSharedMeshShape *Release();
+
+  /// Return a referenced shape for the triangles, built only if no identical content exists.
+  static CcdSharedMeshShape *Get(const btAlignedObjectArray<btScalar> &vertexArray,
+                                 const std::vector<int> &triFaceArray,
+                                 btScalar margin);
+  /// Return a referenced shape of the same triangles with a different margin.
+  CcdSharedMeshShape *GetWithMargin(btScalar margin) const;
+
+  /// Directory to load and save the baked BVH, disabled if empty.
+  static void SetCacheDirectory(const std::string &path);
+
+  /// Return the shared unscaled shape, it must only be used through a scaled shape.
+  btBvhTriangleMeshShape *GetShape() const;
+  btScalar GetMargin() const;
+};
+
 // Shape contructor
 // It contains all the information needed to create a simple bullet shape at runtime
 class CcdShapeConstructionInfo : public CM_RefCount<CcdShapeConstructionInfo> {
@@ -82,7 +146,8 @@ class CcdShapeConstructionInfo : public CM_RefCount<CcdShapeConstructionInfo> {
         m_triangleIndexVertexArray(nullptr),
         m_forceReInstance(false),
         m_weldingThreshold1(0.0f),
-        m_shapeProxy(nullptr)
+        m_shapeProxy(nullptr),
+        m_sharedShape(nullptr)
   {
     m_childTrans.setIdentity();
   }
@@ -202,6 +267,8 @@ class CcdShapeConstructionInfo : public CM_RefCount<CcdShapeConstructionInfo> {
   float m_weldingThreshold1;
   /// only used for PHY_SHAPE_PROXY, pointer to actual shape info
   CcdShapeConstructionInfo *m_shapeProxy;
+  /// Triangle mesh shape with BVH shared with all the meshes of identical content.
+  CcdSharedMeshShape *m_sharedShape;
 };
 
 struct CcdConstructionInfo {
@@ -576,6 +643,10 @@ class CcdPhysicsController : public PHY_IPhysicsController {
 
   void *m_newClientInfo;
   int m_registerCount;        // needed when multiple sensors use the same controller
+  /// Index of the controller in the environment registry, -1 when not added.
+  int m_registryIndex;
+  /// True while the controller is in the active list of the current physics step.
+  bool m_activeListed;
   CcdConstructionInfo m_cci;  // needed for replication
 
   CcdPhysicsController *m_parentRoot;
@@ -758,15 +829,7 @@ class CcdPhysicsController : public PHY_IPhysicsController {
     return m_cci.m_collisionFilterMask;
   }
 
-  virtual void SetMargin(float margin)
-  {
-    if (m_collisionShape) {
-      m_collisionShape->setMargin(margin);
-      // if the shape use a unscaled shape we have also to set the correct margin in it
-      if (m_collisionShape->getShapeType() == SCALED_TRIANGLE_MESH_SHAPE_PROXYTYPE)
-        ((btScaledBvhTriangleMeshShape *)m_collisionShape)->getChildShape()->setMargin(margin);
-    }
-  }
+  virtual void SetMargin(float margin);
   virtual float GetMargin() const
   {
     return (m_collisionShape) ? m_collisionShape->getMargin() : 0.0f;
@@ -22,13 +22,17 @@
 #include "CcdPhysicsEnvironment.h"
 
 #include "BKE_object.h"
+#include "BLI_task.h"
 #include "DNA_object_force_types.h"
 #include "DNA_scene_types.h"
 
+#include "BulletCollision/CollisionDispatch/btCollisionDispatcherMt.h"
 #include "BulletCollision/CollisionDispatch/btGhostObject.h"
 #include "BulletCollision/Gimpact/btGImpactCollisionAlgorithm.h"
 #include "BulletCollision/NarrowPhaseCollision/btRaycastCallback.h"
 #include "BulletDynamics/ConstraintSolver/btNNCGConstraintSolver.h"
+#include "BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolverMt.h"
+#include "BulletDynamics/Dynamics/btDiscreteDynamicsWorldMt.h"
 #include "BulletSoftBody/btSoftBodyRigidBodyCollisionConfiguration.h"
 #include "BulletSoftBody/btSoftRigidDynamicsWorld.h"
 
@@ -36,6 +40,7 @@
 #include "CM_List.h"
 #include "CcdConstraint.h"
 #include "CcdGraphicController.h"
+#include "CcdTaskScheduler.h"
 #include "KX_GameObject.h"
 #include "MT_MinMax.h"
 #include "PHY_IVehicle.h"
@@ -344,6 +349,25 @@ class WrapperVehicle : public PHY_IVehicle {
   }
 };
 
+/// Multithreaded world allowing to replace the solver of the large islands.
+class CcdDynamicsWorldMt : public btDiscreteDynamicsWorldMt {
+ public:
+  CcdDynamicsWorldMt(btDispatcher *dispatcher,
+                     btBroadphaseInterface *pairCache,
+                     btConstraintSolverPoolMt *solverPool,
+                     btConstraintSolver *constraintSolverMt,
+                     btCollisionConfiguration *collisionConfiguration)
+      : btDiscreteDynamicsWorldMt(
+            dispatcher, pairCache, solverPool, constraintSolverMt, collisionConfiguration)
+  {
+  }
+
+  void SetConstraintSolverMt(btConstraintSolver *solver)
+  {
+    m_constraintSolverMt = solver;
+  }
+};
+
 class CcdOverlapFilterCallBack : public btOverlapFilterCallback {
  private:
   class CcdPhysicsEnvironment *m_physEnv;
@@ -366,17 +390,25 @@ void CcdPhysicsEnvironment::SetDebugDrawer(btIDebugDraw *debugDrawer)
   m_debugDrawer = debugDrawer;
 }
 
-CcdPhysicsEnvironment::CcdPhysicsEnvironment(PHY_SolverType solverType, bool useDbvtCulling)
+CcdPhysicsEnvironment::CcdPhysicsEnvironment(PHY_SolverType solverType,
+                                             bool useDbvtCulling,
+                                             bool useMultithread,
+                                             int numThreads)
     : m_cullingCache(nullptr),
       m_cullingTree(nullptr),
       m_numIterations(10),
       m_numTimeSubSteps(1),
       m_solverType(PHY_SOLVER_NONE),
+      m_useMultithread(useMultithread),
+      m_numThreads(numThreads),
       m_deactivationTime(2.0f),
       m_linearDeactivationThreshold(0.8f),
       m_angularDeactivationThreshold(1.0f),
       m_contactBreakingThreshold(0.02f),
+      m_dynamicsWorld(nullptr),
+      m_softDynamicsWorld(nullptr),
       m_solver(nullptr),
+      m_solverMt(nullptr),
       m_ownPairCache(nullptr),
       m_filterCallback(nullptr),
       m_ghostPairCallback(nullptr),
@@ -388,7 +420,15 @@ CcdPhysicsEnvironment::CcdPhysicsEnvironment(PHY_SolverType solverType, bool use
 
   m_collisionConfiguration = new btSoftBodyRigidBodyCollisionConfiguration();
 
-  btCollisionDispatcher *dispatcher = new btCollisionDispatcher(m_collisionConfiguration);
+  if (m_useMultithread) {
+    // The task scheduler must be registered before creating any multithreaded Bullet object.
+    CcdTaskScheduler *scheduler = CcdTaskScheduler::Get();
+    scheduler->setNumThreads((m_numThreads > 0) ? m_numThreads : scheduler->getMaxNumThreads());
+  }
+
+  btCollisionDispatcher *dispatcher = m_useMultithread ?
+                                          new btCollisionDispatcherMt(m_collisionConfiguration) :
+                                          new btCollisionDispatcher(m_collisionConfiguration);
   btGImpactCollisionAlgorithm::registerAlgorithm(dispatcher);
   m_ownDispatcher = dispatcher;
 
@@ -405,10 +445,18 @@ CcdPhysicsEnvironment::CcdPhysicsEnvironment(PHY_SolverType solverType, bool use
   m_broadphase->getOverlappingPairCache()->setInternalGhostPairCallback(m_ghostPairCallback);
 
   SetSolverType(solverType);  // issues with quickstep and memory allocations
-  //	m_dynamicsWorld = new
-  // btDiscreteDynamicsWorld(dispatcher,m_broadphase,m_solver,m_collisionConfiguration);
-  m_dynamicsWorld = new btSoftRigidDynamicsWorld(
-      dispatcher, m_broadphase, m_solver, m_collisionConfiguration);
+  if (m_useMultithread) {
+    m_dynamicsWorld = new CcdDynamicsWorldMt(dispatcher,
+                                             m_broadphase,
+                                             (btConstraintSolverPoolMt *)m_solver,
+                                             m_solverMt,
+                                             m_collisionConfiguration);
+  }
+  else {
+    m_softDynamicsWorld = new btSoftRigidDynamicsWorld(
+        dispatcher, m_broadphase, m_solver, m_collisionConfiguration);
+    m_dynamicsWorld = m_softDynamicsWorld;
+  }
   m_dynamicsWorld->setInternalTickCallback(&CcdPhysicsEnvironment::StaticSimulationSubtickCallback,
                                            this);
   // m_dynamicsWorld->getSolverInfo().m_linearSlop = 0.01f;
@@ -422,10 +470,16 @@ CcdPhysicsEnvironment::CcdPhysicsEnvironment(PHY_SolverType solverType, bool use
 void CcdPhysicsEnvironment::AddCcdPhysicsController(CcdPhysicsController *ctrl)
 {
   // the controller is already added we do nothing
-  if (!m_controllers.insert(ctrl).second) {
+  if (ctrl->m_registryIndex != -1) {
     return;
   }
 
+  ctrl->m_registryIndex = m_controllers.size();
+  m_controllers.push_back(ctrl);
+  if (ctrl->GetSoftBody()) {
+    m_softBodyControllers.push_back(ctrl);
+  }
+
   btRigidBody *body = ctrl->GetRigidBody();
   btCollisionObject *obj = ctrl->GetCollisionObject();
 
@@ -455,7 +509,12 @@ void CcdPhysicsEnvironment::AddCcdPhysicsController(CcdPhysicsController *ctrl)
   else {
     if (ctrl->GetSoftBody()) {
       btSoftBody *softBody = ctrl->GetSoftBody();
-      m_dynamicsWorld->addSoftBody(softBody);
+      if (m_softDynamicsWorld) {
+        m_softDynamicsWorld->addSoftBody(softBody);
+      }
+      else {
+        CM_Warning("soft bodies are not supported by multithreaded physics, soft body ignored");
+      }
     }
     else {
       if (obj->getCollisionShape()) {
@@ -562,10 +621,26 @@ bool CcdPhysicsEnvironment::RemoveCcdPhysicsController(CcdPhysicsController *ctr
                                                        bool freeConstraints)
 {
   // if the physics controller is already removed we do nothing
-  if (!m_controllers.erase(ctrl)) {
+  const int index = ctrl->m_registryIndex;
+  if (index == -1 || index >= (int)m_controllers.size() || m_controllers[index] != ctrl) {
     return false;
   }
 
+  // Swap with the last controller to keep the registry contiguous.
+  CcdPhysicsController *last = m_controllers.back();
+  m_controllers[index] = last;
+  last->m_registryIndex = index;
+  m_controllers.pop_back();
+  ctrl->m_registryIndex = -1;
+
+  if (ctrl->GetSoftBody()) {
+    CM_ListRemoveIfFound(m_softBodyControllers, ctrl);
+  }
+  if (ctrl->m_activeListed) {
+    CM_ListRemoveIfFound(m_activeControllers, ctrl);
+    ctrl->m_activeListed = false;
+  }
+
   // also remove constraint
   btRigidBody *body = ctrl->GetRigidBody();
   if (body) {
@@ -588,7 +663,9 @@ bool CcdPhysicsEnvironment::RemoveCcdPhysicsController(CcdPhysicsController *ctr
   else {
     // if a softbody
     if (ctrl->GetSoftBody()) {
-      m_dynamicsWorld->removeSoftBody(ctrl->GetSoftBody());
+      if (m_softDynamicsWorld) {
+        m_softDynamicsWorld->removeSoftBody(ctrl->GetSoftBody());
+      }
     }
     else {
       m_dynamicsWorld->removeCollisionObject(ctrl->GetCollisionObject());
@@ -626,7 +703,9 @@ void CcdPhysicsEnvironment::UpdateCcdPhysicsController(CcdPhysicsController *ctr
       m_dynamicsWorld->addRigidBody(body, newCollisionGroup, newCollisionMask);
     }
     else if (softBody) {
-      m_dynamicsWorld->addSoftBody(softBody);
+      if (m_softDynamicsWorld) {
+        m_softDynamicsWorld->addSoftBody(softBody);
+      }
     }
     else {
       m_dynamicsWorld->addCollisionObject(obj, newCollisionGroup, newCollisionMask);
@@ -654,7 +733,8 @@ void CcdPhysicsEnvironment::RefreshCcdPhysicsController(CcdPhysicsController *ct
 
 bool CcdPhysicsEnvironment::IsActiveCcdPhysicsController(CcdPhysicsController *ctrl)
 {
-  return (m_controllers.find(ctrl) != m_controllers.end());
+  const int index = ctrl->m_registryIndex;
+  return (index != -1 && index < (int)m_controllers.size() && m_controllers[index] == ctrl);
 }
 
 void CcdPhysicsEnvironment::AddCcdGraphicController(CcdGraphicController *ctrl)
@@ -716,42 +796,78 @@ void CcdPhysicsEnvironment::StaticSimulationSubtickCallback(btDynamicsWorld *wor
 
 void CcdPhysicsEnvironment::SimulationSubtickCallback(btScalar timeStep)
 {
-  std::set<CcdPhysicsController *>::iterator it;
+  // Only the awake bodies can have their velocity clamped.
+  for (CcdPhysicsController *ctrl : m_activeControllers) {
+    ctrl->SimulationTick(timeStep);
+  }
+}
+
+void CcdPhysicsEnvironment::GatherActiveControllers()
+{
+  const btAlignedObjectArray<btRigidBody *> &bodies = m_dynamicsWorld->getNonStaticRigidBodies();
+  for (int i = 0, size = bodies.size(); i < size; ++i) {
+    btRigidBody *body = bodies[i];
+    if (!body->isActive() || body->isStaticObject()) {
+      continue;
+    }
 
-  for (it = m_controllers.begin(); it != m_controllers.end(); it++) {
-    (*it)->SimulationTick(timeStep);
+    CcdPhysicsController *ctrl = static_cast<CcdPhysicsController *>(body->getUserPointer());
+    if (ctrl && !ctrl->m_activeListed && ctrl->m_registryIndex != -1) {
+      ctrl->m_activeListed = true;
+      m_activeControllers.push_back(ctrl);
+    }
+  }
+}
+
+void CcdPhysicsEnvironment::ClearActiveControllers()
+{
+  for (CcdPhysicsController *ctrl : m_activeControllers) {
+    ctrl->m_activeListed = false;
+  }
+  m_activeControllers.clear();
+}
+
+void CcdPhysicsEnvironment::SynchronizeActiveMotionStates(float timeStep)
+{
+  for (CcdPhysicsController *ctrl : m_activeControllers) {
+    ctrl->SynchronizeMotionStates(timeStep);
+  }
+  for (CcdPhysicsController *ctrl : m_softBodyControllers) {
+    ctrl->SynchronizeMotionStates(timeStep);
   }
 }
 
 bool CcdPhysicsEnvironment::ProceedDeltaTime(double curTime, float timeStep, float interval)
 {
-  std::set<CcdPhysicsController *>::iterator it;
   int i;
 
   // Update Bullet global variables.
   gDeactivationTime = m_deactivationTime;
   gContactBreakingThreshold = m_contactBreakingThreshold;
 
-  for (it = m_controllers.begin(); it != m_controllers.end(); it++) {
-    (*it)->SynchronizeMotionStates(timeStep);
+  if (m_useMultithread) {
+    // The task scheduler is shared by all the scenes, restore the thread count of this scene.
+    CcdTaskScheduler *scheduler = CcdTaskScheduler::Get();
+    scheduler->setNumThreads((m_numThreads > 0) ? m_numThreads : scheduler->getMaxNumThreads());
   }
 
+  GatherActiveControllers();
+  SynchronizeActiveMotionStates(timeStep);
+
   float subStep = timeStep / float(m_numTimeSubSteps);
   i = m_dynamicsWorld->stepSimulation(
       interval, 25, subStep);  // perform always a full simulation step
   // uncomment next line to see where Bullet spend its time (printf in console)
   // CProfileManager::dumpAll();
 
-  ProcessFhSprings(curTime, i * subStep);
+  /* Add the bodies woken up during the step, the bodies which fell asleep at its end are kept
+   * to write their last transform. */
+  GatherActiveControllers();
 
-  for (it = m_controllers.begin(); it != m_controllers.end(); it++) {
-    (*it)->SynchronizeMotionStates(timeStep);
-  }
+  ProcessFhSprings(curTime, i * subStep);
 
-  // for (it=m_controllers.begin(); it!=m_controllers.end(); it++)
-  //{
-  //	(*it)->SynchronizeMotionStates(timeStep);
-  //}
+  SynchronizeActiveMotionStates(timeStep);
+  ClearActiveControllers();
 
   for (i = 0; i < m_wrapperVehicles.size(); i++) {
     WrapperVehicle *veh = m_wrapperVehicles[i];
@@ -765,10 +881,8 @@ bool CcdPhysicsEnvironment::ProceedDeltaTime(double curTime, float timeStep, flo
 
 void CcdPhysicsEnvironment::UpdateSoftBodies()
 {
-  std::set<CcdPhysicsController *>::iterator it;
-
-  for (it = m_controllers.begin(); it != m_controllers.end(); it++) {
-    (*it)->UpdateSoftBody();
+  for (CcdPhysicsController *ctrl : m_softBodyControllers) {
+    ctrl->UpdateSoftBody();
   }
 }
 
@@ -802,12 +916,10 @@ class ClosestRayResultCallbackNotMe : public btCollisionWorld::ClosestRayResultC
 
 void CcdPhysicsEnvironment::ProcessFhSprings(double curTime, float interval)
 {
-  std::set<CcdPhysicsController *>::iterator it;
-
   const float step = interval * KX_GetActiveEngine()->GetTicRate();
 
-  for (it = m_controllers.begin(); it != m_controllers.end(); it++) {
-    CcdPhysicsController *ctrl = (*it);
+  // Sleeping bodies are at rest on their spring, only the awake ones are processed.
+  for (CcdPhysicsController *ctrl : m_activeControllers) {
     btRigidBody *body = ctrl->GetRigidBody();
 
     if (body && (ctrl->GetConstructionInfo().m_do_fh || ctrl->GetConstructionInfo().m_do_rot_fh)) {
@@ -968,12 +1080,11 @@ void CcdPhysicsEnvironment::SetDeactivationAngularTreshold(float angTresh)
   m_angularDeactivationThreshold = angTresh;
 
   // Update from all controllers.
-  for (std::set<CcdPhysicsController *>::iterator it = m_controllers.begin();
-       it != m_controllers.end();
-       it++) {
-    if ((*it)->GetRigidBody())
-      (*it)->GetRigidBody()->setSleepingThresholds(m_linearDeactivationThreshold,
-                                                   m_angularDeactivationThreshold);
+  for (CcdPhysicsController *ctrl : m_controllers) {
+    if (ctrl->GetRigidBody()) {
+      ctrl->GetRigidBody()->setSleepingThresholds(m_linearDeactivationThreshold,
+                                                  m_angularDeactivationThreshold);
+    }
   }
 }
 
@@ -1010,30 +1121,73 @@ void CcdPhysicsEnvironment::SetSolverDamping(float damping)
   m_dynamicsWorld->getSolverInfo().m_damping = damping;
 }
 
-void CcdPhysicsEnvironment::SetSolverType(PHY_SolverType solverType)
+btConstraintSolver *CcdPhysicsEnvironment::CreateConstraintSolver(PHY_SolverType solverType)
 {
-
-  if (m_solverType == solverType) {
-    return;
-  }
-
   switch (solverType) {
     case PHY_SOLVER_SEQUENTIAL: {
-      m_solver = new btSequentialImpulseConstraintSolver();
-      break;
+      return new btSequentialImpulseConstraintSolver();
     }
-
     case PHY_SOLVER_NNCG: {
-      m_solver = new btNNCGConstraintSolver();
-      break;
+      return new btNNCGConstraintSolver();
     }
     default: {
       BLI_assert(false);
     }
   };
+
+  return nullptr;
+}
+
+void CcdPhysicsEnvironment::SetSolverType(PHY_SolverType solverType)
+{
+
+  if (m_solverType == solverType) {
+    return;
+  }
+
+  btConstraintSolver *solver;
+  btConstraintSolver *solverMt = nullptr;
+  if (m_useMultithread) {
+    /* The pool must own at least one solver per thread index to never spin
+     * waiting for a solver to be released. */
+    const int numSolvers = CcdTaskScheduler::Get()->getMaxNumThreads();
+    btConstraintSolver *solvers[BT_MAX_THREAD_COUNT];
+    for (int i = 0; i < numSolvers; ++i) {
+      solvers[i] = CreateConstraintSolver(solverType);
+    }
+    solver = new btConstraintSolverPoolMt(solvers, numSolvers);
+    // Large islands are split in batches solved in parallel, only for the sequential solver.
+    if (solverType == PHY_SOLVER_SEQUENTIAL) {
+      solverMt = new btSequentialImpulseConstraintSolverMt();
+    }
+  }
+  else {
+    solver = CreateConstraintSolver(solverType);
+  }
+
+  // When the solver type is changed at runtime the world must release the previous solvers.
+  if (m_dynamicsWorld) {
+    m_dynamicsWorld->setConstraintSolver(solver);
+    if (m_useMultithread) {
+      static_cast<CcdDynamicsWorldMt *>(m_dynamicsWorld)->SetConstraintSolverMt(solverMt);
+    }
+  }
+
+  delete m_solver;
+  delete m_solverMt;
+  m_solver = solver;
+  m_solverMt = solverMt;
   m_solverType = solverType;
 }
 
+int CcdPhysicsEnvironment::GetNumThreads() const
+{
+  if (!m_useMultithread) {
+    return 1;
+  }
+  return CcdTaskScheduler::Get()->GetNumWorkers();
+}
+
 void CcdPhysicsEnvironment::GetGravity(MT_Vector3 &grav)
 {
   const btVector3 &gravity = m_dynamicsWorld->getGravity();
@@ -1046,7 +1200,9 @@ void CcdPhysicsEnvironment::SetGravity(float x, float y, float z)
 {
   m_gravity = btVector3(x, y, z);
   m_dynamicsWorld->setGravity(m_gravity);
-  m_dynamicsWorld->getWorldInfo().m_gravity.setValue(x, y, z);
+  if (m_softDynamicsWorld) {
+    m_softDynamicsWorld->getWorldInfo().m_gravity.setValue(x, y, z);
+  }
 }
 
 static int gConstraintUid = 1;
@@ -1073,6 +1229,22 @@ void CcdPhysicsEnvironment::RemoveConstraintById(int constraintId, bool free)
   }
 }
 
+static bool ray_filter_needs_collision(PHY_IRayCastFilterCallback &phyRayFilter,
+                                       btBroadphaseProxy *proxy0,
+                                       short int collisionFilterGroup,
+                                       short int collisionFilterMask)
+{
+  if (!(proxy0->m_collisionFilterGroup & collisionFilterMask))
+    return false;
+  if (!(collisionFilterGroup & proxy0->m_collisionFilterMask))
+    return false;
+  btCollisionObject *object = (btCollisionObject *)proxy0->m_clientObject;
+  CcdPhysicsController *phyCtrl = static_cast<CcdPhysicsController *>(object->getUserPointer());
+  if (phyCtrl == phyRayFilter.m_ignoreController)
+    return false;
+  return phyRayFilter.needBroadphaseRayCast(phyCtrl);
+}
+
 struct FilterClosestRayResultCallback : public btCollisionWorld::ClosestRayResultCallback {
   PHY_IRayCastFilterCallback &m_phyRayFilter;
   const btCollisionShape *m_hitTriangleShape;
@@ -1094,15 +1266,8 @@ struct FilterClosestRayResultCallback : public btCollisionWorld::ClosestRayResul
 
   virtual bool needsCollision(btBroadphaseProxy *proxy0) const
   {
-    if (!(proxy0->m_collisionFilterGroup & m_collisionFilterMask))
-      return false;
-    if (!(m_collisionFilterGroup & proxy0->m_collisionFilterMask))
-      return false;
-    btCollisionObject *object = (btCollisionObject *)proxy0->m_clientObject;
-    CcdPhysicsController *phyCtrl = static_cast<CcdPhysicsController *>(object->getUserPointer());
-    if (phyCtrl == m_phyRayFilter.m_ignoreController)
-      return false;
-    return m_phyRayFilter.needBroadphaseRayCast(phyCtrl);
+    return ray_filter_needs_collision(
+        m_phyRayFilter, proxy0, m_collisionFilterGroup, m_collisionFilterMask);
   }
 
   virtual btScalar addSingleResult(btCollisionWorld::LocalRayResult &rayResult,
@@ -1123,6 +1288,28 @@ struct FilterClosestRayResultCallback : public btCollisionWorld::ClosestRayResul
   }
 };
 
+struct FilterClosestConvexResultCallback : public btCollisionWorld::ClosestConvexResultCallback {
+  PHY_IRayCastFilterCallback &m_phyRayFilter;
+
+  FilterClosestConvexResultCallback(PHY_IRayCastFilterCallback &phyRayFilter,
+                                    const btVector3 &rayFrom,
+                                    const btVector3 &rayTo)
+      : btCollisionWorld::ClosestConvexResultCallback(rayFrom, rayTo),
+        m_phyRayFilter(phyRayFilter)
+  {
+  }
+
+  virtual ~FilterClosestConvexResultCallback()
+  {
+  }
+
+  virtual bool needsCollision(btBroadphaseProxy *proxy0) const
+  {
+    return ray_filter_needs_collision(
+        m_phyRayFilter, proxy0, m_collisionFilterGroup, m_collisionFilterMask);
+  }
+};
+
 static bool GetHitTriangle(btCollisionShape *shape,
                            CcdShapeConstructionInfo *shapeInfo,
                            int hitTriangleIndex,
@@ -1326,6 +1513,104 @@ PHY_IPhysicsController *CcdPhysicsEnvironment::RayTest(PHY_IRayCastFilterCallbac
   return result.m_controller;
 }
 
+struct RayTestBatchData {
+  btCollisionWorld *world;
+  PHY_IRayCastFilterCallback *filterCallback;
+  const MT_Vector3 *fromPoints;
+  const MT_Vector3 *toPoints;
+  /// Shape swept along the rays, nullptr to cast rays.
+  btConvexShape *shape;
+  PHY_RayCastBatchResult *results;
+};
+
+static void ray_test_batch_func(void *__restrict userdata,
+                                const int i,
+                                const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  RayTestBatchData *data = static_cast<RayTestBatchData *>(userdata);
+  const btVector3 rayFrom = ToBullet(data->fromPoints[i]);
+  const btVector3 rayTo = ToBullet(data->toPoints[i]);
+  PHY_RayCastBatchResult &result = data->results[i];
+
+  const btCollisionObject *hitObject;
+  btVector3 hitPoint;
+  btVector3 hitNormal;
+  btScalar hitFraction;
+
+  if (data->shape) {
+    FilterClosestConvexResultCallback sweepCallback(*data->filterCallback, rayFrom, rayTo);
+    // don't collision with sensor object
+    sweepCallback.m_collisionFilterMask = CcdConstructionInfo::AllFilter ^
+                                          CcdConstructionInfo::SensorFilter;
+
+    const btTransform fromTrans(btMatrix3x3::getIdentity(), rayFrom);
+    const btTransform toTrans(btMatrix3x3::getIdentity(), rayTo);
+    data->world->convexSweepTest(data->shape, fromTrans, toTrans, sweepCallback);
+
+    hitObject = sweepCallback.m_hitCollisionObject;
+    hitPoint = sweepCallback.m_hitPointWorld;
+    hitNormal = sweepCallback.m_hitNormalWorld;
+    hitFraction = sweepCallback.m_closestHitFraction;
+  }
+  else {
+    FilterClosestRayResultCallback rayCallback(*data->filterCallback, rayFrom, rayTo);
+    // don't collision with sensor object
+    rayCallback.m_collisionFilterMask = CcdConstructionInfo::AllFilter ^
+                                        CcdConstructionInfo::SensorFilter;
+    // use faster (less accurate) ray callback, works better with 0 collision margins
+    rayCallback.m_flags |= btTriangleRaycastCallback::kF_UseSubSimplexConvexCastRaytest;
+    data->world->rayTest(rayFrom, rayTo, rayCallback);
+
+    hitObject = rayCallback.m_collisionObject;
+    hitPoint = rayCallback.m_hitPointWorld;
+    hitNormal = rayCallback.m_hitNormalWorld;
+    hitFraction = rayCallback.m_closestHitFraction;
+  }
+
+  if (!hitObject) {
+    result.m_controller = nullptr;
+    return;
+  }
+
+  if (hitNormal.length2() > (SIMD_EPSILON * SIMD_EPSILON)) {
+    hitNormal.normalize();
+  }
+  else {
+    hitNormal.setValue(1.0f, 0.0f, 0.0f);
+  }
+
+  result.m_controller = static_cast<CcdPhysicsController *>(hitObject->getUserPointer());
+  result.m_hitPoint = ToMoto(hitPoint);
+  result.m_hitNormal = ToMoto(hitNormal);
+  result.m_hitFraction = hitFraction;
+}
+
+void CcdPhysicsEnvironment::RayTestBatch(PHY_IRayCastFilterCallback &filterCallback,
+                                         const MT_Vector3 *fromPoints,
+                                         const MT_Vector3 *toPoints,
+                                         unsigned int numRays,
+                                         float radius,
+                                         PHY_RayCastBatchResult *results)
+{
+  /* The broadphase and narrowphase queries only read the world, the rays are independent and
+   * share the sphere shape when sweeping. */
+  btSphereShape sphere(radius);
+
+  RayTestBatchData data;
+  data.world = m_dynamicsWorld;
+  data.filterCallback = &filterCallback;
+  data.fromPoints = fromPoints;
+  data.toPoints = toPoints;
+  data.shape = (radius > 0.0f) ? &sphere : nullptr;
+  data.results = results;
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 64;
+
+  BLI_task_parallel_range(0, numRays, &data, ray_test_batch_func, &settings);
+}
+
 // Handles occlusion culling.
 // The implementation is based on the CDTestFramework
 struct OcclusionBuffer {
@@ -1980,11 +2265,8 @@ void CcdPhysicsEnvironment::MergeEnvironment(PHY_IPhysicsEnvironment *other_env)
     return;
   }
 
-  std::set<CcdPhysicsController *>::iterator it;
-
-  while (other->m_controllers.begin() != other->m_controllers.end()) {
-    it = other->m_controllers.begin();
-    CcdPhysicsController *ctrl = (*it);
+  while (!other->m_controllers.empty()) {
+    CcdPhysicsController *ctrl = other->m_controllers.back();
 
     other->RemoveCcdPhysicsController(ctrl, true);
     this->AddCcdPhysicsController(ctrl);
@@ -2011,6 +2293,9 @@ CcdPhysicsEnvironment::~CcdPhysicsEnvironment()
   if (nullptr != m_solver)
     delete m_solver;
 
+  if (nullptr != m_solverMt)
+    delete m_solverMt;
+
   if (nullptr != m_debugDrawer)
     delete m_debugDrawer;
 
@@ -2699,6 +2984,12 @@ void CcdPhysicsEnvironment::ExportFile(const std::string &filename)
   }
 }
 
+void CcdPhysicsEnvironment::SetShapeCacheDirectory(const std::string &path)
+{
+  // The shared shapes are common to all the scenes.
+  CcdSharedMeshShape::SetCacheDirectory(path);
+}
+
 struct BlenderDebugDraw : public btIDebugDraw {
   BlenderDebugDraw() : m_debugMode(0)
   {
@@ -2750,7 +3041,10 @@ CcdPhysicsEnvironment *CcdPhysicsEnvironment::Create(Scene *blenderscene, bool v
       PHY_SOLVER_NNCG,        // GAME_SOLVER_NNGC
   };
   CcdPhysicsEnvironment *ccdPhysEnv = new CcdPhysicsEnvironment(
-      solverTypeTable[blenderscene->gm.solverType], false);
+      solverTypeTable[blenderscene->gm.solverType],
+      false,
+      (blenderscene->gm.flag & GAME_USE_PHYSICS_MULTITHREAD) != 0,
+      blenderscene->gm.physicsThreads);
   ccdPhysEnv->SetDebugDrawer(new BlenderDebugDraw());
   ccdPhysEnv->SetDeactivationLinearTreshold(blenderscene->gm.lineardeactthreshold);
   ccdPhysEnv->SetDeactivationAngularTreshold(blenderscene->gm.angulardeactthreshold);
@@ -2823,6 +3117,15 @@ void CcdPhysicsEnvironment::ConvertObject(BL_BlenderSceneConverter *converter,
     isbulletsoftbody = false;
   }
 
+  // The multithreaded world doesn't support soft bodies, fallback to a rigid body.
+  if (isbulletsoftbody && !m_softDynamicsWorld) {
+    CM_Warning("object \"" << gameobj->GetName()
+                           << "\" soft body is not supported by multithreaded physics, "
+                              "converted as rigid body");
+    isbulletsoftbody = false;
+    isbulletrigidbody = true;
+  }
+
   if (!isbulletdyna) {
     ci.m_collisionFlags |= btCollisionObject::CF_STATIC_OBJECT;
   }
@@ -47,6 +47,8 @@ struct btDbvtBroadphase;
 class btOverlappingPairCache;
 class btIDebugDraw;
 class btDynamicsWorld;
+class btDiscreteDynamicsWorld;
+class btSoftRigidDynamicsWorld;
 class PHY_IVehicle;
 class CcdGraphicController;
 class CcdOverlapFilterCallBack;
@@ -89,6 +91,11 @@ class CcdPhysicsEnvironment : public PHY_IPhysicsEnvironment {
 
   PHY_SolverType m_solverType;
 
+  /// Use the multithreaded dynamics world and constraint solver pool.
+  bool m_useMultithread;
+  /// Number of threads used by the multithreaded world, 0 to use all available threads.
+  int m_numThreads;
+
   float m_deactivationTime;
   float m_linearDeactivationThreshold;
   float m_angularDeactivationThreshold;
@@ -96,8 +103,20 @@ class CcdPhysicsEnvironment : public PHY_IPhysicsEnvironment {
 
   void ProcessFhSprings(double curTime, float timeStep);
 
+  /** Append to the active list the controllers of the awake non static rigid bodies,
+   * read from the contiguous array of the Bullet world.
+   */
+  void GatherActiveControllers();
+  /// Clear the active list at the end of a physics step.
+  void ClearActiveControllers();
+  /// Synchronize the motion states of the active controllers and soft bodies.
+  void SynchronizeActiveMotionStates(float timeStep);
+
  public:
-  CcdPhysicsEnvironment(PHY_SolverType solverType, bool useDbvtCulling);
+  CcdPhysicsEnvironment(PHY_SolverType solverType,
+                        bool useDbvtCulling,
+                        bool useMultithread,
+                        int numThreads);
 
   virtual ~CcdPhysicsEnvironment();
 
@@ -202,6 +221,12 @@ class CcdPhysicsEnvironment : public PHY_IPhysicsEnvironment {
                                           float toX,
                                           float toY,
                                           float toZ);
+  virtual void RayTestBatch(PHY_IRayCastFilterCallback &filterCallback,
+                            const MT_Vector3 *fromPoints,
+                            const MT_Vector3 *toPoints,
+                            unsigned int numRays,
+                            float radius,
+                            PHY_RayCastBatchResult *results);
   virtual bool CullingTest(PHY_CullingCallback callback,
                            void *userData,
                            const std::array<MT_Vector4, 6> &planes,
@@ -273,11 +298,25 @@ class CcdPhysicsEnvironment : public PHY_IPhysicsEnvironment {
 
   void SyncMotionStates(float timeStep);
 
-  class btSoftRigidDynamicsWorld *GetDynamicsWorld()
+  btDiscreteDynamicsWorld *GetDynamicsWorld()
   {
     return m_dynamicsWorld;
   }
 
+  /// Return the soft body world, nullptr when using the multithreaded world.
+  btSoftRigidDynamicsWorld *GetSoftDynamicsWorld()
+  {
+    return m_softDynamicsWorld;
+  }
+
+  bool GetUseMultithread() const
+  {
+    return m_useMultithread;
+  }
+
+  /// Return the number of threads the simulation is effectively allowed to use.
+  int GetNumThreads() const;
+
   class btConstraintSolver *GetConstraintSolver();
 
   void MergeEnvironment(PHY_IPhysicsEnvironment *other_env);
@@ -302,7 +341,14 @@ class CcdPhysicsEnvironment : public PHY_IPhysicsEnvironment {
                                       bool replicate_dupli);
 
  protected:
-  std::set<CcdPhysicsController *> m_controllers;
+  /// Contiguous registry of all the added controllers, see CcdPhysicsController::m_registryIndex.
+  std::vector<CcdPhysicsController *> m_controllers;
+  /** Controllers of the awake non static rigid bodies during a physics step,
+   * static and sleeping bodies are never synchronized.
+   */
+  std::vector<CcdPhysicsController *> m_activeControllers;
+  /// Soft body controllers, always synchronized.
+  std::vector<CcdPhysicsController *> m_softBodyControllers;
 
   PHY_ResponseCallback m_triggerCallbacks[PHY_NUM_RESPONSE];
   void *m_triggerCallbacksUserPtrs[PHY_NUM_RESPONSE];
@@ -316,9 +362,19 @@ class CcdPhysicsEnvironment : public PHY_IPhysicsEnvironment {
    * Ideally we would like to have access to this function from the btDynamicsWorld interface
    */
   // class btDynamicsWorld *m_dynamicsWorld;
-  class btSoftRigidDynamicsWorld *m_dynamicsWorld;
+  btDiscreteDynamicsWorld *m_dynamicsWorld;
+  /** The same world as m_dynamicsWorld when it supports soft bodies, else nullptr.
+   * The multithreaded world (btDiscreteDynamicsWorldMt) doesn't support soft bodies.
+   */
+  btSoftRigidDynamicsWorld *m_softDynamicsWorld;
 
+  /// Constraint solver or pool of solvers in multithreaded mode.
   class btConstraintSolver *m_solver;
+  /// Multithreaded solver used for large islands in multithreaded mode, can be nullptr.
+  class btConstraintSolver *m_solverMt;
+
+  /// Create a single threaded constraint solver of type solverType.
+  static btConstraintSolver *CreateConstraintSolver(PHY_SolverType solverType);
 
   class btOverlappingPairCache *m_ownPairCache;
 
@@ -329,6 +385,8 @@ class CcdPhysicsEnvironment : public PHY_IPhysicsEnvironment {
   class btDispatcher *m_ownDispatcher;
 
   virtual void ExportFile(const std::string &filename);
+
+  virtual void SetShapeCacheDirectory(const std::string &path);
 };
 
 class CcdCollData : public PHY_CollData {
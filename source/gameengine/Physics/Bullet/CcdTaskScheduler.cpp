@@ -0,0 +1,181 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file CcdTaskScheduler.cpp
+ *  \ingroup physbullet
+ */
+
+#include "CcdTaskScheduler.h"
+
+#include "BLI_task.h"
+#include "BLI_utildefines.h"
+
+#include "CM_Profiler.h"
+#include "MT_MinMax.h"
+
+struct CcdParallelForData {
+  const btIParallelForBody *body;
+  int begin;
+  int end;
+  int chunkSize;
+};
+
+struct CcdParallelSumData {
+  const btIParallelSumBody *body;
+  int begin;
+  int end;
+  int chunkSize;
+  btScalar sums[BT_MAX_THREAD_COUNT];
+};
+
+static void parallel_for_chunk_func(void *__restrict userdata,
+                                    const int chunk,
+                                    const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  CM_PROFILE_ZONE("PhysicsParallelFor");
+
+  const CcdParallelForData *data = (CcdParallelForData *)userdata;
+  const int begin = data->begin + chunk * data->chunkSize;
+  const int end = MT_min(begin + data->chunkSize, data->end);
+  data->body->forLoop(begin, end);
+}
+
+static void parallel_sum_chunk_func(void *__restrict userdata,
+                                    const int chunk,
+                                    const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  CM_PROFILE_ZONE("PhysicsParallelSum");
+
+  CcdParallelSumData *data = (CcdParallelSumData *)userdata;
+  const int begin = data->begin + chunk * data->chunkSize;
+  const int end = MT_min(begin + data->chunkSize, data->end);
+  data->sums[chunk] = data->body->sumLoop(begin, end);
+}
+
+/** Compute the number of chunks and their size to split a range in,
+ * the chunks are never smaller than the grain size and never more numerous
+ * than the allowed number of threads.
+ */
+static int compute_chunks(int numItems, int grainSize, int numThreads, int &r_chunkSize)
+{
+  const int grain = MT_max(grainSize, 1);
+  const int numChunks = MT_max(MT_min((numItems + grain - 1) / grain, numThreads), 1);
+  r_chunkSize = (numItems + numChunks - 1) / numChunks;
+  return numChunks;
+}
+
+CcdTaskScheduler::CcdTaskScheduler()
+    : btITaskScheduler("Blender"), m_numThreads(CcdTaskScheduler::getMaxNumThreads())
+{
+}
+
+CcdTaskScheduler::~CcdTaskScheduler()
+{
+}
+
+int CcdTaskScheduler::getMaxNumThreads() const
+{
+  // The calling thread takes part in the work too.
+  return MT_min(BLI_task_scheduler_num_threads() + 1, (int)BT_MAX_THREAD_COUNT);
+}
+
+int CcdTaskScheduler::getNumThreads() const
+{
+  return getMaxNumThreads();
+}
+
+void CcdTaskScheduler::setNumThreads(int numThreads)
+{
+  m_numThreads = MT_max(1, MT_min(numThreads, getMaxNumThreads()));
+}
+
+int CcdTaskScheduler::GetNumWorkers() const
+{
+  return m_numThreads;
+}
+
+void CcdTaskScheduler::parallelFor(int iBegin,
+                                   int iEnd,
+                                   int grainSize,
+                                   const btIParallelForBody &body)
+{
+  if (iEnd <= iBegin) {
+    return;
+  }
+
+  CcdParallelForData data;
+  data.body = &body;
+  data.begin = iBegin;
+  data.end = iEnd;
+  const int numChunks = compute_chunks(iEnd - iBegin, grainSize, m_numThreads, data.chunkSize);
+
+  if (numChunks == 1) {
+    body.forLoop(iBegin, iEnd);
+    return;
+  }
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1;
+
+  BLI_task_parallel_range(0, numChunks, &data, parallel_for_chunk_func, &settings);
+}
+
+btScalar CcdTaskScheduler::parallelSum(int iBegin,
+                                       int iEnd,
+                                       int grainSize,
+                                       const btIParallelSumBody &body)
+{
+  if (iEnd <= iBegin) {
+    return btScalar(0);
+  }
+
+  CcdParallelSumData data;
+  data.body = &body;
+  data.begin = iBegin;
+  data.end = iEnd;
+  const int numChunks = compute_chunks(iEnd - iBegin, grainSize, m_numThreads, data.chunkSize);
+
+  if (numChunks == 1) {
+    return body.sumLoop(iBegin, iEnd);
+  }
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1;
+
+  BLI_task_parallel_range(0, numChunks, &data, parallel_sum_chunk_func, &settings);
+
+  // Sum in chunk order to keep the result independent of the thread scheduling.
+  btScalar sum = btScalar(0);
+  for (int i = 0; i < numChunks; ++i) {
+    sum += data.sums[i];
+  }
+  return sum;
+}
+
+CcdTaskScheduler *CcdTaskScheduler::Get()
+{
+  static CcdTaskScheduler scheduler;
+  if (btGetTaskScheduler() != &scheduler) {
+    btSetTaskScheduler(&scheduler);
+  }
+  return &scheduler;
+}
@@ -0,0 +1,62 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file CcdTaskScheduler.h
+ *  \ingroup physbullet
+ */
+
+#pragma once
+
+#include "LinearMath/btThreads.h"
+
+/** Bullet task scheduler dispatching btParallelFor/btParallelSum work to the
+ * Blender task scheduler (BLI_task), used by the multithreaded dynamics world.
+ * Only one instance exists as Bullet uses a global task scheduler.
+ */
+class CcdTaskScheduler : public btITaskScheduler {
+ private:
+  /// Maximum number of chunks a parallel loop is split into.
+  int m_numThreads;
+
+  CcdTaskScheduler();
+
+ public:
+  virtual ~CcdTaskScheduler();
+
+  /** Return the maximum number of thread indices Bullet can encounter.
+   * Any worker of the Blender task scheduler can execute a chunk, the per thread
+   * arrays allocated by Bullet must then cover all of them.
+   */
+  virtual int getMaxNumThreads() const;
+  virtual int getNumThreads() const;
+  /// Limit the number of chunks running concurrently in a parallel loop.
+  virtual void setNumThreads(int numThreads);
+  /// Return the number of chunks running concurrently in a parallel loop.
+  int GetNumWorkers() const;
+
+  virtual void parallelFor(int iBegin, int iEnd, int grainSize, const btIParallelForBody &body);
+  virtual btScalar parallelSum(int iBegin,
+                               int iEnd,
+                               int grainSize,
+                               const btIParallelSumBody &body);
+
+  /// Return the unique scheduler, registering it to Bullet on first call.
+  static CcdTaskScheduler *Get();
+};
@@ -67,6 +67,16 @@ struct PHY_RayCastResult {
   MT_Vector2 m_hitUV;  // UV coordinates of hit point
 };
 
+/**
+ * Closest hit of one ray of a batched ray test, see PHY_IPhysicsEnvironment::RayTestBatch.
+ */
+struct PHY_RayCastBatchResult {
+  PHY_IPhysicsController *m_controller;  // nullptr if the ray hit nothing
+  MT_Vector3 m_hitPoint;
+  MT_Vector3 m_hitNormal;
+  float m_hitFraction;  // fraction of the ray length at the hit point
+};
+
 /**
  * This class replaces the ignoreController parameter of rayTest function.
  * It allows more sophisticated filtering on the physics controller before computing the ray
@@ -229,6 +239,16 @@ class PHY_IPhysicsEnvironment {
                                           float toX,
                                           float toY,
                                           float toZ) = 0;
+  /** Cast a batch of rays, or sweep a sphere along each ray when radius is greater than zero,
+   * and store the closest hit of the ray i in results[i]. The rays are processed in parallel,
+   * needBroadphaseRayCast of the filter callback must be thread safe and reportHit is not used.
+   */
+  virtual void RayTestBatch(PHY_IRayCastFilterCallback &filterCallback,
+                            const MT_Vector3 *fromPoints,
+                            const MT_Vector3 *toPoints,
+                            unsigned int numRays,
+                            float radius,
+                            PHY_RayCastBatchResult *results) = 0;
 
   // culling based on physical broad phase
   // the plane number must be set as follow: near, far, left, right, top, botton
@@ -257,6 +277,9 @@ class PHY_IPhysicsEnvironment {
 
   virtual void ExportFile(const std::string &filename){};
 
+  /// Set the directory where baked collision shapes are cached, disabled if empty.
+  virtual void SetShapeCacheDirectory(const std::string &path){};
+
   virtual void MergeEnvironment(PHY_IPhysicsEnvironment *other_env) = 0;
 
   virtual void ConvertObject(BL_BlenderSceneConverter *converter,
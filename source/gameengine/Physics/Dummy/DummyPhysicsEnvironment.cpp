@@ -122,3 +122,15 @@ PHY_IPhysicsController *DummyPhysicsEnvironment::RayTest(
   // collision detection / raytesting
   return nullptr;
 }
+
+void DummyPhysicsEnvironment::RayTestBatch(PHY_IRayCastFilterCallback &filterCallback,
+                                           const MT_Vector3 *fromPoints,
+                                           const MT_Vector3 *toPoints,
+                                           unsigned int numRays,
+                                           float radius,
+                                           PHY_RayCastBatchResult *results)
+{
+  for (unsigned int i = 0; i < numRays; ++i) {
+    results[i].m_controller = nullptr;
+  }
+}
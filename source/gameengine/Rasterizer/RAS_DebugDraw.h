@@ -152,4 +152,6 @@ class RAS_DebugDraw {
   void RenderText2D(const std::string &text, const MT_Vector2 &pos, const MT_Vector4 &color);
 
   void Flush(RAS_Rasterizer *rasty, RAS_ICanvas *canvas);
+  /// Discard the shapes without drawing them, used when nothing is rendered.
+  void Clear();
 };
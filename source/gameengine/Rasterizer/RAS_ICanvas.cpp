@@ -23,12 +23,14 @@
  */
 
 #include "RAS_ICanvas.h"
+#include "RAS_OpenGLPixelReadback.h"
 
 #include "BKE_image.h"
 #include "BLI_path_util.h"
 #include "BLI_string.h"
 #include "BLI_task.h"
 #include "DNA_scene_types.h"
+#include "GPU_glew.h"
 #include "IMB_imbuf.h"
 #include "IMB_imbuf_types.h"
 #include "MEM_guardedalloc.h"
@@ -53,13 +55,20 @@ struct ScreenshotTaskData {
  */
 void save_screenshot_thread_func(TaskPool *__restrict pool, void *taskdata, int threadid);
 
-RAS_ICanvas::RAS_ICanvas(RAS_Rasterizer *rasty) : m_rasterizer(rasty), m_samples(0)
+RAS_ICanvas::RAS_ICanvas(RAS_Rasterizer *rasty)
+    : m_rasterizer(rasty), m_screenshotReadback(nullptr), m_samples(0)
 {
   m_taskpool = BLI_task_pool_create(nullptr, TASK_PRIORITY_LOW);
 }
 
 RAS_ICanvas::~RAS_ICanvas()
 {
+  // Save the screenshots still read by the GPU.
+  while (!m_pendingScreenshots.empty()) {
+    SavePendingScreenshot(true);
+  }
+  delete m_screenshotReadback;
+
   if (m_taskpool) {
     BLI_task_pool_work_and_wait(m_taskpool);
     BLI_task_pool_free(m_taskpool);
@@ -109,13 +118,76 @@ const RAS_Rect &RAS_ICanvas::GetViewportArea() const
 
 void RAS_ICanvas::FlushScreenshots()
 {
+  // Save the screenshots of the previous frames already read without waiting.
+  while (!m_pendingScreenshots.empty() && SavePendingScreenshot(false)) {
+  }
+
+  if (m_screenshots.empty()) {
+    return;
+  }
+
+  /* The read of the pixels is queued in a pixel buffer and the screenshot is saved in a next
+   * frame once the GPU finished it, this avoids to stall the pipeline at every screenshot. */
+  if (!m_screenshotReadback) {
+    m_screenshotReadback = new RAS_OpenGLPixelReadback(3);
+  }
+
   for (const Screenshot &screenshot : m_screenshots) {
-    SaveScreeshot(screenshot);
+    // All the pixel buffers are used, wait for the oldest read.
+    if (m_pendingScreenshots.size() == m_screenshotReadback->GetNumBuffers()) {
+      SavePendingScreenshot(true);
+    }
+
+    if (m_screenshotReadback->Queue(screenshot.x,
+                                    screenshot.y,
+                                    screenshot.width,
+                                    screenshot.height,
+                                    GL_RGBA,
+                                    GL_UNSIGNED_BYTE,
+                                    sizeof(unsigned int))) {
+      m_pendingScreenshots.push_back(screenshot);
+    }
+    else {
+      SaveScreeshot(screenshot,
+                    m_rasterizer->MakeScreenshot(
+                        screenshot.x, screenshot.y, screenshot.width, screenshot.height));
+    }
   }
 
   m_screenshots.clear();
 }
 
+bool RAS_ICanvas::SavePendingScreenshot(bool wait)
+{
+  const Screenshot screenshot = m_pendingScreenshots.front();
+  const unsigned int numPending = m_screenshotReadback->GetNumPending();
+
+  // Dumprect must be allocated with malloc(), see save_screenshot_thread_func.
+  unsigned int *pixels = (unsigned int *)malloc(m_screenshotReadback->GetFetchSize());
+  if (!pixels) {
+    CM_Error("cannot allocate pixels array");
+    return false;
+  }
+
+  if (m_screenshotReadback->Fetch(pixels, wait)) {
+    m_pendingScreenshots.pop_front();
+    SaveScreeshot(screenshot, pixels);
+    return true;
+  }
+
+  free(pixels);
+
+  // The read failed and was released, drop the screenshot.
+  if (m_screenshotReadback->GetNumPending() != numPending) {
+    CM_Error("cannot read pixels of screenshot: " << screenshot.path);
+    m_pendingScreenshots.pop_front();
+    MEM_freeN(screenshot.format);
+    return true;
+  }
+
+  return false;
+}
+
 void RAS_ICanvas::AddScreenshot(
     const std::string &path, int x, int y, int width, int height, ImageFormatData *format)
 {
@@ -144,16 +216,14 @@ void save_screenshot_thread_func(TaskPool *__restrict UNUSED(pool),
 
   ibuf->rect = nullptr;
   IMB_freeImBuf(ibuf);
-  // Dumprect is allocated in RAS_OpenGLRasterizer::MakeScreenShot with malloc(), we must use
-  // free() then.
+  // Dumprect is allocated in RAS_OpenGLRasterizer::MakeScreenShot or
+  // RAS_ICanvas::SavePendingScreenshot with malloc(), we must use free() then.
   free(task->dumprect);
   MEM_freeN(task->im_format);
 }
 
-void RAS_ICanvas::SaveScreeshot(const Screenshot &screenshot)
+void RAS_ICanvas::SaveScreeshot(const Screenshot &screenshot, unsigned int *pixels)
 {
-  unsigned int *pixels = m_rasterizer->MakeScreenshot(
-      screenshot.x, screenshot.y, screenshot.width, screenshot.height);
   if (!pixels) {
     CM_Error("cannot allocate pixels array");
     return;
@@ -33,6 +33,9 @@
 
 #include "RAS_Rasterizer.h"
 
+#include <deque>
+
+class RAS_OpenGLPixelReadback;
 class RAS_Rect;
 
 struct ARegion;
@@ -138,6 +141,10 @@ class RAS_ICanvas {
   };
 
   std::vector<Screenshot> m_screenshots;
+  /// Screenshots read asynchronously and not yet saved, in order of their reads.
+  std::deque<Screenshot> m_pendingScreenshots;
+  /// Asynchronous read of the screenshots pixels.
+  RAS_OpenGLPixelReadback *m_screenshotReadback;
 
   int m_samples;
 
@@ -156,9 +163,16 @@ class RAS_ICanvas {
   void AddScreenshot(
       const std::string &path, int x, int y, int width, int height, ImageFormatData *format);
 
+  /** Save the oldest pending screenshot if its pixels are read.
+   * \param wait Wait for the end of the read.
+   * \return False if the read is not finished.
+   */
+  bool SavePendingScreenshot(bool wait);
+
   /**
    * Saves screenshot data to a file. The actual compression and disk I/O is performed in
    * a separate thread.
+   * \param pixels The screenshot pixels allocated with malloc(), freed after saving.
    */
-  void SaveScreeshot(const Screenshot &screenshot);
+  void SaveScreeshot(const Screenshot &screenshot, unsigned int *pixels);
 };
@@ -31,7 +31,12 @@
 
 #include "RAS_Vertex.h"
 
-class RAS_IDisplayArray {
+#include "CM_RefCount.h"
+
+/** The display array is owned by its mesh material and released with it,
+ * other users as python vertex buffers can keep a reference on it.
+ */
+class RAS_IDisplayArray : public CM_RefCount<RAS_IDisplayArray> {
  public:
   enum PrimitiveType {
     TRIANGLES,
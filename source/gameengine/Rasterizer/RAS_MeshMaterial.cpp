@@ -41,7 +41,7 @@ RAS_MeshMaterial::RAS_MeshMaterial(RAS_MeshObject *mesh,
 RAS_MeshMaterial::~RAS_MeshMaterial()
 {
   delete m_displayArrayBucket;
-  delete m_displayArray;
+  m_displayArray->Release();
 }
 
 unsigned int RAS_MeshMaterial::GetIndex() const
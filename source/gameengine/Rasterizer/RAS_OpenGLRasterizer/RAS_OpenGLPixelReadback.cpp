@@ -0,0 +1,147 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Rasterizer/RAS_OpenGLRasterizer/RAS_OpenGLPixelReadback.cpp
+ *  \ingroup bgerastogl
+ */
+
+#include "RAS_OpenGLPixelReadback.h"
+
+#include "GPU_glew.h"
+
+#include <cstring>
+
+RAS_OpenGLPixelReadback::RAS_OpenGLPixelReadback(unsigned int numBuffers)
+    : m_reads(numBuffers), m_first(0), m_numPending(0)
+{
+  for (Read &read : m_reads) {
+    glGenBuffers(1, &read.pbo);
+    read.size = 0;
+    read.fence = nullptr;
+  }
+}
+
+RAS_OpenGLPixelReadback::~RAS_OpenGLPixelReadback()
+{
+  Reset();
+  for (Read &read : m_reads) {
+    glDeleteBuffers(1, &read.pbo);
+  }
+}
+
+unsigned int RAS_OpenGLPixelReadback::GetNumBuffers() const
+{
+  return m_reads.size();
+}
+
+unsigned int RAS_OpenGLPixelReadback::GetNumPending() const
+{
+  return m_numPending;
+}
+
+bool RAS_OpenGLPixelReadback::Queue(int x,
+                                    int y,
+                                    int width,
+                                    int height,
+                                    unsigned int format,
+                                    unsigned int type,
+                                    unsigned int pixelSize)
+{
+  if (m_numPending == m_reads.size() || width <= 0 || height <= 0) {
+    return false;
+  }
+
+  // Compute the size written by glReadPixels, the rows are aligned except the last one.
+  int alignment;
+  glGetIntegerv(GL_PACK_ALIGNMENT, &alignment);
+  const unsigned int rowSize = width * pixelSize;
+  const unsigned int stride = ((rowSize + alignment - 1) / alignment) * alignment;
+  const unsigned int size = stride * (height - 1) + rowSize;
+
+  Read &read = m_reads[(m_first + m_numPending) % m_reads.size()];
+
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, read.pbo);
+  if (read.size < size) {
+    glBufferData(GL_PIXEL_PACK_BUFFER, size, nullptr, GL_STREAM_READ);
+  }
+  read.size = size;
+
+  // With a pixel pack buffer bound, the pointer is an offset in the buffer and the read is
+  // asynchronous.
+  glReadPixels(x, y, width, height, format, type, nullptr);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+  read.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  // Send the fence to the GPU, a wait without flush on an unsent fence would never end.
+  glFlush();
+
+  ++m_numPending;
+  return true;
+}
+
+bool RAS_OpenGLPixelReadback::Fetch(void *data, bool wait)
+{
+  if (m_numPending == 0) {
+    return false;
+  }
+
+  Read &read = m_reads[m_first];
+
+  const GLenum status = glClientWaitSync(read.fence, 0, wait ? GL_TIMEOUT_IGNORED : 0);
+  if (status == GL_TIMEOUT_EXPIRED) {
+    return false;
+  }
+
+  glDeleteSync(read.fence);
+  read.fence = nullptr;
+  m_first = (m_first + 1) % m_reads.size();
+  --m_numPending;
+
+  if (status == GL_WAIT_FAILED) {
+    return false;
+  }
+
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, read.pbo);
+  void *pixels = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, read.size, GL_MAP_READ_BIT);
+  if (pixels) {
+    memcpy(data, pixels, read.size);
+    glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+  }
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+  return (pixels != nullptr);
+}
+
+unsigned int RAS_OpenGLPixelReadback::GetFetchSize() const
+{
+  return (m_numPending > 0) ? m_reads[m_first].size : 0;
+}
+
+void RAS_OpenGLPixelReadback::Reset()
+{
+  for (Read &read : m_reads) {
+    if (read.fence) {
+      glDeleteSync(read.fence);
+      read.fence = nullptr;
+    }
+  }
+  m_first = 0;
+  m_numPending = 0;
+}
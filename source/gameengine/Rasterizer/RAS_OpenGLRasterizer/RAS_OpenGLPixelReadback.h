@@ -0,0 +1,79 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file RAS_OpenGLPixelReadback.h
+ *  \ingroup bgerastogl
+ */
+
+#pragma once
+
+#include <vector>
+
+struct __GLsync;
+
+/**
+ * Asynchronous read of frame buffer pixels through a ring of pixel buffer objects.
+ * glReadPixels into a pixel buffer returns without waiting for the GPU, a fence is
+ * inserted after it and the pixels are copied to client memory in a later frame once
+ * the fence is signaled, avoiding the pipeline stall of a synchronous read.
+ */
+class RAS_OpenGLPixelReadback {
+ private:
+  struct Read {
+    unsigned int pbo;
+    unsigned int size;
+    /// Fence of the read, nullptr if the pixel buffer is not used.
+    __GLsync *fence;
+  };
+
+  /// Ring of pixel buffers.
+  std::vector<Read> m_reads;
+  /// Index of the oldest pending read.
+  unsigned int m_first;
+  unsigned int m_numPending;
+
+ public:
+  RAS_OpenGLPixelReadback(unsigned int numBuffers);
+  ~RAS_OpenGLPixelReadback();
+
+  unsigned int GetNumBuffers() const;
+  unsigned int GetNumPending() const;
+
+  /** Queue the read of a rectangle of the bound frame buffer, the rows are packed with the
+   * current GL_PACK_ALIGNMENT as with a synchronous glReadPixels.
+   * \return False if all the pixel buffers are pending.
+   */
+  bool Queue(int x,
+             int y,
+             int width,
+             int height,
+             unsigned int format,
+             unsigned int type,
+             unsigned int pixelSize);
+  /** Copy the pixels of the oldest pending read into data and release its pixel buffer.
+   * \param wait Wait for the GPU if the read is not finished.
+   * \return False if there is no pending read or if it is not finished and wait is false.
+   */
+  bool Fetch(void *data, bool wait);
+  /// Size in bytes of the oldest pending read.
+  unsigned int GetFetchSize() const;
+  /// Drop all the pending reads.
+  void Reset();
+};
@@ -168,7 +168,8 @@ RAS_Rasterizer::RAS_Rasterizer()
 {
   m_impl.reset(new RAS_OpenGLRasterizer(this));
 
-  m_numgllights = m_impl->GetNumLights();
+  // The GPU context is only available in Init, the rasterizer can be used without it.
+  m_numgllights = 0;
 }
 
 RAS_Rasterizer::~RAS_Rasterizer()
@@ -263,6 +264,8 @@ void RAS_Rasterizer::Init(RAS_ICanvas *canvas)
   // SetColorMask(true, true, true, true);
   GPU_color_mask(true, true, true, true);
 
+  m_numgllights = m_impl->GetNumLights();
+
   /* Here we set RAS_FrameBuffers width and height very early in ge launching process
    * Note that if we want to resize RAS_FrameBuffers, this method must be called
    * But other things would need to be resized too with eevee (GPUViewport and
@@ -270,6 +270,33 @@ void SG_Node::UpdateWorldDataThreadSchedule(double time, bool parentUpdated)
   }
 }
 
+void SG_Node::UpdateWorldDataTask(double time,
+                                  std::vector<SG_Node *> &updatedNodes,
+                                  bool parentUpdated)
+{
+  parentUpdated = UpdateNodeWorldDataTask(time, updatedNodes, parentUpdated);
+
+  for (SG_Node *childnode : m_children) {
+    childnode->UpdateWorldDataTask(time, updatedNodes, parentUpdated);
+  }
+}
+
+bool SG_Node::UpdateNodeWorldDataTask(double time,
+                                      std::vector<SG_Node *> &updatedNodes,
+                                      bool parentUpdated)
+{
+  if (UpdateSpatialData(GetSGParent(), time, parentUpdated)) {
+    updatedNodes.push_back(this);
+  }
+
+  // The update list is shared with the other tasks.
+  scheduleMutex.Lock();
+  Delink();
+  scheduleMutex.Unlock();
+
+  return parentUpdated;
+}
+
 void SG_Node::SetSimulatedTime(double time, bool recurse)
 {
   // update the controllers of this node.
@@ -188,6 +188,22 @@ class SG_Node : public SG_QList {
    */
   void UpdateWorldData(double time, bool parentUpdated = false);
   void UpdateWorldDataThread(double time, bool parentUpdated = false);
+  /**
+   * Update the world data of this node and its children from a task running
+   * concurrently with the update of other subtrees. The transform update callback
+   * is not called, the updated nodes are appended to updatedNodes in the order
+   * UpdateWorldData would call it, see ActivateUpdateTransformCallback.
+   */
+  void UpdateWorldDataTask(double time,
+                           std::vector<SG_Node *> &updatedNodes,
+                           bool parentUpdated = false);
+  /**
+   * Same as UpdateWorldDataTask for this node only, the children are not updated.
+   * \return The parentUpdated value to use for the children update.
+   */
+  bool UpdateNodeWorldDataTask(double time,
+                               std::vector<SG_Node *> &updatedNodes,
+                               bool parentUpdated = false);
 
   /**
    * Update the simulation time of this node. Iterate through
@@ -347,6 +363,8 @@ class SG_Node : public SG_QList {
   bool IsModified();
   bool IsDirty(DirtyFlag flag);
 
+  void ActivateUpdateTransformCallback();
+
  protected:
   friend class SG_Controller;
   friend class KX_BoneParentRelation;
@@ -356,7 +374,6 @@ class SG_Node : public SG_QList {
 
   bool ActivateReplicationCallback(SG_Node *replica);
   void ActivateDestructionCallback();
-  void ActivateUpdateTransformCallback();
   bool ActivateScheduleUpdateCallback();
   void ActivateRecheduleUpdateCallback();
 
@@ -96,6 +96,14 @@ class SG_ParentRelation {
     return false;
   }
 
+  /**
+   * Bone Parent Relation are special: they update the armature pose on demand
+   */
+  virtual bool IsBoneRelation()
+  {
+    return false;
+  }
+
  protected:
   /**
    * Protected constructors
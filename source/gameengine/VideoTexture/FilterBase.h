@@ -77,6 +77,17 @@ class FilterBase {
     return filter(src, x, y, size, pixSize, convertPrevious(src, x, y, size, pixSize));
   }
 
+  /// convert row of pixels with the whole filter chain, false if a filter has no row function
+  template<class SRC>
+  bool convertRow(SRC src, unsigned int *dst, unsigned int width)
+  {
+    // first filter converts source pixels
+    if (m_previous == nullptr)
+      return filterSourceRow(src, dst, width);
+    // otherwise filter pixels converted by previous filters
+    return m_previous->m_filter->convertRow(src, dst, width) && filterRow(dst, width);
+  }
+
   /// get previous filter
   PyFilter *getPrevious(void)
   {
@@ -121,6 +132,38 @@ class FilterBase {
     return val;
   }
 
+  /// convert row of source pixels, source byte buffer, false if not supported
+  virtual bool filterSourceRow(unsigned char *src, unsigned int *dst, unsigned int width)
+  {
+    return false;
+  }
+  /// convert row of source pixels, source int buffer, false if not supported
+  virtual bool filterSourceRow(unsigned int *src, unsigned int *dst, unsigned int width)
+  {
+    return false;
+  }
+  /// convert row of source pixels, source float buffer, false if not supported
+  virtual bool filterSourceRow(float *src, unsigned int *dst, unsigned int width)
+  {
+    return false;
+  }
+  /// filter row of converted pixels in place, false if not supported
+  /// (filters using pixel position or neighbours have to be run per pixel)
+  bool filterRow(unsigned int *row, unsigned int width)
+  {
+    if (!isValueFilter())
+      return false;
+    for (unsigned int x = 0; x < width; ++x)
+      row[x] = filter(row + x, 0, 0, nullptr, 0, row[x]);
+    return true;
+  }
+
+  /// filter only uses pixel values, not their position or neighbours
+  virtual bool isValueFilter(void)
+  {
+    return false;
+  }
+
   /// get source pixel size
   virtual unsigned int getPixelSize(void)
   {
@@ -111,4 +111,9 @@ class FilterBlueScreen : public FilterBase {
   {
     return tFilter(src, x, y, size, pixSize, val);
   }
+  /// filter only uses pixel values, rows can be filtered in place
+  virtual bool isValueFilter(void)
+  {
+    return true;
+  }
 };
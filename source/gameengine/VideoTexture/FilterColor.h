@@ -76,6 +76,11 @@ class FilterGray : public FilterBase {
   {
     return tFilter(src, x, y, size, pixSize, val);
   }
+  /// filter only uses pixel values, rows can be filtered in place
+  virtual bool isValueFilter(void)
+  {
+    return true;
+  }
 };
 
 /// type for color matrix
@@ -140,6 +145,11 @@ class FilterColor : public FilterBase {
   {
     return tFilter(src, x, y, size, pixSize, val);
   }
+  /// filter only uses pixel values, rows can be filtered in place
+  virtual bool isValueFilter(void)
+  {
+    return true;
+  }
 };
 
 /// type for color levels
@@ -207,4 +217,9 @@ class FilterLevel : public FilterBase {
   {
     return tFilter(src, x, y, size, pixSize, val);
   }
+  /// filter only uses pixel values, rows can be filtered in place
+  virtual bool isValueFilter(void)
+  {
+    return true;
+  }
 };
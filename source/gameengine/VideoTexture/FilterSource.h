@@ -59,6 +59,13 @@ class FilterRGB24 : public FilterBase {
     VT_RGBA(val, src[0], src[1], src[2], 0xFF);
     return val;
   }
+  /// convert row of source pixels, source byte buffer
+  virtual bool filterSourceRow(unsigned char *src, unsigned int *dst, unsigned int width)
+  {
+    for (unsigned int x = 0; x < width; ++x, src += 3)
+      VT_RGBA(dst[x], src[0], src[1], src[2], 0xFF);
+    return true;
+  }
 };
 
 /// class for RGBA32 conversion
@@ -91,6 +98,12 @@ class FilterRGBA32 : public FilterBase {
       return val;
     }
   }
+  /// convert row of source pixels, source byte buffer
+  virtual bool filterSourceRow(unsigned char *src, unsigned int *dst, unsigned int width)
+  {
+    memcpy(dst, src, width * sizeof(unsigned int));
+    return true;
+  }
 };
 
 /// class for BGRA32 conversion
@@ -119,6 +132,13 @@ class FilterBGRA32 : public FilterBase {
     VT_RGBA(val, src[2], src[1], src[0], src[3]);
     return val;
   }
+  /// convert row of source pixels, source byte buffer
+  virtual bool filterSourceRow(unsigned char *src, unsigned int *dst, unsigned int width)
+  {
+    for (unsigned int x = 0; x < width; ++x, src += 4)
+      VT_RGBA(dst[x], src[2], src[1], src[0], src[3]);
+    return true;
+  }
 };
 
 /// class for BGR24 conversion
@@ -147,6 +167,13 @@ class FilterBGR24 : public FilterBase {
     VT_RGBA(val, src[2], src[1], src[0], 0xFF);
     return val;
   }
+  /// convert row of source pixels, source byte buffer
+  virtual bool filterSourceRow(unsigned char *src, unsigned int *dst, unsigned int width)
+  {
+    for (unsigned int x = 0; x < width; ++x, src += 3)
+      VT_RGBA(dst[x], src[2], src[1], src[0], 0xFF);
+    return true;
+  }
 };
 
 /// class for Z_buffer conversion
@@ -183,6 +210,15 @@ class FilterZZZA : public FilterBase {
 
     return val;
   }
+  /// convert row of source pixels, source float buffer
+  virtual bool filterSourceRow(float *src, unsigned int *dst, unsigned int width)
+  {
+    for (unsigned int x = 0; x < width; ++x) {
+      unsigned int depth = int(src[x] * 255);
+      VT_RGBA(dst[x], depth, depth, depth, 0xFF);
+    }
+    return true;
+  }
 };
 
 /// class for Z_buffer conversion
@@ -214,6 +250,12 @@ class FilterDEPTH : public FilterBase {
     memcpy(&val, src, sizeof(unsigned int));
     return val;
   }
+  /// convert row of source pixels, source float buffer
+  virtual bool filterSourceRow(float *src, unsigned int *dst, unsigned int width)
+  {
+    memcpy(dst, src, width * sizeof(unsigned int));
+    return true;
+  }
 };
 
 /// class for YV12 conversion
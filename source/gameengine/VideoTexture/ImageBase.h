@@ -32,6 +32,9 @@
 
 #include <vector>
 
+#include "BLI_task.h"
+#include "BLI_utildefines.h"
+
 #include "Common.h"
 #include "EXP_PyObjectPlus.h"
 #include "FilterBase.h"
@@ -203,6 +206,59 @@ class ImageBase {
   /// perform loop detection
   bool loopDetect(ImageBase *img);
 
+  /// data of parallel row conversion
+  template<class FLT, class SRC> struct ConvRowsData {
+    FLT *filter;
+    SRC srcBuff;
+    unsigned int *dstBuff;
+    unsigned int width;
+    unsigned int height;
+    unsigned int pixSize;
+    bool flip;
+  };
+
+  /// convert one row of image
+  template<class FLT, class SRC>
+  static void convImageRow(void *__restrict userdata,
+                           const int y,
+                           const TaskParallelTLS *__restrict UNUSED(tls))
+  {
+    ConvRowsData<FLT, SRC> *data = static_cast<ConvRowsData<FLT, SRC> *>(userdata);
+    // source row, last source row is the first one if flipping is required
+    unsigned int srcRow = data->flip ? data->height - 1 - y : y;
+    data->filter->convertRow(data->srcBuff + srcRow * data->width * data->pixSize,
+                             data->dstBuff + y * data->width,
+                             data->width);
+  }
+
+  /// template for image conversion by rows, returns false if filter chain has to be run per pixel
+  template<class FLT, class SRC> bool convImageRows(FLT &filter, SRC srcBuff, short *srcSize)
+  {
+    ConvRowsData<FLT, SRC> data;
+    data.filter = &filter;
+    data.srcBuff = srcBuff;
+    data.dstBuff = m_image;
+    data.width = m_size[0];
+    data.height = m_size[1];
+    data.pixSize = filter.firstPixelSize();
+    data.flip = m_flip;
+
+    if (data.height == 0)
+      return true;
+    // convert first row, if it fails a filter of chain has no row function
+    if (!filter.convertRow(srcBuff + (m_flip ? (data.height - 1) * data.width * data.pixSize : 0),
+                           m_image,
+                           data.width))
+      return false;
+
+    // convert other rows in parallel, filters of rows don't depend on other pixels
+    TaskParallelSettings settings;
+    BLI_parallel_range_settings_defaults(&settings);
+    settings.min_iter_per_thread = 16;
+    BLI_task_parallel_range(1, data.height, &data, convImageRow<FLT, SRC>, &settings);
+    return true;
+  }
+
   /// template for image conversion
   template<class FLT, class SRC> void convImage(FLT &filter, SRC srcBuff, short *srcSize)
   {
@@ -210,6 +266,10 @@ class ImageBase {
     unsigned int *dstBuff = m_image;
     // pixel size from filter
     unsigned int pixSize = filter.firstPixelSize();
+    // if no scaling is needed and whole filter chain can convert rows, use fused row conversion
+    if (srcSize[0] == m_size[0] && srcSize[1] == m_size[1] &&
+        convImageRows(filter, srcBuff, srcSize))
+      return;
     // if no scaling is needed
     if (srcSize[0] == m_size[0] && srcSize[1] == m_size[1])
       // if flipping isn't required
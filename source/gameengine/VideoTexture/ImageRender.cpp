@@ -626,6 +626,11 @@ static PyGetSetDef imageRenderGetSets[] = {
      (setter)ImageViewport_setAlpha,
      (char *)"use alpha in texture",
      nullptr},
+    {(char *)"asyncRead",
+     (getter)ImageViewport_getAsyncRead,
+     (setter)ImageViewport_setAsyncRead,
+     (char *)"number of pixel buffers for asynchronous read, 0 for synchronous read",
+     nullptr},
     {(char *)"whole",
      (getter)ImageViewport_getWhole,
      (setter)ImageViewport_setWhole,
@@ -845,6 +850,11 @@ static PyGetSetDef imageMirrorGetSets[] = {
      (setter)ImageViewport_setAlpha,
      (char *)"use alpha in texture",
      nullptr},
+    {(char *)"asyncRead",
+     (getter)ImageViewport_getAsyncRead,
+     (setter)ImageViewport_setAsyncRead,
+     (char *)"number of pixel buffers for asynchronous read, 0 for synchronous read",
+     nullptr},
     {(char *)"whole",
      (getter)ImageViewport_getWhole,
      (setter)ImageViewport_setWhole,
@@ -36,9 +36,11 @@
 #include "KX_Globals.h"
 #include "KX_KetsjiEngine.h"
 #include "RAS_ICanvas.h"
+#include "RAS_OpenGLPixelReadback.h"
 #include "Texture.h"
 
-ImageViewport::ImageViewport() : m_alpha(false), m_texInit(false)
+ImageViewport::ImageViewport()
+    : m_alpha(false), m_readback(nullptr), m_readFormat(0), m_readType(0), m_texInit(false)
 {
   /* Because this constructor is called from python direclty without any arguments
    * the viewport should be the one of the final screen with gaps.
@@ -67,7 +69,13 @@ ImageViewport::ImageViewport() : m_alpha(false), m_texInit(false)
 
 // constructor
 ImageViewport::ImageViewport(unsigned int width, unsigned int height)
-    : m_width(width), m_height(height), m_alpha(false), m_texInit(false)
+    : m_width(width),
+      m_height(height),
+      m_alpha(false),
+      m_readback(nullptr),
+      m_readFormat(0),
+      m_readType(0),
+      m_texInit(false)
 {
   m_viewport[0] = 0;
   m_viewport[1] = 0;
@@ -87,6 +95,54 @@ ImageViewport::ImageViewport(unsigned int width, unsigned int height)
 ImageViewport::~ImageViewport(void)
 {
   delete[] m_viewportImage;
+  delete m_readback;
+}
+
+short ImageViewport::getAsyncRead(void)
+{
+  return m_readback ? m_readback->GetNumBuffers() : 0;
+}
+
+void ImageViewport::setAsyncRead(short buffers)
+{
+  if (buffers == getAsyncRead())
+    return;
+  delete m_readback;
+  m_readback = (buffers > 0) ? new RAS_OpenGLPixelReadback(buffers) : nullptr;
+}
+
+// read pixels of capture area
+void ImageViewport::readPixels(unsigned int format,
+                               unsigned int type,
+                               unsigned int pixelSize,
+                               void *buffer)
+{
+  if (m_readback) {
+    const GLint area[4] = {m_upLeft[0], m_upLeft[1], m_capSize[0], m_capSize[1]};
+    // pending reads don't match current capture, drop them
+    if (format != m_readFormat || type != m_readType || memcmp(area, m_readArea, sizeof(area))) {
+      m_readback->Reset();
+      m_readFormat = format;
+      m_readType = type;
+      memcpy(m_readArea, area, sizeof(area));
+    }
+    // get pixels read in previous frame (or older with more buffers) before reusing its buffer
+    bool fetched = false;
+    if (m_readback->GetNumPending() == m_readback->GetNumBuffers() - 1)
+      fetched = m_readback->Fetch(buffer, true);
+    // queue read of current frame without waiting for GPU
+    m_readback->Queue(area[0], area[1], area[2], area[3], format, type, pixelSize);
+    if (fetched)
+      return;
+  }
+  // synchronous read, also used for first frames of asynchronous read
+  glReadPixels(m_upLeft[0],
+               m_upLeft[1],
+               (GLsizei)m_capSize[0],
+               (GLsizei)m_capSize[1],
+               format,
+               type,
+               buffer);
 }
 
 // use whole viewport to capture image
@@ -181,13 +237,7 @@ void ImageViewport::calcViewport(unsigned int texId, double ts, unsigned int for
       // *** misusing m_viewportImage here, but since it has the correct size
       //     (4 bytes per pixel = size of float) and we just need it to apply
       //     the filter, it's ok
-      glReadPixels(m_upLeft[0],
-                   m_upLeft[1],
-                   (GLsizei)m_capSize[0],
-                   (GLsizei)m_capSize[1],
-                   GL_DEPTH_COMPONENT,
-                   GL_FLOAT,
-                   m_viewportImage);
+      readPixels(GL_DEPTH_COMPONENT, GL_FLOAT, sizeof(float), m_viewportImage);
       // filter loaded data
       FilterZZZA filt;
       filterImage(filt, (float *)m_viewportImage, m_capSize);
@@ -197,13 +247,7 @@ void ImageViewport::calcViewport(unsigned int texId, double ts, unsigned int for
       if (m_depth) {
         // Use read pixels with the depth buffer
         // See warning above about m_viewportImage.
-        glReadPixels(m_upLeft[0],
-                     m_upLeft[1],
-                     (GLsizei)m_capSize[0],
-                     (GLsizei)m_capSize[1],
-                     GL_DEPTH_COMPONENT,
-                     GL_FLOAT,
-                     m_viewportImage);
+        readPixels(GL_DEPTH_COMPONENT, GL_FLOAT, sizeof(float), m_viewportImage);
         // filter loaded data
         FilterDEPTH filt;
         filterImage(filt, (float *)m_viewportImage, m_capSize);
@@ -215,34 +259,16 @@ void ImageViewport::calcViewport(unsigned int texId, double ts, unsigned int for
           // as we are reading the pixel in the native format, we can read directly in the image
           // buffer if we are sure that no processing is needed on the image
           if (m_size[0] == m_capSize[0] && m_size[1] == m_capSize[1] && !m_flip && !m_pyfilter) {
-            glReadPixels(m_upLeft[0],
-                         m_upLeft[1],
-                         (GLsizei)m_capSize[0],
-                         (GLsizei)m_capSize[1],
-                         format,
-                         GL_UNSIGNED_BYTE,
-                         m_image);
+            readPixels(format, GL_UNSIGNED_BYTE, 4, m_image);
             m_avail = true;
           }
           else if (!m_pyfilter) {
-            glReadPixels(m_upLeft[0],
-                         m_upLeft[1],
-                         (GLsizei)m_capSize[0],
-                         (GLsizei)m_capSize[1],
-                         format,
-                         GL_UNSIGNED_BYTE,
-                         m_viewportImage);
+            readPixels(format, GL_UNSIGNED_BYTE, 4, m_viewportImage);
             FilterRGBA32 filt;
             filterImage(filt, m_viewportImage, m_capSize);
           }
           else {
-            glReadPixels(m_upLeft[0],
-                         m_upLeft[1],
-                         (GLsizei)m_capSize[0],
-                         (GLsizei)m_capSize[1],
-                         GL_RGBA,
-                         GL_UNSIGNED_BYTE,
-                         m_viewportImage);
+            readPixels(GL_RGBA, GL_UNSIGNED_BYTE, 4, m_viewportImage);
             FilterRGBA32 filt;
             filterImage(filt, m_viewportImage, m_capSize);
             if (format == GL_BGRA) {
@@ -252,13 +278,7 @@ void ImageViewport::calcViewport(unsigned int texId, double ts, unsigned int for
           }
         }
         else {
-          glReadPixels(m_upLeft[0],
-                       m_upLeft[1],
-                       (GLsizei)m_capSize[0],
-                       (GLsizei)m_capSize[1],
-                       GL_RGB,
-                       GL_UNSIGNED_BYTE,
-                       m_viewportImage);
+          readPixels(GL_RGB, GL_UNSIGNED_BYTE, 3, m_viewportImage);
           // filter loaded data
           FilterRGB24 filt;
           filterImage(filt, m_viewportImage, m_capSize);
@@ -368,6 +388,32 @@ int ImageViewport_setAlpha(PyImage *self, PyObject *value, void *closure)
   return 0;
 }
 
+// get number of pixel buffers for asynchronous read
+PyObject *ImageViewport_getAsyncRead(PyImage *self, void *closure)
+{
+  return PyLong_FromLong(getImageViewport(self)->getAsyncRead());
+}
+
+// set number of pixel buffers for asynchronous read
+int ImageViewport_setAsyncRead(PyImage *self, PyObject *value, void *closure)
+{
+  // check parameter, report failure
+  if (value == nullptr || !PyLong_Check(value)) {
+    PyErr_SetString(PyExc_TypeError, "The value must be an integer");
+    return -1;
+  }
+  long buffers = PyLong_AsLong(value);
+  if (buffers != 0 && (buffers < 2 || buffers > 4)) {
+    PyErr_SetString(PyExc_ValueError, "The value must be 0 (synchronous read) or between 2 and 4");
+    return -1;
+  }
+  // set number of buffers
+  if (self->m_image != nullptr)
+    getImageViewport(self)->setAsyncRead(buffers);
+  // success
+  return 0;
+}
+
 // get position
 static PyObject *ImageViewport_getPosition(PyImage *self, void *closure)
 {
@@ -460,6 +506,11 @@ static PyGetSetDef imageViewportGetSets[] = {
      (setter)ImageViewport_setAlpha,
      (char *)"use alpha in texture",
      nullptr},
+    {(char *)"asyncRead",
+     (getter)ImageViewport_getAsyncRead,
+     (setter)ImageViewport_setAsyncRead,
+     (char *)"number of pixel buffers for asynchronous read, 0 for synchronous read",
+     nullptr},
     // attributes from ImageBase class
     {(char *)"valid",
      (getter)Image_valid,
@@ -35,6 +35,8 @@
 #include "Common.h"
 #include "ImageBase.h"
 
+class RAS_OpenGLPixelReadback;
+
 /// class for viewport access
 class ImageViewport : public ImageBase {
  public:
@@ -65,6 +67,11 @@ class ImageViewport : public ImageBase {
     m_alpha = alpha;
   }
 
+  /// get number of pixel buffers used for asynchronous read, 0 for synchronous read
+  short getAsyncRead(void);
+  /// set number of pixel buffers used for asynchronous read
+  void setAsyncRead(short buffers);
+
   /// get capture size in viewport
   short *getCaptureSize(void)
   {
@@ -104,6 +111,12 @@ class ImageViewport : public ImageBase {
 
   /// buffer to copy viewport
   BYTE *m_viewportImage;
+  /// asynchronous read of viewport, nullptr for synchronous read
+  RAS_OpenGLPixelReadback *m_readback;
+  /// format, type and area of pending asynchronous reads
+  unsigned int m_readFormat;
+  unsigned int m_readType;
+  GLint m_readArea[4];
   /// texture is initialized
   bool m_texInit;
 
@@ -116,6 +129,9 @@ class ImageViewport : public ImageBase {
   /// capture image from viewport
   virtual void calcViewport(unsigned int texId, double ts, unsigned int format);
 
+  /// read pixels of capture area, from a previous frame if asynchronous read is used
+  void readPixels(unsigned int format, unsigned int type, unsigned int pixelSize, void *buffer);
+
   /// get viewport size
   GLint *getViewportSize(void)
   {
@@ -129,3 +145,5 @@ PyObject *ImageViewport_getWhole(PyImage *self, void *closure);
 int ImageViewport_setWhole(PyImage *self, PyObject *value, void *closure);
 PyObject *ImageViewport_getAlpha(PyImage *self, void *closure);
 int ImageViewport_setAlpha(PyImage *self, PyObject *value, void *closure);
+PyObject *ImageViewport_getAsyncRead(PyImage *self, void *closure);
+int ImageViewport_setAsyncRead(PyImage *self, PyObject *value, void *closure);
@@ -0,0 +1,77 @@
+# Apache License, Version 2.0
+
+import json
+import os
+import pathlib
+
+
+# Helpers of the game engine tests, the scenes are built in Blender then run for a fixed
+# number of frames in the headless player which writes the time of every frame per category.
+
+
+def player_executable(env) -> pathlib.Path:
+    executable = pathlib.Path(env.blender_executable)
+    suffix = '.exe' if executable.suffix == '.exe' else ''
+    return executable.parent / ('blenderplayer' + suffix)
+
+
+def new_scene():
+    # Empty scene where the physics objects never sleep.
+    import bpy
+
+    bpy.ops.wm.read_factory_settings(use_empty=True)
+    scene = bpy.context.scene
+    scene.game_settings.deactivation_time = 0.0
+    return scene
+
+
+def save_scene(filepath: str, camera_location) -> None:
+    import bpy
+
+    bpy.ops.object.camera_add(location=camera_location)
+    bpy.context.scene.camera = bpy.context.object
+
+    bpy.ops.wm.save_as_mainfile(filepath=filepath)
+
+
+def build_rigid_body_stacks(side: int, height: int) -> None:
+    # Grid of stacked rigid body cubes falling on a static ground.
+    import bpy
+
+    bpy.ops.mesh.primitive_plane_add(size=1000.0)
+    bpy.context.object.game.physics_type = 'STATIC'
+
+    for x in range(side):
+        for y in range(side):
+            for z in range(height):
+                bpy.ops.mesh.primitive_cube_add(size=1.0, location=(x * 1.1, y * 1.1, z * 1.05 + 0.5))
+                bpy.context.object.game.physics_type = 'RIGID_BODY'
+
+
+def run_player(env, name: str, build_func, args: dict, category: str,
+               warmup_frames: int = 60, measure_frames: int = 600) -> float:
+    # Build the scene in Blender with build_func(args), args['filepath'] being the file to
+    # save, run it in the headless player with a fixed timestep and return the average time
+    # in seconds per frame of a profiler category, after the warm up frames.
+    tmpdir = env.base_dir / 'tmp'
+    os.makedirs(tmpdir, exist_ok=True)
+    filepath = tmpdir / ('game_' + name + '.blend')
+    output = tmpdir / ('game_' + name + '_timings.json')
+
+    env.run_in_blender(build_func, dict(args, filepath=str(filepath)))
+
+    env.call([str(player_executable(env)), '-b',
+              '-g', 'fixed_timestep', '=', '1',
+              '-g', 'frame_limit', '=', str(warmup_frames + measure_frames),
+              '-g', 'frame_timings', '=', str(output),
+              str(filepath)], env.base_dir)
+
+    with open(output) as f:
+        timings = json.load(f)
+
+    # Times are in milliseconds per frame.
+    column = timings['categories'].index(category)
+    frames = timings['frames'][warmup_frames:]
+    time = sum(frame[column] for frame in frames) / max(len(frames), 1)
+
+    return time / 1000.0
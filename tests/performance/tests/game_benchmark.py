@@ -0,0 +1,125 @@
+# Apache License, Version 2.0
+
+import api
+from api import game
+
+
+# Logic run every frame by each object of the logic scene.
+_LOGIC_SCRIPT = '''
+import bge
+import mathutils
+
+own = bge.logic.getCurrentController().owner
+vec = mathutils.Vector((own["value"], 1.0, 0.0))
+vec.rotate(mathutils.Euler((0.0, 0.0, 0.1)))
+own["value"] = vec.x
+'''
+
+
+def _add_logic(obj, actuator_type=None):
+    import bpy
+
+    bpy.ops.logic.sensor_add(type='ALWAYS', object=obj.name)
+    sensor = obj.game.sensors[-1]
+    sensor.use_pulse_true_level = True
+
+    if actuator_type is None:
+        bpy.ops.logic.controller_add(type='PYTHON', object=obj.name)
+        controller = obj.game.controllers[-1]
+        controller.text = bpy.data.texts["logic.py"]
+        sensor.link(controller)
+        return None
+
+    bpy.ops.logic.controller_add(type='LOGIC_AND', object=obj.name)
+    controller = obj.game.controllers[-1]
+    bpy.ops.logic.actuator_add(type=actuator_type, object=obj.name)
+    actuator = obj.game.actuators[-1]
+    sensor.link(controller)
+    controller.link(actuator=actuator)
+    return actuator
+
+
+def _build_logic_scene(side):
+    # Python controllers on a grid of objects.
+    import bpy
+
+    text = bpy.data.texts.new("logic.py")
+    text.write(_LOGIC_SCRIPT)
+
+    for x in range(side):
+        for y in range(side):
+            bpy.ops.object.empty_add(location=(x, y, 0.0))
+            obj = bpy.context.object
+            bpy.ops.object.game_property_new(type='FLOAT', name="value")
+            _add_logic(obj)
+
+
+def _build_physics_scene(side):
+    # Stacks of rigid bodies falling on a static ground.
+    game.build_rigid_body_stacks(side, 8)
+
+
+def _build_scenegraph_scene(side):
+    # Rotating roots of deep parent hierarchies, every child transform is updated each frame.
+    import bpy
+
+    for x in range(side):
+        bpy.ops.object.empty_add(location=(x * 2.0, 0.0, 0.0))
+        parent = bpy.context.object
+        actuator = _add_logic(parent, 'MOTION')
+        actuator.offset_rotation = (0.0, 0.0, 0.01)
+
+        for y in range(side):
+            bpy.ops.object.empty_add(location=(x * 2.0, y + 1.0, 0.0))
+            child = bpy.context.object
+            child.parent = parent
+            parent = child
+
+
+_SCENES = {
+    'logic': (_build_logic_scene, "Logic"),
+    'physics': (_build_physics_scene, "Physics"),
+    'scenegraph': (_build_scenegraph_scene, "Scenegraph"),
+}
+
+
+def _build_scene(args):
+    game.new_scene()
+
+    build_func, _ = _SCENES[args['scene']]
+    build_func(args['side'])
+
+    game.save_scene(args['filepath'], (0.0, -50.0, 20.0))
+
+    return {}
+
+
+class GameBenchmarkTest(api.Test):
+    """
+    Run a reference scene in the headless player with a fixed timestep for a fixed number
+    of frames and measure the average time per frame of the engine category it stresses.
+    """
+
+    def __init__(self, scene, side):
+        self.scene = scene
+        self.side = side
+
+    def name(self):
+        return f"{self.scene}_{self.side}"
+
+    def category(self):
+        return "game_engine"
+
+    def run(self, env, device_id):
+        args = {'scene': self.scene,
+                'side': self.side}
+        _, category = _SCENES[self.scene]
+        time = game.run_player(env, self.name(), _build_scene, args, category)
+
+        return {'time': time}
+
+
+def generate(env):
+    return [GameBenchmarkTest('logic', 32),
+            GameBenchmarkTest('physics', 16),
+            GameBenchmarkTest('scenegraph', 64)]
@@ -0,0 +1,58 @@
+# Apache License, Version 2.0
+
+import api
+import os
+from api import game
+
+
+def _build_scene(args):
+    scene = game.new_scene()
+
+    gs = scene.game_settings
+    gs.use_physics_multithread = args['threads'] > 0
+    gs.physics_threads = max(args['threads'], 0)
+
+    side = args['side']
+    game.build_rigid_body_stacks(side, args['height'])
+    game.save_scene(args['filepath'], (side * 0.55, -side * 1.5, side))
+
+    return {}
+
+
+class GamePhysicsTest(api.Test):
+    """
+    Measure the average physics time per frame of a scene with many rigid bodies,
+    for the single threaded world and the multithreaded world at various thread counts.
+    """
+
+    def __init__(self, threads, side=16, height=16):
+        self.threads = threads
+        self.side = side
+        self.height = height
+
+    def name(self):
+        num_bodies = self.side * self.side * self.height
+        if self.threads == 0:
+            return f"rigid_bodies_{num_bodies}_single_thread"
+        return f"rigid_bodies_{num_bodies}_threads_{self.threads}"
+
+    def category(self):
+        return "game_physics"
+
+    def run(self, env, device_id):
+        args = {'threads': self.threads,
+                'side': self.side,
+                'height': self.height}
+        time = game.run_player(env, self.name(), _build_scene, args, "Physics", measure_frames=300)
+
+        return {'time': time}
+
+
+def generate(env):
+    # Single threaded world as reference, then the multithreaded world at increasing thread counts,
+    # the speedup is read by comparing the times of the tests in the same category.
+    thread_counts = [1, 2, 4, 8, 16]
+    max_threads = os.cpu_count() or 1
+    tests = [GamePhysicsTest(0)]
+    tests += [GamePhysicsTest(threads) for threads in thread_counts if threads <= max_threads]
+    return tests
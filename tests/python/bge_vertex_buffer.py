@@ -0,0 +1,235 @@
+# Apache License, Version 2.0
+
+# ./blender.bin --background -noaudio --python tests/python/bge_vertex_buffer.py -- --verbose
+#
+# Build a scene using KX_VertexBuffer in a game script, run it in the headless player
+# next to the blender executable and check the results written by the game script.
+import json
+import os
+import pathlib
+import subprocess
+import tempfile
+import unittest
+
+import bpy
+
+
+# Game script, run once. Each check function writes "OK" or its traceback in the results file.
+GAME_SCRIPT = '''
+import array
+import json
+import traceback
+
+import bge
+
+own = bge.logic.getCurrentController().owner
+mesh = own.meshes[0]
+
+
+def vertex_positions():
+    return [list(mesh.getVertex(0, i).XYZ) for i in range(mesh.getVertexArrayLength(0))]
+
+
+def check_view():
+    buffer = mesh.getVertexBuffer(0, "position")
+    assert buffer.numVertices == mesh.getVertexArrayLength(0)
+
+    view = memoryview(buffer)
+    assert view.ndim == 2
+    assert view.shape == (buffer.numVertices, 3)
+    assert view.format == "f"
+    assert view.itemsize == 4
+    # The vertices are interleaved.
+    assert not view.c_contiguous
+    assert view.tolist() == vertex_positions()
+
+
+def check_contiguous_export():
+    buffer = mesh.getVertexBuffer(0, "position")
+    try:
+        array.array("f").frombytes(buffer)
+    except BufferError:
+        return
+    raise AssertionError("contiguous export of a strided buffer")
+
+
+def check_view_update():
+    buffer = mesh.getVertexBuffer(0, "position")
+    view = memoryview(buffer)
+    view[1, 2] = 5.0
+    buffer.update()
+    assert mesh.getVertex(0, 1).z == 5.0
+
+
+def check_write():
+    buffer = mesh.getVertexBuffer(0, "position")
+    data = array.array("f", [float(i) for i in range(buffer.numVertices * 3)])
+    buffer.write(data)
+    positions = vertex_positions()
+    for i, position in enumerate(positions):
+        assert position == [i * 3.0, i * 3.0 + 1.0, i * 3.0 + 2.0]
+
+
+def check_write_errors():
+    buffer = mesh.getVertexBuffer(0, "position")
+    try:
+        buffer.write(array.array("f", [0.0] * (buffer.numVertices * 3 - 1)))
+    except ValueError:
+        pass
+    else:
+        raise AssertionError("write of a buffer with missing items")
+
+    try:
+        buffer.write(array.array("d", [0.0] * (buffer.numVertices * 3)))
+    except TypeError:
+        pass
+    else:
+        raise AssertionError("write of a buffer of doubles")
+
+
+def check_color():
+    buffer = mesh.getVertexBuffer(0, "color")
+    view = memoryview(buffer)
+    assert view.shape == (buffer.numVertices, 4)
+    assert view.format == "B"
+
+    data = bytes(i % 256 for i in range(buffer.numVertices * 4))
+    buffer.write(data)
+    assert view.tolist() == [list(data[i * 4:i * 4 + 4]) for i in range(buffer.numVertices)]
+
+
+def check_invalid_stream():
+    for args in ((0, "weight"), (1, "position"), (0, "uv", 8)):
+        try:
+            mesh.getVertexBuffer(*args)
+        except ValueError:
+            continue
+        raise AssertionError("invalid vertex buffer %r" % (args,))
+
+
+def check_library_free():
+    # The views must stay valid once the mesh they export is freed.
+    library = own["library"]
+    bge.logic.LibLoad(library, "Scene")
+    libobj = bge.logic.getCurrentScene().objects["LibCube"]
+    view = memoryview(libobj.meshes[0].getVertexBuffer(0, "position"))
+    positions = view.tolist()
+    del libobj
+
+    assert bge.logic.LibFree(library)
+    assert view.tolist() == positions
+    view[0, 0] = 1.0
+    view.release()
+
+
+results = {}
+for name, func in list(globals().items()):
+    if name.startswith("check_"):
+        try:
+            func()
+            results[name] = "OK"
+        except Exception:
+            results[name] = traceback.format_exc()
+
+with open(own["output"], "w") as f:
+    json.dump(results, f)
+
+bge.logic.endGame()
+'''
+
+
+def player_executable():
+    executable = pathlib.Path(bpy.app.binary_path)
+    suffix = '.exe' if executable.suffix == '.exe' else ''
+    return executable.parent / ('blenderplayer' + suffix)
+
+
+def add_string_property(obj, name, value):
+    bpy.ops.object.game_property_new(type='STRING', name=name)
+    obj.game.properties[name].value = value
+
+
+def build_library(filepath):
+    bpy.ops.wm.read_factory_settings(use_empty=True)
+    bpy.ops.mesh.primitive_cube_add(location=(0.0, 0.0, 10.0))
+    bpy.context.object.name = "LibCube"
+    bpy.ops.wm.save_as_mainfile(filepath=filepath, check_existing=False)
+
+
+def build_scene(filepath, library, output):
+    bpy.ops.wm.read_factory_settings(use_empty=True)
+
+    bpy.ops.mesh.primitive_cube_add()
+    obj = bpy.context.object
+    obj.data.vertex_colors.new()
+    add_string_property(obj, "library", library)
+    add_string_property(obj, "output", output)
+
+    text = bpy.data.texts.new("vertex_buffer.py")
+    text.write(GAME_SCRIPT)
+
+    bpy.ops.logic.sensor_add(type='ALWAYS', object=obj.name)
+    sensor = obj.game.sensors[-1]
+    bpy.ops.logic.controller_add(type='PYTHON', object=obj.name)
+    controller = obj.game.controllers[-1]
+    controller.text = text
+    sensor.link(controller)
+
+    bpy.ops.object.camera_add(location=(0.0, -10.0, 0.0))
+    bpy.context.scene.camera = bpy.context.object
+
+    bpy.ops.wm.save_as_mainfile(filepath=filepath, check_existing=False)
+
+
+class TestVertexBuffer(unittest.TestCase):
+
+    @classmethod
+    def setUpClass(cls):
+        with tempfile.TemporaryDirectory() as tmpdir:
+            library = os.path.join(tmpdir, "library.blend")
+            filepath = os.path.join(tmpdir, "vertex_buffer.blend")
+            output = os.path.join(tmpdir, "results.json")
+
+            build_library(library)
+            build_scene(filepath, library, output)
+
+            subprocess.run([str(player_executable()), '-b',
+                            '-g', 'frame_limit', '=', '10',
+                            filepath], check=True)
+
+            with open(output) as f:
+                cls.results = json.load(f)
+
+    def check(self, name):
+        self.assertEqual(self.results.get(name), "OK", self.results.get(name))
+
+    def test_view(self):
+        self.check("check_view")
+
+    def test_contiguous_export(self):
+        self.check("check_contiguous_export")
+
+    def test_view_update(self):
+        self.check("check_view_update")
+
+    def test_write(self):
+        self.check("check_write")
+
+    def test_write_errors(self):
+        self.check("check_write_errors")
+
+    def test_color(self):
+        self.check("check_color")
+
+    def test_invalid_stream(self):
+        self.check("check_invalid_stream")
+
+    def test_library_free(self):
+        self.check("check_library_free")
+
+
+if __name__ == '__main__':
+    import sys
+
+    sys.argv = [__file__] + (sys.argv[sys.argv.index("--") + 1:] if "--" in sys.argv else [])
+    unittest.main()